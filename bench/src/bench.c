@@ -0,0 +1,239 @@
+#include "bench.h"
+
+#include <core/application.h>
+#include <core/event.h>
+#include <core/frame_stats.h>
+#include <core/logger.h>
+#include <core/vmemory.h>
+#include <core/vstring.h>
+#include <platform/filesystem.h>
+#include <platform/platform.h>
+
+// temporary
+#include <renderer/renderer_frontend.h>
+
+#include <math/vmath.h>
+
+#include <stdlib.h>
+#include <string.h>
+
+STATIC_ASSERT(BENCH_MEASURED_FRAMES <= FRAME_STATS_CAPACITY, "Measured frames must fit in the frame stats ring.");
+
+typedef struct bench_results {
+    frame_stats_summary summary;
+    f64 duration_seconds;
+    u64 allocation_count;
+    f64 allocations_per_frame;
+} bench_results;
+
+/**
+ * The view at a frame: an orbit around the scene, bobbing up and down twice per lap.
+ */
+static mat4 camera_path_view(u64 frame_index) {
+    f32 t = (f32)(frame_index % BENCH_CAMERA_LAP_FRAMES) / (f32)BENCH_CAMERA_LAP_FRAMES;
+    f32 angle = t * V_PI_2;
+    f32 radius = 30.0f;
+    vec3 position = (vec3){vsin(angle) * radius, vsin(angle * 2.0f) * 5.0f, vcos(angle) * radius};
+    mat4 view = mat4_mul(mat4_euler_y(angle), mat4_translation(position));
+    return mat4_inverse(view);
+}
+
+static void write_stat(file_handle* file, const char* name, const frame_stat_summary* stat, b8* result) {
+    char line[256];
+    string_format(line, "  \"%s_ms\": {\"mean\": %.4f, \"p50\": %.4f, \"p95\": %.4f, \"p99\": %.4f, \"max\": %.4f},",
+                  name, stat->mean, stat->p50, stat->p95, stat->p99, stat->max);
+    *result = *result && filesystem_write_line(file, line);
+}
+
+static b8 write_results(const char* path, const bench_results* results) {
+    file_handle file;
+    if (!filesystem_open(path, FILE_MODE_WRITE, false, &file)) {
+        ERROR("Bench: unable to open '%s' for writing.", path);
+        return false;
+    }
+
+    char line[256];
+    b8 result = filesystem_write_line(&file, "{");
+    string_format(line, "  \"warmup_frames\": %u,\n  \"measured_frames\": %u,\n  \"duration_seconds\": %.4f,\n  \"hitch_count\": %u,",
+                  BENCH_WARMUP_FRAMES, results->summary.sample_count, results->duration_seconds, results->summary.hitch_count);
+    result = result && filesystem_write_line(&file, line);
+    for (u32 s = 0; s < FRAME_STAT_COUNT; ++s) {
+        write_stat(&file, frame_stat_name(s), &results->summary.stats[s], &result);
+    }
+    string_format(line, "  \"allocations\": %llu,\n  \"allocations_per_frame\": %.4f,",
+                  results->allocation_count, results->allocations_per_frame);
+    result = result && filesystem_write_line(&file, line);
+
+    // Bytes allocated per tag at the end of the run.
+    result = result && filesystem_write_line(&file, "  \"memory\": {");
+    for (u32 tag = 0; tag < MEMORY_TAG_MAX_TAGS; ++tag) {
+        char name[64];
+        string_format(name, "%s", get_memory_tag_name(tag));
+        // The names are padded for aligned logs.
+        for (i32 i = (i32)string_length(name) - 1; i >= 0 && name[i] == ' '; --i) {
+            name[i] = 0;
+        }
+        string_format(line, "    \"%s\": %llu%s", name, get_memory_tag_usage(tag), tag + 1 < MEMORY_TAG_MAX_TAGS ? "," : "");
+        result = result && filesystem_write_line(&file, line);
+    }
+    result = result && filesystem_write_line(&file, "  }");
+    result = result && filesystem_write_line(&file, "}");
+    filesystem_close(&file);
+
+    if (!result) {
+        ERROR("Bench: failed writing '%s'.", path);
+    }
+    return result;
+}
+
+/**
+ * Finds a number in a results file, either at the top level (object 0) or in
+ * one of the per-stat objects. Only understands the layout write_results uses.
+ */
+static b8 find_number(const char* json, const char* object, const char* key, f64* out_value) {
+    char quoted[64];
+    const char* start = json;
+    if (object) {
+        string_format(quoted, "\"%s\"", object);
+        start = strstr(start, quoted);
+        if (!start) {
+            return false;
+        }
+    }
+    string_format(quoted, "\"%s\"", key);
+    const char* found = strstr(start, quoted);
+    if (!found) {
+        return false;
+    }
+    const char* colon = strchr(found, ':');
+    if (!colon) {
+        return false;
+    }
+    char* end = 0;
+    *out_value = strtod(colon + 1, &end);
+    return end != colon + 1;
+}
+
+/**
+ * Checks one metric against the baseline.
+ * @returns True if it regressed.
+ */
+static b8 check_metric(const char* baseline, const char* object, const char* key, f64 current, f64 slack) {
+    f64 expected;
+    if (!find_number(baseline, object, key, &expected)) {
+        WARN("Bench: baseline has no %s%s%s; not compared.", object ? object : "", object ? "." : "", key);
+        return false;
+    }
+    f64 limit = expected * (1.0 + BENCH_REGRESSION_THRESHOLD) + slack;
+    b8 regressed = current > limit;
+    if (regressed) {
+        ERROR("Bench: %s%s%s regressed: %.4f, baseline %.4f, limit %.4f.", object ? object : "", object ? "." : "", key, current, expected, limit);
+    } else {
+        INFO("Bench: %s%s%s %.4f, baseline %.4f.", object ? object : "", object ? "." : "", key, current, expected);
+    }
+    return regressed;
+}
+
+/**
+ * Compares the results against the baseline, if there is one.
+ * @returns The exit code.
+ */
+static i32 compare_to_baseline(const char* path, const bench_results* results) {
+    if (!filesystem_exists(path)) {
+        INFO("Bench: no baseline at '%s'; copy '%s' there to compare later runs against this one.", path, BENCH_RESULTS_PATH);
+        return 0;
+    }
+
+    file_handle file;
+    if (!filesystem_open(path, FILE_MODE_READ, false, &file)) {
+        ERROR("Bench: unable to open the baseline '%s'.", path);
+        return BENCH_EXIT_ERROR;
+    }
+    u8* bytes = 0;
+    u64 size = 0;
+    b8 read = filesystem_read_all_bytes(&file, &bytes, &size);
+    filesystem_close(&file);
+    if (!read) {
+        ERROR("Bench: unable to read the baseline '%s'.", path);
+        if (bytes) {
+            vfree(bytes, size, MEMORY_TAG_STRING);
+        }
+        return BENCH_EXIT_ERROR;
+    }
+
+    // Terminated, for the string searches.
+    char* baseline = vallocate(size + 1, MEMORY_TAG_STRING);
+    vcopy_memory(baseline, bytes, size);
+    vfree(bytes, size, MEMORY_TAG_STRING);
+
+    const frame_stats_summary* summary = &results->summary;
+    const char* frame = "frame_ms";
+    const char* cpu = "cpu_ms";
+    u32 regressions = 0;
+    regressions += check_metric(baseline, frame, "p50", summary->stats[FRAME_STAT_FRAME].p50, BENCH_REGRESSION_SLACK_MS);
+    regressions += check_metric(baseline, frame, "p95", summary->stats[FRAME_STAT_FRAME].p95, BENCH_REGRESSION_SLACK_MS);
+    regressions += check_metric(baseline, frame, "p99", summary->stats[FRAME_STAT_FRAME].p99, BENCH_REGRESSION_SLACK_MS);
+    regressions += check_metric(baseline, cpu, "p50", summary->stats[FRAME_STAT_CPU].p50, BENCH_REGRESSION_SLACK_MS);
+    regressions += check_metric(baseline, cpu, "p95", summary->stats[FRAME_STAT_CPU].p95, BENCH_REGRESSION_SLACK_MS);
+    regressions += check_metric(baseline, 0, "allocations_per_frame", results->allocations_per_frame, BENCH_ALLOCATION_SLACK_PER_FRAME);
+    vfree(baseline, size + 1, MEMORY_TAG_STRING);
+
+    if (regressions > 0) {
+        ERROR("Bench: %u metrics regressed more than %.0f%% against '%s'.", regressions, BENCH_REGRESSION_THRESHOLD * 100.0, path);
+        return BENCH_EXIT_REGRESSED;
+    }
+    INFO("Bench: within %.0f%% of the baseline.", BENCH_REGRESSION_THRESHOLD * 100.0);
+    return 0;
+}
+
+static void finish(bench_state* state) {
+    bench_results results;
+    frame_stats_summarize(application_get_frame_stats(), &results.summary);
+    results.duration_seconds = platform_get_absolute_time() - state->measure_start_time;
+    results.allocation_count = get_memory_alloc_count() - state->measure_start_alloc_count;
+    results.allocations_per_frame = (f64)results.allocation_count / (f64)BENCH_MEASURED_FRAMES;
+
+    frame_stats_log(application_get_frame_stats());
+    INFO("Bench: %llu allocations (%.2f per frame) over %.2fs.", results.allocation_count, results.allocations_per_frame, results.duration_seconds);
+
+    i32 exit_code = BENCH_EXIT_ERROR;
+    if (write_results(BENCH_RESULTS_PATH, &results)) {
+        INFO("Bench: results written to '%s'.", BENCH_RESULTS_PATH);
+        exit_code = compare_to_baseline(BENCH_BASELINE_PATH, &results);
+    }
+    application_set_exit_code(exit_code);
+
+    event_context data = {};
+    event_fire(EVENT_CODE_APPLICATION_QUIT, 0, data);
+}
+
+b8 bench_initialize(game* game_inst) {
+    bench_state* state = (bench_state*)game_inst->state;
+    state->frame_index = 0;
+    INFO("Bench: %u warmup frames, then %u measured frames.", BENCH_WARMUP_FRAMES, BENCH_MEASURED_FRAMES);
+    return true;
+}
+
+b8 bench_update(game* game_inst, f32 delta_time) {
+    return true;
+}
+
+b8 bench_render(game* game_inst, f32 delta_time, f32 alpha) {
+    bench_state* state = (bench_state*)game_inst->state;
+
+    if (state->frame_index == BENCH_WARMUP_FRAMES) {
+        // The frame stats record this frame once it has been submitted.
+        application_reset_frame_stats();
+        state->measure_start_alloc_count = get_memory_alloc_count();
+        state->measure_start_time = platform_get_absolute_time();
+    } else if (state->frame_index == BENCH_WARMUP_FRAMES + BENCH_MEASURED_FRAMES) {
+        finish(state);
+    }
+
+    renderer_set_view(camera_path_view(state->frame_index));
+    state->frame_index++;
+    return true;
+}
+
+void bench_on_resize(game* game_inst, u32 width, u32 height) {
+}
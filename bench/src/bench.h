@@ -0,0 +1,48 @@
+#pragma once
+
+#include <defines.h>
+#include <gametypes.h>
+
+/*
+ * Runs a fixed workload for a fixed number of frames and writes machine-readable
+ * results, for catching performance regressions automatically. The camera
+ * follows a path driven by the frame index rather than by time, so every run
+ * draws the same frames.
+ */
+
+// Frames run before measuring, while caches, drivers and clocks settle.
+#define BENCH_WARMUP_FRAMES 120
+// Frames measured; all of them fit in the frame stats ring.
+#define BENCH_MEASURED_FRAMES 1000
+// Frames per lap of the camera path.
+#define BENCH_CAMERA_LAP_FRAMES 240
+
+#define BENCH_RESULTS_PATH "bench_results.json"
+// Results of an earlier run to compare against. Copy a results file here to set it.
+#define BENCH_BASELINE_PATH "bench_baseline.json"
+// Slowdown over the baseline, as a fraction, beyond which the run fails.
+#define BENCH_REGRESSION_THRESHOLD 0.10
+// Allowed on top of the threshold for times, so sub-millisecond noise doesn't fail a run.
+#define BENCH_REGRESSION_SLACK_MS 0.05
+// Allowed on top of the threshold for allocations per frame. With a render thread, its frames
+// aren't aligned with the measured window, so a frame's worth of its allocations may fall either side.
+#define BENCH_ALLOCATION_SLACK_PER_FRAME 0.01
+
+// Exit code of a run slower than the baseline.
+#define BENCH_EXIT_REGRESSED 3
+// Exit code of a run whose results couldn't be written or whose baseline couldn't be read.
+#define BENCH_EXIT_ERROR 4
+
+typedef struct bench_state {
+    u64 frame_index;
+    u64 measure_start_alloc_count;
+    f64 measure_start_time;
+} bench_state;
+
+b8 bench_initialize(game* game_inst);
+
+b8 bench_update(game* game_inst, f32 delta_time);
+
+b8 bench_render(game* game_inst, f32 delta_time, f32 alpha);
+
+void bench_on_resize(game* game_inst, u32 width, u32 height);
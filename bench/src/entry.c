@@ -0,0 +1,28 @@
+#include "bench.h"
+#include <entry.h>
+
+#include <core/vmemory.h>
+
+b8 create_game(game* game) {
+    game->config.x = 100;
+    game->config.y = 100;
+    game->config.width = 1280;
+    game->config.height = 720;
+    game->config.name = "vGo Bench";
+    // As fast as possible, updating once per frame.
+    game->config.target_frame_rate = 0;
+    game->config.fixed_update_rate = 0;
+    game->config.max_updates_per_frame = 0;
+    game->config.render_buffer_count = 2;
+    game->config.frame_stats_path = 0;
+    game->config.headless = true;
+
+    game->initialize = bench_initialize;
+    game->update = bench_update;
+    game->render = bench_render;
+    game->on_resize = bench_on_resize;
+
+    game->state = vallocate(sizeof(bench_state), MEMORY_TAG_GAME);
+    game->application_state = 0;
+    return true;
+}
@@ -7,6 +7,13 @@
 #include "core/event.h"
 #include "core/input.h"
 #include "core/clock.h"
+#include "core/frame_pacer.h"
+#include "core/frame_stats.h"
+#include "core/timer.h"
+#include "core/job_system.h"
+#include "core/profiler.h"
+#include "core/task_system.h"
+#include "core/vstring.h"
 
 #include "memory/linear_allocator.h"
 #include "renderer/renderer_frontend.h"
@@ -19,6 +26,16 @@ typedef struct application_state {
     i16 height;
     clock clock;
     f64 last_time;
+    frame_pacer pacer;
+    frame_stats frame_stats;
+    // Start of the current frame, in absolute time.
+    f64 frame_start_time;
+    i32 exit_code;
+
+    // 0 for a variable timestep.
+    f64 fixed_step_seconds;
+    u32 max_updates_per_frame;
+    f64 update_accumulator;
 
     linear_allocator systems_allocator;
     
@@ -34,9 +51,21 @@ typedef struct application_state {
     u64 input_system_memory_requirement;
     void* input_system_state;
 
+    u64 timer_system_memory_requirement;
+    void* timer_system_state;
+
     u64 platform_system_memory_requirement;
     void* platform_system_state;
 
+    u64 profiler_memory_requirement;
+    void* profiler_state;
+
+    u64 job_system_memory_requirement;
+    void* job_system_state;
+
+    u64 task_system_memory_requirement;
+    void* task_system_state;
+
     u64 renderer_system_memory_requirement;
     void* renderer_system_state;
     
@@ -88,14 +117,21 @@ b8 application_create(game* game_inst) {
     input_system_initialize(&app_state->input_system_memory_requirement, 0);
     app_state->input_system_state = linear_allocator_allocate(&app_state->systems_allocator, app_state->input_system_memory_requirement);
     input_system_initialize(&app_state->input_system_memory_requirement, app_state->input_system_state);
+
+
+    timer_system_initialize(&app_state->timer_system_memory_requirement, 0);
+    app_state->timer_system_state = linear_allocator_allocate(&app_state->systems_allocator, app_state->timer_system_memory_requirement);
+    timer_system_initialize(&app_state->timer_system_memory_requirement, app_state->timer_system_state);
     
 
     event_register(EVENT_CODE_APPLICATION_QUIT, 0, application_on_event);
     event_register(EVENT_CODE_KEY_PRESSED, 0, application_on_key);
     event_register(EVENT_CODE_KEY_RELEASED, 0, application_on_key); 
     event_register(EVENT_CODE_RESIZED, 0, application_on_resized);
+    // Dragging the window border produces a storm of these, only the final size matters.
+    event_set_coalesce_policy(EVENT_CODE_RESIZED, EVENT_COALESCE_KEEP_LATEST);
 
-    platform_system_startup(&app_state->platform_system_memory_requirement, 0, 0, 0, 0, 0, 0);
+    platform_system_startup(&app_state->platform_system_memory_requirement, 0, 0, 0, 0, 0, 0, false);
     app_state->platform_system_state = linear_allocator_allocate(&app_state->systems_allocator, app_state->platform_system_memory_requirement);
     if (!platform_system_startup(
             &app_state->platform_system_memory_requirement,
@@ -104,14 +140,44 @@ b8 application_create(game* game_inst) {
             game_inst->config.x,
             game_inst->config.y,
             game_inst->config.width,
-            game_inst->config.height)) {
+            game_inst->config.height,
+            !game_inst->config.headless)) {
+        return false;
+    }
+
+    platform_cpu_info cpu_info;
+    if (platform_get_cpu_info(&cpu_info)) {
+        INFO("CPU: %u cores, %u threads, %u NUMA nodes, L1d %lluK, L2 %lluK, L3 %lluK, %uB lines.",
+             cpu_info.physical_core_count, cpu_info.logical_core_count, cpu_info.numa_node_count,
+             cpu_info.l1_data_cache_size / 1024, cpu_info.l2_cache_size / 1024, cpu_info.l3_cache_size / 1024,
+             cpu_info.cache_line_size);
+    }
+
+    // After platform startup, which calibrates the cycle counter used for timestamps.
+    profiler_initialize(&app_state->profiler_memory_requirement, 0);
+    app_state->profiler_state = linear_allocator_allocate(&app_state->systems_allocator, app_state->profiler_memory_requirement);
+    profiler_initialize(&app_state->profiler_memory_requirement, app_state->profiler_state);
+
+    // One worker per remaining logical core.
+    job_system_initialize(&app_state->job_system_memory_requirement, 0, 0);
+    app_state->job_system_state = linear_allocator_allocate(&app_state->systems_allocator, app_state->job_system_memory_requirement);
+    if (!job_system_initialize(&app_state->job_system_memory_requirement, app_state->job_system_state, 0)) {
+        FATAL("Job system failed to initialize!");
+        return false;
+    }
+
+    // Default fiber count and stack size.
+    task_system_initialize(&app_state->task_system_memory_requirement, 0, 0, 0);
+    app_state->task_system_state = linear_allocator_allocate(&app_state->systems_allocator, app_state->task_system_memory_requirement);
+    if (!task_system_initialize(&app_state->task_system_memory_requirement, app_state->task_system_state, 0, 0)) {
+        FATAL("Task system failed to initialize!");
         return false;
     }
 
     // Initialize Renderer
-    renderer_system_initialize(&app_state->renderer_system_memory_requirement, 0, 0);
+    renderer_system_initialize(&app_state->renderer_system_memory_requirement, 0, 0, 0);
     app_state->renderer_system_state = linear_allocator_allocate(&app_state->systems_allocator, app_state->renderer_system_memory_requirement);
-    if (!renderer_system_initialize(&app_state->renderer_system_memory_requirement, app_state->renderer_system_state, game_inst->config.name)) {
+    if (!renderer_system_initialize(&app_state->renderer_system_memory_requirement, app_state->renderer_system_state, game_inst->config.name, game_inst->config.render_buffer_count)) {
         FATAL("Renderer failed to initialize!");
         return false;
     }
@@ -127,57 +193,163 @@ b8 application_create(game* game_inst) {
     return true;
 }
 
+/**
+ * Runs the game's update for this frame: once with the frame's delta time, or
+ * with a fixed timestep as many times as the accumulated time allows.
+ */
+static b8 update_game(f64 delta_time, f32* out_alpha, u32* out_update_count, f32* out_update_delta_time) {
+    game* game_inst = app_state->game_inst;
+    f64 step = app_state->fixed_step_seconds;
+    if (step <= 0) {
+        // Actions are evaluated here rather than in input_update, which runs at the end of
+        // the frame, so the game sees input pumped this frame rather than the frame before.
+        input_update_actions();
+        *out_alpha = 1.0f;
+        *out_update_count = 1;
+        *out_update_delta_time = (f32)delta_time;
+        return game_inst->update(game_inst, (f32)delta_time);
+    }
+
+    f64 max_frame_time = step * app_state->max_updates_per_frame;
+    if (delta_time > max_frame_time) {
+        delta_time = max_frame_time;
+    }
+    app_state->update_accumulator += delta_time;
+
+    *out_update_count = 0;
+    *out_update_delta_time = (f32)step;
+    while (app_state->update_accumulator >= step) {
+        // Evaluated per update rather than per frame, so a press landing in a frame without an
+        // update is seen by the next one, and a press is not repeated by every update in a frame.
+        input_update_actions();
+        if (!game_inst->update(game_inst, (f32)step)) {
+            return false;
+        }
+        app_state->update_accumulator -= step;
+        (*out_update_count)++;
+    }
+
+    *out_alpha = (f32)(app_state->update_accumulator / step);
+    return true;
+}
+
+/**
+ * Runs the game updates recorded for this replay frame.
+ */
+static b8 replay_game(u32 update_count, f32 update_delta_time) {
+    game* game_inst = app_state->game_inst;
+    for (u32 i = 0; i < update_count; ++i) {
+        input_update_actions();
+        if (!game_inst->update(game_inst, update_delta_time)) {
+            return false;
+        }
+    }
+    return true;
+}
+
 b8 application_run() {
     app_state->is_running = true;
     clock_start(&app_state->clock);
     clock_update(&app_state->clock);
     app_state->last_time = app_state->clock.elapsed;
-    f64 running_time = 0;
-    u8 frame_count = 0;
-    f64 target_frame_seconds = 1.0f / 60;
+    frame_pacer_create(app_state->game_inst->config.target_frame_rate, &app_state->pacer);
+
+    const app_config* config = &app_state->game_inst->config;
+    app_state->fixed_step_seconds = config->fixed_update_rate > 0 ? 1.0 / (f64)config->fixed_update_rate : 0;
+    app_state->max_updates_per_frame = config->max_updates_per_frame ? config->max_updates_per_frame : 8;
+    app_state->update_accumulator = 0;
+    frame_stats_reset(&app_state->frame_stats);
+    app_state->frame_start_time = platform_get_absolute_time();
 
     INFO(get_memory_usage_str());
     while(app_state->is_running) {
+        // Collects the zones of the previous iteration, including its "frame" zone.
+        profiler_frame_end();
+        PROFILE_SCOPE("frame");
+
+        f64 frame_start = platform_get_absolute_time();
+        f64 frame_ms = (frame_start - app_state->frame_start_time) * 1000.0;
+        app_state->frame_start_time = frame_start;
+
         if(!platform_pump_messages()) {
             app_state->is_running = false;
         }
+
+        // Feeds recorded input in place of the (ignored) live input while replaying.
+        input_replay_update();
+
+        // Expired timers post their events, so advance them before dispatching. Replays
+        // advance them as recorded so they expire on the same frames.
+        clock_update(&app_state->clock);
+        u32 replay_update_count = 0;
+        f32 replay_update_delta_time = 0;
+        f64 timer_time = app_state->clock.elapsed;
+        b8 replay_frame = input_replay_frame(&replay_update_count, &replay_update_delta_time, &timer_time);
+        timer_system_update(timer_time);
+
+        // Deliver everything queued while pumping messages in one batch. This runs
+        // even while suspended so that resize/restore events still get through.
+        event_dispatch_pending();
+
+        // Resume tasks whose waits ended without another task finishing to notice.
+        task_system_poll();
+
         if(!app_state->is_suspended) {
 
-            clock_update(&app_state->clock);
             f64 current_time = app_state->clock.elapsed;
             f64 delta_time = current_time - app_state->last_time;
-            f64 frame_start_time = platform_get_absolute_time();
 
-            if (!app_state->game_inst->update(app_state->game_inst, (f32)delta_time)) {
+            f32 alpha = 1.0f;
+            u32 update_count = 0;
+            f32 update_delta_time = 0;
+            PROFILE_BEGIN("update");
+            b8 updated;
+            if (replay_frame) {
+                // Updates exactly as the recorded frame did, whatever this frame's delta time.
+                updated = replay_game(replay_update_count, replay_update_delta_time);
+            } else {
+                updated = update_game(delta_time, &alpha, &update_count, &update_delta_time);
+            }
+            PROFILE_END();
+            if (!updated) {
                 FATAL("Game update failed, exiting..");
                 app_state->is_running = false;
                 break;
             }
 
-            if (!app_state->game_inst->render(app_state->game_inst, (f32)delta_time)) {
+            PROFILE_BEGIN("game_render");
+            b8 rendered = app_state->game_inst->render(app_state->game_inst, (f32)delta_time, alpha);
+            PROFILE_END();
+            if (!rendered) {
                 FATAL("Game render failed, exiting..");
                 app_state->is_running = false;
                 break;
             }
 
+            // With a render thread this only queues the frame, and the next iteration
+            // simulates while it is drawn.
             render_packet packet;
             packet.delta_time = (f32)delta_time;
             renderer_draw_frame(&packet);
 
-            f64 frame_end_time = platform_get_absolute_time();
-            f64 frame_elapsed_time = frame_end_time - frame_start_time;
-            running_time += frame_elapsed_time;
-            f64 remaining_seconds = target_frame_seconds - frame_elapsed_time;
-
-            if (remaining_seconds > 0) {
-                u64 remaining_milliseconds = (u64)(remaining_seconds * 1000);
-                b8 limit_frames = false;
-                if (remaining_milliseconds > 0 && limit_frames) {
-                    platform_sleep(remaining_milliseconds - 1);
-                }
-                frame_count++;
-            }
-
+            // The previous frame's interval, with the renderer's timings of the last frame drawn.
+            renderer_stats render_stats;
+            renderer_get_stats(&render_stats);
+            frame_sample sample;
+            sample.values[FRAME_STAT_FRAME] = (f32)frame_ms;
+            sample.values[FRAME_STAT_CPU] = (f32)((platform_get_absolute_time() - frame_start) * 1000.0);
+            sample.values[FRAME_STAT_GPU] = (f32)render_stats.gpu_ms;
+            sample.values[FRAME_STAT_FENCE_WAIT] = (f32)render_stats.fence_wait_ms;
+            sample.values[FRAME_STAT_PRESENT] = (f32)render_stats.present_ms;
+            frame_stats_record(&app_state->frame_stats, &sample);
+
+            // Sleep off the rest of the frame when limiting the frame rate.
+            PROFILE_BEGIN("frame_pacer_wait");
+            frame_pacer_wait(&app_state->pacer);
+            PROFILE_END();
+
+            // Does nothing unless recording.
+            input_recording_frame(update_count, update_delta_time, timer_time);
             input_update(delta_time);
 
             app_state->last_time = current_time;
@@ -185,6 +357,13 @@ b8 application_run() {
     }
 
     app_state->is_running = false;
+
+    frame_pacer_log_stats(&app_state->pacer);
+    if (app_state->game_inst->config.frame_stats_path) {
+        application_write_frame_stats(app_state->game_inst->config.frame_stats_path);
+    } else {
+        frame_stats_log(&app_state->frame_stats);
+    }
     
     // Technically obsolete, but serves as a demonstration on how it works
     event_unregister(EVENT_CODE_APPLICATION_QUIT, 0, application_on_event);
@@ -193,8 +372,18 @@ b8 application_run() {
 
     input_system_shutdown(app_state->input_system_state);
 
+    timer_system_shutdown(app_state->timer_system_state);
+
     renderer_system_shutdown(app_state->renderer_system_state);
 
+    job_system_shutdown(app_state->job_system_state);
+
+    // After the job system, so no thread is still running a task.
+    task_system_shutdown(app_state->task_system_state);
+
+    // Last of the threaded systems, so no thread is still writing zones.
+    profiler_shutdown(app_state->profiler_state);
+
     platform_system_shutdown(app_state->platform_system_state);
 
     memory_system_shutdown(app_state->memory_system_state);
@@ -203,6 +392,40 @@ b8 application_run() {
     return true;
 }
 
+void application_set_target_frame_rate(f32 target_frame_rate) {
+    frame_pacer_set_target(&app_state->pacer, target_frame_rate);
+}
+
+b8 application_write_frame_stats(const char* base_path) {
+    frame_stats_log(&app_state->frame_stats);
+
+    char path[512];
+    string_format(path, "%s.csv", base_path);
+    b8 result = frame_stats_write_csv(&app_state->frame_stats, path);
+    string_format(path, "%s.json", base_path);
+    result = frame_stats_write_json(&app_state->frame_stats, path) && result;
+    if (result) {
+        INFO("Frame stats written to %s.csv and %s.json.", base_path, base_path);
+    }
+    return result;
+}
+
+const frame_stats* application_get_frame_stats() {
+    return &app_state->frame_stats;
+}
+
+void application_reset_frame_stats() {
+    frame_stats_reset(&app_state->frame_stats);
+}
+
+void application_set_exit_code(i32 exit_code) {
+    app_state->exit_code = exit_code;
+}
+
+i32 application_get_exit_code() {
+    return app_state ? app_state->exit_code : 0;
+}
+
 void application_get_framebuffer_size(u32* width, u32* height) {
     *width = app_state->width;
     *height = app_state->height;
@@ -3,6 +3,7 @@
 #include "defines.h"
 
 struct game;
+struct frame_stats;
 
 typedef struct app_config { 
     i16 x;
@@ -10,10 +11,58 @@ typedef struct app_config {
     i16 width;
     i16 height;
     const char* name;
+    // Frames per second the main loop is limited to, or 0 for unlimited.
+    f32 target_frame_rate;
+    // Updates per second when running a fixed timestep, or 0 to update once per frame with a
+    // variable delta time.
+    f32 fixed_update_rate;
+    // Fixed timestep only: the most updates run in one frame. Time beyond that is dropped so a
+    // slow frame can't cause ever more updates (spiral of death). 0 uses a default of 8.
+    u32 max_updates_per_frame;
+    // Frames buffered for a dedicated render thread, which draws one frame while the main
+    // thread simulates the next: 2 for double buffering, 3 for triple (more latency, smoother
+    // when frame costs vary). 0 or 1 draws on the main thread.
+    u32 render_buffer_count;
+    // Written on exit as <frame_stats_path>.csv and .json, or 0 to not write frame statistics.
+    const char* frame_stats_path;
+    // Keeps the window hidden, for automated runs such as benchmarks. It is still rendered to.
+    b8 headless;
 } app_config;
 
 API b8 application_create(struct game* game_inst);
 
 API b8 application_run();
 
+/**
+ * Changes the frame rate limit set in app_config at runtime.
+ * @param target_frame_rate The target in frames per second, or 0 for unlimited.
+ */
+API void application_set_target_frame_rate(f32 target_frame_rate);
+
+/**
+ * Logs statistics of the most recent frames and writes them as <base_path>.csv
+ * (every frame) and <base_path>.json (percentiles and hitches).
+ * @param base_path The path of the files to write, without extension.
+ * @returns True if both files were written; otherwise false.
+ */
+API b8 application_write_frame_stats(const char* base_path);
+
+/**
+ * Gets the statistics of the most recent frames, updated once per frame.
+ */
+API const struct frame_stats* application_get_frame_stats();
+
+/**
+ * Clears the recorded frames, e.g. once a warmup is over.
+ */
+API void application_reset_frame_stats();
+
+/**
+ * Sets the code returned from main once the application has shut down.
+ * @param exit_code The code; 0 (the default) for success.
+ */
+API void application_set_exit_code(i32 exit_code);
+
+API i32 application_get_exit_code();
+
 void application_get_framebuffer_size(u32* width, u32* height);
\ No newline at end of file
@@ -1,32 +1,163 @@
 #include "core/event.h"
 
 #include "core/vmemory.h"
+#include "core/logger.h"
+#include "core/profiler.h"
 #include "containers/darray.h"
+#include "memory/linear_allocator.h"
+#include "platform/platform.h"
+#include "platform/vatomic.h"
 
 typedef struct registered_event {
     void* listener;
     PFN_on_event callback;
+    i32 priority;
+    // Index into event_system_state.listeners.
+    u32 slot;
+    // The slot's generation when registered; the slot may be freed and reused meanwhile.
+    u32 generation;
 } registered_event;
 
+/**
+ * Backs an event_handle. Records where the registration lives so unregistering
+ * by handle does not need to search.
+ */
+typedef struct listener_slot {
+    // Bumped every time the slot is freed so stale handles are rejected.
+    u32 generation;
+    // Position in registered[code].events, kept up to date whenever entries move.
+    u32 position;
+    u16 code;
+    b8 in_use;
+    // Next free slot when not in use.
+    u32 next_free;
+
+    // Profiling data.
+    u64 call_count;
+    f64 total_seconds;
+    f64 max_seconds;
+} listener_slot;
+
+#define MAX_EVENT_LISTENERS 4096
+
 typedef struct event_code_entry {
     registered_event* events;
+    // Set when the listener array holds tombstones (entries with a null callback)
+    // or entries appended out of priority order mid-dispatch. Fixed up once no
+    // event_fire is on the stack.
+    b8 needs_fixup;
+    // Number of times event_fire was called for this code while profiling.
+    u64 fire_count;
+    // event_coalesce_policy applied by event_post.
+    u8 coalesce_policy;
+    // Index of the most recently posted event with this code in the
+    // write queue, or INVALID_ID if none is pending.
+    u32 pending_tail;
 } event_code_entry;
 
+typedef struct queued_event {
+    void* sender;
+    event_context context;
+    // Index of the next queued event with the same code, or INVALID_ID.
+    u32 next;
+} queued_event;
+
+typedef struct pending_code {
+    u16 code;
+    // Index of the first queued event with this code.
+    u32 head;
+} pending_code;
+
+typedef struct event_queue {
+    queued_event* events;
+    // Codes with pending events, in the order they were first posted.
+    pending_code* codes;
+    // Holds event_post_payload data for this queue, reset after it is dispatched.
+    linear_allocator payload_arena;
+} event_queue;
+
+// Per queue, carved out of the event system's own memory block.
+#define EVENT_PAYLOAD_ARENA_SIZE (64 * 1024)
+
+/**
+ * A slot in the thread-safe inbox. The sequence number tells producers and the
+ * consumer whose turn it is to touch the slot (bounded MPMC queue by D. Vyukov).
+ */
+typedef struct inbox_cell {
+    u64 sequence;
+    u16 code;
+    void* sender;
+    event_context context;
+} inbox_cell;
+
+// Must be a power of 2.
+#define EVENT_INBOX_CAPACITY 1024
+
+typedef struct event_inbox {
+    // Padded onto separate cache lines so producers and the consumer do not false-share.
+    u64 enqueue_pos;
+    u8 pad0[VCACHE_LINE_SIZE - sizeof(u64)];
+    u64 dequeue_pos;
+    u8 pad1[VCACHE_LINE_SIZE - sizeof(u64)];
+    inbox_cell cells[EVENT_INBOX_CAPACITY];
+} event_inbox;
+
 #define MAX_MESSAGE_CODES 16200
 
 typedef struct event_system_state {
     event_code_entry registered[MAX_MESSAGE_CODES];
+    // Double-buffered so listeners can post while the other queue is dispatched.
+    event_queue queues[2];
+    u8 write_queue;
+
+    // How many event_fire calls are currently on the stack.
+    u32 fire_depth;
+    // Codes with needs_fixup set, processed once fire_depth returns to 0.
+    u16* dirty_codes;
+
+    listener_slot listeners[MAX_EVENT_LISTENERS];
+    u32 first_free_listener;
+
+    b8 profiling_enabled;
+
+    event_inbox inbox;
 } event_system_state;
 
 static event_system_state* state_ptr;
 
 void event_system_initialize(u64* memory_requirement, void* state) {
-    *memory_requirement = sizeof(event_system_state);
+    *memory_requirement = sizeof(event_system_state) + (EVENT_PAYLOAD_ARENA_SIZE * 2);
     if (state == 0) {
         return;
     }
-    vzero_memory(state, sizeof(state));
+    vzero_memory(state, sizeof(event_system_state));
     state_ptr = state;
+
+    for (u32 i = 0; i < MAX_MESSAGE_CODES; ++i) {
+        state_ptr->registered[i].pending_tail = INVALID_ID;
+    }
+    u8* arena_memory = (u8*)state + sizeof(event_system_state);
+    for (u32 i = 0; i < 2; ++i) {
+        state_ptr->queues[i].events = darray_reserve(queued_event, 256);
+        state_ptr->queues[i].codes = darray_reserve(pending_code, 16);
+        linear_allocator_create(EVENT_PAYLOAD_ARENA_SIZE, arena_memory + (EVENT_PAYLOAD_ARENA_SIZE * i), &state_ptr->queues[i].payload_arena);
+    }
+    state_ptr->write_queue = 0;
+    state_ptr->fire_depth = 0;
+    state_ptr->dirty_codes = darray_create(u16);
+
+    for (u32 i = 0; i < MAX_EVENT_LISTENERS; ++i) {
+        state_ptr->listeners[i].generation = 1;
+        state_ptr->listeners[i].next_free = (i + 1 < MAX_EVENT_LISTENERS) ? i + 1 : INVALID_ID;
+    }
+    state_ptr->first_free_listener = 0;
+    state_ptr->profiling_enabled = false;
+
+    for (u64 i = 0; i < EVENT_INBOX_CAPACITY; ++i) {
+        state_ptr->inbox.cells[i].sequence = i;
+    }
+    state_ptr->inbox.enqueue_pos = 0;
+    state_ptr->inbox.dequeue_pos = 0;
 }
 
 void event_system_shutdown(void* state) {
@@ -37,52 +168,200 @@ void event_system_shutdown(void* state) {
                 state_ptr->registered[i].events = 0;
             }
         }
+        for (u32 i = 0; i < 2; ++i) {
+            darray_destroy(state_ptr->queues[i].events);
+            darray_destroy(state_ptr->queues[i].codes);
+            linear_allocator_destroy(&state_ptr->queues[i].payload_arena);
+        }
+        darray_destroy(state_ptr->dirty_codes);
     }
     state_ptr = 0;
 }
 
-b8 event_register(u16 code, void* listener, PFN_on_event on_event) {
-    if(!state_ptr) {
-        return false;
+static void mark_dirty(u16 code) {
+    event_code_entry* entry = &state_ptr->registered[code];
+    if (!entry->needs_fixup) {
+        entry->needs_fixup = true;
+        darray_push(state_ptr->dirty_codes, code);
     }
+}
 
-    if(state_ptr->registered[code].events == 0) {
-        state_ptr->registered[code].events = darray_create(registered_event);
+/**
+ * Removes tombstones, restores priority order and refreshes slot positions.
+ * Only called while no event_fire is on the stack.
+ */
+static void fixup_listeners(u16 code) {
+    event_code_entry* entry = &state_ptr->registered[code];
+    registered_event* events = entry->events;
+    u64 registered_count = darray_length(events);
+    u64 write = 0;
+    for (u64 read = 0; read < registered_count; ++read) {
+        if (!events[read].callback) {
+            continue;
+        }
+        // Stable insertion sort, highest priority first. Lists are short and
+        // almost always already ordered.
+        registered_event e = events[read];
+        u64 j = write;
+        while (j > 0 && events[j - 1].priority < e.priority) {
+            events[j] = events[j - 1];
+            --j;
+        }
+        events[j] = e;
+        ++write;
+    }
+    darray_length_set(events, write);
+    for (u64 i = 0; i < write; ++i) {
+        state_ptr->listeners[events[i].slot].position = (u32)i;
     }
+    entry->needs_fixup = false;
+}
 
-    u64 registered_count = darray_length(state_ptr->registered[code].events);
-    for(u64 i = 0; i < registered_count; ++i) {
-        if(state_ptr->registered[code].events[i].listener == listener) {
-            return false;
-        }
+static void fixup_dirty_codes() {
+    u64 dirty_count = darray_length(state_ptr->dirty_codes);
+    for (u64 i = 0; i < dirty_count; ++i) {
+        fixup_listeners(state_ptr->dirty_codes[i]);
+    }
+    darray_clear(state_ptr->dirty_codes);
+}
+
+static listener_slot* slot_from_handle(event_handle handle) {
+    u32 index = (u32)(handle & 0xFFFFFFFF);
+    u32 generation = (u32)(handle >> 32);
+    if (index >= MAX_EVENT_LISTENERS) {
+        return 0;
+    }
+    listener_slot* slot = &state_ptr->listeners[index];
+    if (!slot->in_use || slot->generation != generation) {
+        return 0;
     }
+    return slot;
+}
+
+static void remove_listener(listener_slot* slot) {
+    // Leave a tombstone instead of shifting the array: O(1), and an in-progress
+    // event_fire never skips a listener. The array is compacted later.
+    state_ptr->registered[slot->code].events[slot->position].callback = 0;
+    mark_dirty(slot->code);
+
+    u32 index = (u32)(slot - state_ptr->listeners);
+    slot->in_use = false;
+    slot->generation++;
+    slot->next_free = state_ptr->first_free_listener;
+    state_ptr->first_free_listener = index;
+}
+
+event_handle event_register_handle(u16 code, void* listener, PFN_on_event on_event, i32 priority) {
+    if (!state_ptr || !on_event) {
+        return INVALID_EVENT_HANDLE;
+    }
+
+    if (state_ptr->first_free_listener == INVALID_ID) {
+        ERROR("event_register_handle - out of listener slots (max %u).", MAX_EVENT_LISTENERS);
+        return INVALID_EVENT_HANDLE;
+    }
+
+    event_code_entry* entry = &state_ptr->registered[code];
+    if (entry->events == 0) {
+        entry->events = darray_create(registered_event);
+    }
+
+    u32 index = state_ptr->first_free_listener;
+    listener_slot* slot = &state_ptr->listeners[index];
+    state_ptr->first_free_listener = slot->next_free;
+    slot->in_use = true;
+    slot->code = code;
+    slot->next_free = INVALID_ID;
+    slot->call_count = 0;
+    slot->total_seconds = 0;
+    slot->max_seconds = 0;
 
-    // If at this point, no duplicate was found. Proceed with registration.
     registered_event event;
     event.listener = listener;
     event.callback = on_event;
-    darray_push(state_ptr->registered[code].events, event);
+    event.priority = priority;
+    event.slot = index;
+    event.generation = slot->generation;
+
+    u32 registered_count = (u32)darray_length(entry->events);
+    darray_push(entry->events, event);
+
+    if (state_ptr->fire_depth > 0) {
+        // Appending is safe mid-dispatch: event_fire re-reads the array every
+        // iteration and only visits listeners that existed when it started.
+        // Priority order is restored once dispatch unwinds.
+        slot->position = registered_count;
+        mark_dirty(code);
+    } else {
+        // Shift lower priority listeners back to keep the array ordered.
+        u32 position = registered_count;
+        registered_event* events = entry->events;
+        while (position > 0 && events[position - 1].priority < priority) {
+            events[position] = events[position - 1];
+            // Tombstones keep the index of a slot that may since have been reused.
+            if (events[position].callback) {
+                state_ptr->listeners[events[position].slot].position = position;
+            }
+            --position;
+        }
+        events[position] = event;
+        slot->position = position;
+    }
 
+    return ((u64)slot->generation << 32) | index;
+}
+
+b8 event_unregister_handle(event_handle handle) {
+    if (!state_ptr) {
+        return false;
+    }
+
+    listener_slot* slot = slot_from_handle(handle);
+    if (!slot) {
+        return false;
+    }
+
+    // The array itself is compacted lazily, after the next event_fire or dispatch.
+    remove_listener(slot);
     return true;
 }
 
+b8 event_register(u16 code, void* listener, PFN_on_event on_event) {
+    if(!state_ptr) {
+        return false;
+    }
+
+    registered_event* events = state_ptr->registered[code].events;
+    if (events) {
+        u64 registered_count = darray_length(events);
+        for(u64 i = 0; i < registered_count; ++i) {
+            if(events[i].callback && events[i].listener == listener) {
+                return false;
+            }
+        }
+    }
+
+    // If at this point, no duplicate was found. Proceed with registration.
+    return event_register_handle(code, listener, on_event, EVENT_PRIORITY_NORMAL) != INVALID_EVENT_HANDLE;
+}
+
 b8 event_unregister(u16 code, void* listener, PFN_on_event on_event) {
     if(!state_ptr) {
         return false;
     }
 
     // On nothing is registered for the code, boot out.
-    if(state_ptr->registered[code].events == 0) {
+    registered_event* events = state_ptr->registered[code].events;
+    if(events == 0) {
         return false;
     }
 
-    u64 registered_count = darray_length(state_ptr->registered[code].events);
+    u64 registered_count = darray_length(events);
     for(u64 i = 0; i < registered_count; ++i) {
-        registered_event e = state_ptr->registered[code].events[i];
-        if(e.listener == listener && e.callback == on_event) {
+        registered_event e = events[i];
+        if(e.callback && e.listener == listener && e.callback == on_event) {
             // Found one, remove it
-            registered_event popped_event;
-            darray_pop_at(state_ptr->registered[code].events, i, &popped_event);
+            remove_listener(&state_ptr->listeners[e.slot]);
             return true;
         }
     }
@@ -92,24 +371,320 @@ b8 event_unregister(u16 code, void* listener, PFN_on_event on_event) {
 }
 
 b8 event_fire(u16 code, void* sender, event_context context) {
+    PROFILE_SCOPE("event_fire");
     if(!state_ptr) {
         return false;
     }
 
+    event_code_entry* entry = &state_ptr->registered[code];
+    b8 profiling = state_ptr->profiling_enabled;
+    if (profiling) {
+        entry->fire_count++;
+    }
+
     // If nothing is registered for the code, boot out.
-    if(state_ptr->registered[code].events == 0) {
+    if(entry->events == 0) {
         return false;
     }
 
-    u64 registered_count = darray_length(state_ptr->registered[code].events);
+    b8 handled = false;
+    state_ptr->fire_depth++;
+
+    // Listeners registered by a callback are not called until the next fire.
+    u64 registered_count = darray_length(entry->events);
     for(u64 i = 0; i < registered_count; ++i) {
-        registered_event e = state_ptr->registered[code].events[i];
-        if(e.callback(code, sender, e.listener, context)) {
+        // Re-read every iteration, a callback may have grown (and moved) the array.
+        registered_event e = entry->events[i];
+        if (!e.callback) {
+            continue;
+        }
+
+        b8 result;
+        if (profiling) {
+            f64 start = platform_get_absolute_time();
+            result = e.callback(code, sender, e.listener, context);
+            f64 elapsed = platform_get_absolute_time() - start;
+
+            // The callback may have unregistered itself, and the slot may even have
+            // been reused by a new registration; only the one that just ran is charged.
+            listener_slot* slot = &state_ptr->listeners[e.slot];
+            if (slot->in_use && slot->generation == e.generation) {
+                slot->call_count++;
+                slot->total_seconds += elapsed;
+                if (elapsed > slot->max_seconds) {
+                    slot->max_seconds = elapsed;
+                }
+            }
+        } else {
+            result = e.callback(code, sender, e.listener, context);
+        }
+
+        if(result) {
             // Message has been handled, do not send to other listeners.
-            return true;
+            handled = true;
+            break;
         }
     }
 
-    // Not found.
-    return false;
-}
\ No newline at end of file
+    state_ptr->fire_depth--;
+    if (state_ptr->fire_depth == 0 && darray_length(state_ptr->dirty_codes) > 0) {
+        fixup_dirty_codes();
+    }
+
+    return handled;
+}
+
+b8 event_post(u16 code, void* sender, event_context context) {
+    if (!state_ptr) {
+        return false;
+    }
+
+    event_queue* queue = &state_ptr->queues[state_ptr->write_queue];
+    event_code_entry* entry = &state_ptr->registered[code];
+
+    if (entry->pending_tail != INVALID_ID && entry->coalesce_policy != EVENT_COALESCE_KEEP_ALL) {
+        // Merge into the event already waiting instead of queueing another.
+        queued_event* pending = &queue->events[entry->pending_tail];
+        pending->sender = sender;
+        if (entry->coalesce_policy == EVENT_COALESCE_ACCUMULATE) {
+            for (u32 i = 0; i < 4; ++i) {
+                pending->context.data.i32[i] += context.data.i32[i];
+            }
+        } else {
+            pending->context = context;
+        }
+        return true;
+    }
+
+    queued_event e;
+    e.sender = sender;
+    e.context = context;
+    e.next = INVALID_ID;
+    u32 index = (u32)darray_length(queue->events);
+    darray_push(queue->events, e);
+
+    if (entry->pending_tail == INVALID_ID) {
+        // First event of this code this frame, start a new group.
+        pending_code p;
+        p.code = code;
+        p.head = index;
+        darray_push(queue->codes, p);
+    } else {
+        queue->events[entry->pending_tail].next = index;
+    }
+    entry->pending_tail = index;
+
+    return true;
+}
+
+b8 event_post_payload(u16 code, void* sender, const void* payload, u64 size) {
+    if (!state_ptr) {
+        return false;
+    }
+
+    event_queue* queue = &state_ptr->queues[state_ptr->write_queue];
+    linear_allocator* arena = &queue->payload_arena;
+
+    // Round up so the next payload stays 16-byte aligned.
+    u64 aligned_size = (size + 15) & ~(u64)15;
+    if (arena->allocated + aligned_size > arena->total_size) {
+        WARN("event_post_payload - payload arena exhausted, dropping event %u (%lluB).", code, size);
+        return false;
+    }
+
+    void* block = linear_allocator_allocate(arena, aligned_size);
+    vcopy_memory(block, payload, size);
+
+    event_context context;
+    context.data.payload.block = block;
+    context.data.payload.size = size;
+    return event_post(code, sender, context);
+}
+
+void event_set_coalesce_policy(u16 code, event_coalesce_policy policy) {
+    if (state_ptr) {
+        state_ptr->registered[code].coalesce_policy = (u8)policy;
+    }
+}
+
+b8 event_post_threadsafe(u16 code, void* sender, event_context context) {
+    if (!state_ptr) {
+        return false;
+    }
+
+    event_inbox* inbox = &state_ptr->inbox;
+    inbox_cell* cell;
+    u64 pos = vatomic_load_u64(&inbox->enqueue_pos, VMEMORY_ORDER_RELAXED);
+    for (;;) {
+        cell = &inbox->cells[pos & (EVENT_INBOX_CAPACITY - 1)];
+        u64 sequence = vatomic_load_u64(&cell->sequence, VMEMORY_ORDER_ACQUIRE);
+        i64 diff = (i64)sequence - (i64)pos;
+        if (diff == 0) {
+            // Slot is free; try to claim it. On failure pos is reloaded and we retry.
+            if (vatomic_compare_exchange_u64(&inbox->enqueue_pos, &pos, pos + 1, true, VMEMORY_ORDER_RELAXED, VMEMORY_ORDER_RELAXED)) {
+                break;
+            }
+        } else if (diff < 0) {
+            // The consumer has not caught up; the inbox is full.
+            return false;
+        } else {
+            pos = vatomic_load_u64(&inbox->enqueue_pos, VMEMORY_ORDER_RELAXED);
+        }
+    }
+
+    cell->code = code;
+    cell->sender = sender;
+    cell->context = context;
+    // Publish the slot to the consumer.
+    vatomic_store_u64(&cell->sequence, pos + 1, VMEMORY_ORDER_RELEASE);
+    return true;
+}
+
+/**
+ * Moves everything in the thread-safe inbox onto the write queue. Main thread only.
+ */
+static void drain_inbox() {
+    event_inbox* inbox = &state_ptr->inbox;
+    u64 pos = inbox->dequeue_pos;
+    for (;;) {
+        inbox_cell* cell = &inbox->cells[pos & (EVENT_INBOX_CAPACITY - 1)];
+        u64 sequence = vatomic_load_u64(&cell->sequence, VMEMORY_ORDER_ACQUIRE);
+        if (sequence != pos + 1) {
+            // Empty, or a producer has claimed the slot but not published it yet.
+            break;
+        }
+        event_post(cell->code, cell->sender, cell->context);
+        // Hand the slot back to producers for the next lap around the ring.
+        vatomic_store_u64(&cell->sequence, pos + EVENT_INBOX_CAPACITY, VMEMORY_ORDER_RELEASE);
+        ++pos;
+    }
+    inbox->dequeue_pos = pos;
+}
+
+void event_dispatch_pending() {
+    if (!state_ptr) {
+        return;
+    }
+
+    drain_inbox();
+
+    // Swap queues first so anything posted by listeners lands in the next frame.
+    event_queue* queue = &state_ptr->queues[state_ptr->write_queue];
+    state_ptr->write_queue ^= 1;
+
+    u64 code_count = darray_length(queue->codes);
+    for (u64 i = 0; i < code_count; ++i) {
+        state_ptr->registered[queue->codes[i].code].pending_tail = INVALID_ID;
+    }
+
+    for (u64 i = 0; i < code_count; ++i) {
+        pending_code p = queue->codes[i];
+        for (u32 e = p.head; e != INVALID_ID; e = queue->events[e].next) {
+            event_fire(p.code, queue->events[e].sender, queue->events[e].context);
+        }
+    }
+
+    darray_clear(queue->events);
+    darray_clear(queue->codes);
+    // Every listener has returned, so the payloads can be recycled.
+    linear_allocator_free_all(&queue->payload_arena);
+
+    if (state_ptr->fire_depth == 0 && darray_length(state_ptr->dirty_codes) > 0) {
+        fixup_dirty_codes();
+    }
+}
+
+void event_profiling_set_enabled(b8 enabled) {
+    if (state_ptr) {
+        state_ptr->profiling_enabled = enabled;
+    }
+}
+
+void event_profiling_reset() {
+    if (!state_ptr) {
+        return;
+    }
+    for (u32 i = 0; i < MAX_MESSAGE_CODES; ++i) {
+        state_ptr->registered[i].fire_count = 0;
+    }
+    for (u32 i = 0; i < MAX_EVENT_LISTENERS; ++i) {
+        state_ptr->listeners[i].call_count = 0;
+        state_ptr->listeners[i].total_seconds = 0;
+        state_ptr->listeners[i].max_seconds = 0;
+    }
+}
+
+u64 event_profiling_get_fire_count(u16 code) {
+    if (!state_ptr) {
+        return 0;
+    }
+    return state_ptr->registered[code].fire_count;
+}
+
+b8 event_profiling_get_handler_stats(event_handle handle, event_handler_stats* out_stats) {
+    if (!state_ptr || !out_stats) {
+        return false;
+    }
+    listener_slot* slot = slot_from_handle(handle);
+    if (!slot) {
+        return false;
+    }
+    registered_event e = state_ptr->registered[slot->code].events[slot->position];
+    out_stats->code = slot->code;
+    out_stats->listener = e.listener;
+    out_stats->callback = e.callback;
+    out_stats->call_count = slot->call_count;
+    out_stats->total_seconds = slot->total_seconds;
+    out_stats->max_seconds = slot->max_seconds;
+    return true;
+}
+
+void event_profiling_log(u32 max_entries) {
+    if (!state_ptr) {
+        return;
+    }
+
+    // Pick the most expensive handlers by repeatedly taking the max; max_entries is small.
+    u32 picked[64];
+    u32 picked_count = 0;
+    if (max_entries > 64) {
+        max_entries = 64;
+    }
+
+    INFO("Event handler profile (top %u by total time):", max_entries);
+    while (picked_count < max_entries) {
+        u32 best = INVALID_ID;
+        for (u32 i = 0; i < MAX_EVENT_LISTENERS; ++i) {
+            listener_slot* slot = &state_ptr->listeners[i];
+            if (!slot->in_use || slot->call_count == 0) {
+                continue;
+            }
+            b8 already = false;
+            for (u32 p = 0; p < picked_count; ++p) {
+                if (picked[p] == i) {
+                    already = true;
+                    break;
+                }
+            }
+            if (!already && (best == INVALID_ID || slot->total_seconds > state_ptr->listeners[best].total_seconds)) {
+                best = i;
+            }
+        }
+        if (best == INVALID_ID) {
+            break;
+        }
+        picked[picked_count++] = best;
+
+        listener_slot* slot = &state_ptr->listeners[best];
+        registered_event e = state_ptr->registered[slot->code].events[slot->position];
+        INFO("  code 0x%04x fired %llu: callback %p listener %p, %llu calls, %.3f ms total, %.3f ms avg, %.3f ms max",
+             slot->code,
+             state_ptr->registered[slot->code].fire_count,
+             (void*)e.callback,
+             e.listener,
+             slot->call_count,
+             slot->total_seconds * 1000.0,
+             (slot->total_seconds / slot->call_count) * 1000.0,
+             slot->max_seconds * 1000.0);
+    }
+}
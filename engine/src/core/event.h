@@ -19,14 +19,78 @@ typedef struct event_context {
         u8 u8[16];
 
         char c[16];
+
+        // Set by event_post_payload. The block is only valid until the dispatch
+        // delivering it returns; listeners must copy anything they want to keep.
+        struct {
+            void* block;
+            u64 size;
+        } payload;
     } data;
 } event_context;
 
+/**
+ * Controls what happens when an event is posted for a code that already has
+ * an event waiting in the queue this frame. Has no effect on event_fire.
+ */
+typedef enum event_coalesce_policy {
+    // Every posted event is delivered. Default for all codes.
+    EVENT_COALESCE_KEEP_ALL = 0,
+    // The pending event is replaced, only the most recent one is delivered.
+    EVENT_COALESCE_KEEP_LATEST = 1,
+    // data.i32[0..3] are summed into the pending event, for deltas such as mouse wheel.
+    EVENT_COALESCE_ACCUMULATE = 2
+} event_coalesce_policy;
+
 // Return true if exists
 typedef b8 (*PFN_on_event)(u16 code, void* sender, void* listener, event_context data);
 
-void event_system_initialize(u64* memory_requirement, void* state);
-void event_system_shutdown(void* state);
+/**
+ * Identifies a single registration made with event_register_handle.
+ * Stale handles (already unregistered) are detected and rejected.
+ */
+typedef u64 event_handle;
+
+#define INVALID_EVENT_HANDLE 0
+
+/**
+ * Listeners with a higher priority are called first, and can stop lower priority
+ * listeners from being called by returning true. Any i32 value can be used;
+ * listeners with equal priority are called in registration order.
+ */
+typedef enum event_priority {
+    EVENT_PRIORITY_LOW = -100,
+    EVENT_PRIORITY_NORMAL = 0,
+    EVENT_PRIORITY_HIGH = 100
+} event_priority;
+
+/** Per-handler profiling data. See event_profiling_set_enabled. */
+typedef struct event_handler_stats {
+    u16 code;
+    void* listener;
+    PFN_on_event callback;
+    u64 call_count;
+    f64 total_seconds;
+    f64 max_seconds;
+} event_handler_stats;
+
+API void event_system_initialize(u64* memory_requirement, void* state);
+API void event_system_shutdown(void* state);
+
+/**
+ * Dispatches all events queued with event_post or event_post_threadsafe since the last call. Events are
+ * delivered grouped by code (codes in the order they were first posted, events
+ * within a code in the order they were posted). Events posted by listeners while
+ * dispatching are deferred to the next call. Called once per frame by the application.
+*/
+API void event_dispatch_pending();
+
+/*
+ * Threading: the event system is owned by the main thread. event_register,
+ * event_unregister, event_fire and event_post must only be called from it
+ * (registering/unregistering from inside a listener is fine). Other threads
+ * communicate with the main thread via event_post_threadsafe.
+ */
 
 /**
  * Register to listen for when events are sent.
@@ -37,6 +101,24 @@ void event_system_shutdown(void* state);
 */
 API b8 event_register(u16 code, void* listener, PFN_on_event callback);
 
+/**
+ * Register to listen for when events are sent, with an explicit priority.
+ * Unlike event_register, the same listener may register more than once.
+ * @param code The event code to listen for.
+ * @param listener A pointer to the listener.
+ * @param callback The function to call when the event is sent.
+ * @param priority The order in which listeners are called. See event_priority.
+ * @return A handle for event_unregister_handle, or INVALID_EVENT_HANDLE on failure.
+*/
+API event_handle event_register_handle(u16 code, void* listener, PFN_on_event callback, i32 priority);
+
+/**
+ * Unregisters the registration identified by handle in constant time.
+ * @param handle A handle returned by event_register_handle.
+ * @return true if unregistered; false if the handle is invalid or stale.
+*/
+API b8 event_unregister_handle(event_handle handle);
+
 /**
  * Unregister from listening for when events are sent with the provided code.
  * @param code The event code to stop listening for.
@@ -55,6 +137,80 @@ API b8 event_unregister(u16 code, void* listener, PFN_on_event callback);
 */
 API b8 event_fire(u16 code, void* sender, event_context context);
 
+/**
+ * Queues an event to be delivered to listeners of the given code on the next
+ * call to event_dispatch_pending, rather than immediately. Use event_fire for
+ * events that must be handled right away.
+ * @param code The event code to post.
+ * @param sender A pointer to the sender.
+ * @param context The event data.
+ * @return true if the event was queued.
+*/
+API b8 event_post(u16 code, void* sender, event_context context);
+
+/**
+ * Posts an event from any thread without taking a lock. The event is placed in
+ * a fixed-size inbox which the main thread drains at the start of
+ * event_dispatch_pending (before the game updates), after which it is delivered
+ * like any other posted event.
+ * @param code The event code to post.
+ * @param sender A pointer to the sender.
+ * @param context The event data.
+ * @return true if queued; false if the inbox is full.
+*/
+API b8 event_post_threadsafe(u16 code, void* sender, event_context context);
+
+/**
+ * Posts an event carrying a payload of arbitrary size. The payload is copied
+ * into a per-frame arena owned by the event system, so the caller's buffer does
+ * not need to outlive the call and no heap allocation takes place. Listeners
+ * receive it as context.data.payload.block / context.data.payload.size.
+ * Do not combine with EVENT_COALESCE_ACCUMULATE.
+ * @param code The event code to post.
+ * @param sender A pointer to the sender.
+ * @param payload The data to be copied.
+ * @param size The size of the data in bytes.
+ * @return true if queued; false if the frame's payload arena is exhausted.
+*/
+API b8 event_post_payload(u16 code, void* sender, const void* payload, u64 size);
+
+/**
+ * Sets how posted events with the given code are merged while queued.
+ * @param code The event code.
+ * @param policy The coalescing policy. See event_coalesce_policy.
+*/
+API void event_set_coalesce_policy(u16 code, event_coalesce_policy policy);
+
+/**
+ * Enables/disables event profiling. While enabled, event_fire counts calls per
+ * code and times every listener callback.
+ * @param enabled Whether profiling is enabled.
+*/
+API void event_profiling_set_enabled(b8 enabled);
+
+/** Clears all recorded profiling data. */
+API void event_profiling_reset();
+
+/**
+ * @param code The event code.
+ * @return The number of times the code was fired while profiling was enabled.
+*/
+API u64 event_profiling_get_fire_count(u16 code);
+
+/**
+ * Gets profiling data for a single registration.
+ * @param handle A handle returned by event_register_handle.
+ * @param out_stats A pointer to hold the stats.
+ * @return true on success; false if the handle is invalid.
+*/
+API b8 event_profiling_get_handler_stats(event_handle handle, event_handler_stats* out_stats);
+
+/**
+ * Logs the most expensive handlers, sorted by cumulative time.
+ * @param max_entries The maximum number of handlers to list.
+*/
+API void event_profiling_log(u32 max_entries);
+
 typedef enum system_event_code {
     // Shuts the application down on the next frame.
     EVENT_CODE_APPLICATION_QUIT = 0x01,
@@ -83,20 +239,20 @@ typedef enum system_event_code {
      */
     EVENT_CODE_BUTTON_RELEASED = 0x05,
 
-    // Mouse moved.
+    // Mouse moved. Only the latest position is delivered each frame.
     /* Context usage:
      * u16 x = data.data.u16[0];
      * u16 y = data.data.u16[1];
      */
     EVENT_CODE_MOUSE_MOVED = 0x06,
 
-    // Mouse moved.
+    // Mouse wheel scrolled. Accumulated when posted more than once per frame.
     /* Context usage:
-     * u8 z_delta = data.data.u8[0];
+     * i32 z_delta = data.data.i32[0];
      */
     EVENT_CODE_MOUSE_WHEEL = 0x07,
 
-    // Resized/resolution changed from the OS.
+    // Resized/resolution changed from the OS. Only the latest size is delivered each frame.
     /* Context usage:
      * u16 width = data.data.u16[0];
      * u16 height = data.data.u16[1];
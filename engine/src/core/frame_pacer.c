@@ -0,0 +1,117 @@
+#include "core/frame_pacer.h"
+
+#include "core/logger.h"
+#include "core/vmemory.h"
+#include "math/vmath.h"
+#include "platform/platform.h"
+
+// Calibrate against recent sleeps only, so the estimate follows changes in system load.
+#define FRAME_PACER_SLEEP_SAMPLE_LIMIT 64
+// Initial guess for a 1ms sleep, before any have been measured.
+#define FRAME_PACER_INITIAL_SLEEP_ESTIMATE 0.002
+
+void frame_pacer_create(f32 target_frame_rate, frame_pacer* out_pacer) {
+    vzero_memory(out_pacer, sizeof(frame_pacer));
+    out_pacer->sleep_mean = FRAME_PACER_INITIAL_SLEEP_ESTIMATE;
+    frame_pacer_set_target(out_pacer, target_frame_rate);
+}
+
+void frame_pacer_set_target(frame_pacer* pacer, f32 target_frame_rate) {
+    pacer->target_frame_seconds = target_frame_rate > 0 ? 1.0 / (f64)target_frame_rate : 0;
+    // Restart pacing from the next frame.
+    pacer->next_deadline = 0;
+    frame_pacer_reset_stats(pacer);
+}
+
+void frame_pacer_reset_stats(frame_pacer* pacer) {
+    vzero_memory(&pacer->stats, sizeof(frame_pacer_stats));
+    pacer->last_frame_time = 0;
+}
+
+static void record_sleep(frame_pacer* pacer, f64 duration) {
+    // Welford's online mean/variance, with the sample count capped so old samples decay.
+    if (pacer->sleep_count < FRAME_PACER_SLEEP_SAMPLE_LIMIT) {
+        pacer->sleep_count++;
+    } else {
+        pacer->sleep_m2 *= (f64)(FRAME_PACER_SLEEP_SAMPLE_LIMIT - 1) / FRAME_PACER_SLEEP_SAMPLE_LIMIT;
+    }
+    f64 delta = duration - pacer->sleep_mean;
+    pacer->sleep_mean += delta / (f64)pacer->sleep_count;
+    pacer->sleep_m2 += delta * (duration - pacer->sleep_mean);
+}
+
+static void record_frame(frame_pacer* pacer, f64 now) {
+    if (pacer->last_frame_time != 0) {
+        frame_pacer_stats* stats = &pacer->stats;
+        f64 error = (now - pacer->last_frame_time) - pacer->target_frame_seconds;
+        stats->frame_count++;
+        f64 delta = error - stats->mean_error;
+        stats->mean_error += delta / (f64)stats->frame_count;
+        stats->m2 += delta * (error - stats->mean_error);
+        stats->jitter = vsqrt(stats->m2 / (f64)stats->frame_count);
+        f64 magnitude = error < 0 ? -error : error;
+        if (magnitude > stats->max_error) {
+            stats->max_error = magnitude;
+        }
+    }
+    pacer->last_frame_time = now;
+}
+
+void frame_pacer_wait(frame_pacer* pacer) {
+    f64 now = platform_get_absolute_time();
+    if (pacer->target_frame_seconds <= 0) {
+        record_frame(pacer, now);
+        return;
+    }
+
+    if (pacer->next_deadline == 0) {
+        pacer->next_deadline = now + pacer->target_frame_seconds;
+    }
+
+    if (now >= pacer->next_deadline) {
+        // Missed; schedule from now rather than rushing the following frames to catch up.
+        pacer->stats.missed_count++;
+        pacer->next_deadline = now + pacer->target_frame_seconds;
+        record_frame(pacer, now);
+        return;
+    }
+
+    // Coarse part: 1ms sleeps while even a pessimistic one fits before the deadline.
+    for (;;) {
+        f64 estimate = pacer->sleep_mean;
+        if (pacer->sleep_count > 1) {
+            estimate += vsqrt(pacer->sleep_m2 / (f64)(pacer->sleep_count - 1));
+        }
+        if (pacer->next_deadline - now <= estimate) {
+            break;
+        }
+        platform_sleep(1);
+        f64 after = platform_get_absolute_time();
+        record_sleep(pacer, after - now);
+        now = after;
+    }
+
+    // Fine part: spin out the remainder.
+    while (now < pacer->next_deadline) {
+        now = platform_get_absolute_time();
+    }
+
+    record_frame(pacer, now);
+    pacer->next_deadline += pacer->target_frame_seconds;
+}
+
+void frame_pacer_log_stats(const frame_pacer* pacer) {
+    const frame_pacer_stats* stats = &pacer->stats;
+    if (pacer->target_frame_seconds <= 0) {
+        INFO("Frame pacer: unlimited, %llu frames.", stats->frame_count);
+        return;
+    }
+    INFO("Frame pacer: target %.3fms, %llu frames, %llu missed, mean error %.3fms, jitter %.3fms, max error %.3fms, sleep estimate %.3fms.",
+         pacer->target_frame_seconds * 1000.0,
+         stats->frame_count,
+         stats->missed_count,
+         stats->mean_error * 1000.0,
+         stats->jitter * 1000.0,
+         stats->max_error * 1000.0,
+         pacer->sleep_mean * 1000.0);
+}
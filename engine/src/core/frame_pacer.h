@@ -0,0 +1,66 @@
+#pragma once
+
+#include "defines.h"
+
+/**
+ * Statistics on how closely frames hit the pacer's target. Errors are the
+ * difference between the actual and the target frame interval, in seconds.
+ */
+typedef struct frame_pacer_stats {
+    u64 frame_count;
+    // Frames that finished their work after the deadline had already passed.
+    u64 missed_count;
+    f64 mean_error;
+    // Standard deviation of the frame interval.
+    f64 jitter;
+    f64 max_error;
+    // Welford accumulator for jitter.
+    f64 m2;
+} frame_pacer_stats;
+
+/**
+ * Limits the frame rate to a target by sleeping for the bulk of the remaining
+ * frame time and spinning for the rest. The sleep margin is calibrated at
+ * runtime from how long the OS actually takes to return from a short sleep.
+ */
+typedef struct frame_pacer {
+    // 0 when unlimited.
+    f64 target_frame_seconds;
+    f64 next_deadline;
+    f64 last_frame_time;
+
+    // Running estimate of the duration of a 1ms sleep.
+    f64 sleep_mean;
+    f64 sleep_m2;
+    u64 sleep_count;
+
+    frame_pacer_stats stats;
+} frame_pacer;
+
+/**
+ * Creates a frame pacer.
+ * @param target_frame_rate The target in frames per second, or 0 for unlimited.
+ * @param out_pacer A pointer to hold the created pacer.
+ */
+API void frame_pacer_create(f32 target_frame_rate, frame_pacer* out_pacer);
+
+/**
+ * Changes the target frame rate. Takes effect on the next frame.
+ * @param pacer A pointer to the pacer.
+ * @param target_frame_rate The target in frames per second, or 0 for unlimited.
+ */
+API void frame_pacer_set_target(frame_pacer* pacer, f32 target_frame_rate);
+
+/**
+ * Blocks until the current frame's deadline, then starts the next frame.
+ * Returns immediately when unlimited or when the deadline was already missed.
+ * @param pacer A pointer to the pacer.
+ */
+API void frame_pacer_wait(frame_pacer* pacer);
+
+API void frame_pacer_reset_stats(frame_pacer* pacer);
+
+/**
+ * Logs the pacer's statistics at info level.
+ */
+API void frame_pacer_log_stats(const frame_pacer* pacer);
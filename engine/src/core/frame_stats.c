@@ -0,0 +1,171 @@
+#include "core/frame_stats.h"
+
+#include "core/logger.h"
+#include "core/vmemory.h"
+#include "core/vstring.h"
+#include "platform/filesystem.h"
+
+static const char* stat_names[FRAME_STAT_COUNT] = {
+    "frame",
+    "cpu",
+    "gpu",
+    "fence_wait",
+    "present"};
+
+static void sort_values(f32* values, u32 count) {
+    // Shell sort with Ciura's gaps; plenty for a ring this size, and needs no scratch memory.
+    static const u32 gaps[] = {701, 301, 132, 57, 23, 10, 4, 1};
+    for (u32 g = 0; g < sizeof(gaps) / sizeof(gaps[0]); ++g) {
+        u32 gap = gaps[g];
+        for (u32 i = gap; i < count; ++i) {
+            f32 value = values[i];
+            u32 j = i;
+            while (j >= gap && values[j - gap] > value) {
+                values[j] = values[j - gap];
+                j -= gap;
+            }
+            values[j] = value;
+        }
+    }
+}
+
+/**
+ * Nearest-rank percentile of sorted values.
+ */
+static f32 percentile(const f32* sorted, u32 count, u32 percent) {
+    u32 rank = (percent * count + 99) / 100;
+    return sorted[rank > 0 ? rank - 1 : 0];
+}
+
+void frame_stats_reset(frame_stats* stats) {
+    stats->frame_count = 0;
+    stats->head = 0;
+    stats->count = 0;
+}
+
+void frame_stats_record(frame_stats* stats, const frame_sample* sample) {
+    if (stats->count < FRAME_STATS_CAPACITY) {
+        stats->samples[(stats->head + stats->count) % FRAME_STATS_CAPACITY] = *sample;
+        stats->count++;
+    } else {
+        stats->samples[stats->head] = *sample;
+        stats->head = (stats->head + 1) % FRAME_STATS_CAPACITY;
+    }
+    stats->frame_count++;
+}
+
+void frame_stats_summarize(const frame_stats* stats, frame_stats_summary* out_summary) {
+    vzero_memory(out_summary, sizeof(frame_stats_summary));
+    u32 count = stats->count;
+    if (count == 0) {
+        return;
+    }
+    out_summary->sample_count = count;
+
+    f32 sorted[FRAME_STATS_CAPACITY];
+    for (u32 s = 0; s < FRAME_STAT_COUNT; ++s) {
+        f64 sum = 0;
+        for (u32 i = 0; i < count; ++i) {
+            sorted[i] = stats->samples[(stats->head + i) % FRAME_STATS_CAPACITY].values[s];
+            sum += sorted[i];
+        }
+        sort_values(sorted, count);
+
+        frame_stat_summary* summary = &out_summary->stats[s];
+        summary->mean = (f32)(sum / count);
+        summary->p50 = percentile(sorted, count, 50);
+        summary->p95 = percentile(sorted, count, 95);
+        summary->p99 = percentile(sorted, count, 99);
+        summary->max = sorted[count - 1];
+    }
+
+    f32 hitch_threshold = out_summary->stats[FRAME_STAT_FRAME].p50 * FRAME_STATS_HITCH_FACTOR;
+    for (u32 i = 0; i < count; ++i) {
+        if (stats->samples[(stats->head + i) % FRAME_STATS_CAPACITY].values[FRAME_STAT_FRAME] > hitch_threshold) {
+            out_summary->hitch_count++;
+        }
+    }
+}
+
+const char* frame_stat_name(frame_stat stat) {
+    return stat < FRAME_STAT_COUNT ? stat_names[stat] : "unknown";
+}
+
+void frame_stats_log(const frame_stats* stats) {
+    frame_stats_summary summary;
+    frame_stats_summarize(stats, &summary);
+    if (summary.sample_count == 0) {
+        INFO("Frame stats: no frames recorded.");
+        return;
+    }
+
+    INFO("Frame stats over the last %u of %llu frames, %u hitches:", summary.sample_count, stats->frame_count, summary.hitch_count);
+    for (u32 s = 0; s < FRAME_STAT_COUNT; ++s) {
+        const frame_stat_summary* stat = &summary.stats[s];
+        INFO("  %-10s mean %7.3fms  p50 %7.3fms  p95 %7.3fms  p99 %7.3fms  max %7.3fms",
+             stat_names[s], stat->mean, stat->p50, stat->p95, stat->p99, stat->max);
+    }
+}
+
+b8 frame_stats_write_csv(const frame_stats* stats, const char* path) {
+    file_handle file;
+    if (!filesystem_open(path, FILE_MODE_WRITE, false, &file)) {
+        ERROR("frame_stats_write_csv - unable to open '%s' for writing.", path);
+        return false;
+    }
+
+    char line[256];
+    u64 length = string_format(line, "frame");
+    for (u32 s = 0; s < FRAME_STAT_COUNT; ++s) {
+        length += string_format(line + length, ",%s_ms", stat_names[s]);
+    }
+    b8 result = filesystem_write_line(&file, line);
+
+    // Numbered from the start of recording, so rows from separate dumps line up.
+    u64 first_frame = stats->frame_count - stats->count;
+    for (u32 i = 0; result && i < stats->count; ++i) {
+        const frame_sample* sample = &stats->samples[(stats->head + i) % FRAME_STATS_CAPACITY];
+        length = string_format(line, "%llu", first_frame + i);
+        for (u32 s = 0; s < FRAME_STAT_COUNT; ++s) {
+            length += string_format(line + length, ",%.4f", sample->values[s]);
+        }
+        result = filesystem_write_line(&file, line);
+    }
+    filesystem_close(&file);
+
+    if (!result) {
+        ERROR("frame_stats_write_csv - failed writing '%s'.", path);
+    }
+    return result;
+}
+
+b8 frame_stats_write_json(const frame_stats* stats, const char* path) {
+    file_handle file;
+    if (!filesystem_open(path, FILE_MODE_WRITE, false, &file)) {
+        ERROR("frame_stats_write_json - unable to open '%s' for writing.", path);
+        return false;
+    }
+
+    frame_stats_summary summary;
+    frame_stats_summarize(stats, &summary);
+
+    char line[256];
+    b8 result = filesystem_write_line(&file, "{");
+    string_format(line, "  \"frame_count\": %llu,\n  \"sample_count\": %u,\n  \"hitch_count\": %u,\n  \"hitch_factor\": %.2f,",
+                  stats->frame_count, summary.sample_count, summary.hitch_count, FRAME_STATS_HITCH_FACTOR);
+    result = result && filesystem_write_line(&file, line);
+    for (u32 s = 0; result && s < FRAME_STAT_COUNT; ++s) {
+        const frame_stat_summary* stat = &summary.stats[s];
+        string_format(line, "  \"%s_ms\": {\"mean\": %.4f, \"p50\": %.4f, \"p95\": %.4f, \"p99\": %.4f, \"max\": %.4f}%s",
+                      stat_names[s], stat->mean, stat->p50, stat->p95, stat->p99, stat->max,
+                      s + 1 < FRAME_STAT_COUNT ? "," : "");
+        result = filesystem_write_line(&file, line);
+    }
+    result = result && filesystem_write_line(&file, "}");
+    filesystem_close(&file);
+
+    if (!result) {
+        ERROR("frame_stats_write_json - failed writing '%s'.", path);
+    }
+    return result;
+}
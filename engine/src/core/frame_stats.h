@@ -0,0 +1,105 @@
+#pragma once
+
+#include "defines.h"
+
+/*
+ * Keeps the timings of the most recent frames in a ring and summarizes them as
+ * percentiles, which show stutter far better than an average frame time does.
+ * All times are in milliseconds.
+ */
+
+// Frames kept; at 60Hz, about 17 seconds.
+#define FRAME_STATS_CAPACITY 1024
+
+// A frame is a hitch when it takes this many times the median frame time.
+#define FRAME_STATS_HITCH_FACTOR 2.0f
+
+typedef enum frame_stat {
+    // Interval between the starts of consecutive frames.
+    FRAME_STAT_FRAME,
+    // Main thread time spent on the frame, excluding frame pacing.
+    FRAME_STAT_CPU,
+    // GPU time of the frame's command buffer; 0 when the GPU can't be timed.
+    FRAME_STAT_GPU,
+    // Time the renderer blocked on fences for a frame in flight to finish.
+    FRAME_STAT_FENCE_WAIT,
+    // Time spent handing the image to the swapchain.
+    FRAME_STAT_PRESENT,
+    FRAME_STAT_COUNT
+} frame_stat;
+
+typedef struct frame_sample {
+    f32 values[FRAME_STAT_COUNT];
+} frame_sample;
+
+typedef struct frame_stat_summary {
+    f32 mean;
+    f32 p50;
+    f32 p95;
+    f32 p99;
+    f32 max;
+} frame_stat_summary;
+
+typedef struct frame_stats_summary {
+    // Frames summarized; at most FRAME_STATS_CAPACITY.
+    u32 sample_count;
+    // Frames whose frame time exceeds FRAME_STATS_HITCH_FACTOR times the median.
+    u32 hitch_count;
+    frame_stat_summary stats[FRAME_STAT_COUNT];
+} frame_stats_summary;
+
+typedef struct frame_stats {
+    // Frames recorded since the last reset, including those overwritten.
+    u64 frame_count;
+    // Index of the oldest sample.
+    u32 head;
+    u32 count;
+    frame_sample samples[FRAME_STATS_CAPACITY];
+} frame_stats;
+
+/**
+ * Clears all recorded frames.
+ * @param stats A pointer to the stats.
+ */
+API void frame_stats_reset(frame_stats* stats);
+
+/**
+ * Records a frame, overwriting the oldest once the ring is full.
+ * @param stats A pointer to the stats.
+ * @param sample The frame's timings.
+ */
+API void frame_stats_record(frame_stats* stats, const frame_sample* sample);
+
+/**
+ * Summarizes the frames in the ring.
+ * @param stats A pointer to the stats.
+ * @param out_summary A pointer to hold the summary. Zeroed if no frames were recorded.
+ */
+API void frame_stats_summarize(const frame_stats* stats, frame_stats_summary* out_summary);
+
+/**
+ * @param stat The stat.
+ * @returns The stat's name, as used in logs and exported files.
+ */
+API const char* frame_stat_name(frame_stat stat);
+
+/**
+ * Logs the summary at info level.
+ */
+API void frame_stats_log(const frame_stats* stats);
+
+/**
+ * Writes the frames in the ring as CSV, one row per frame, oldest first.
+ * @param stats A pointer to the stats.
+ * @param path The path of the file to write.
+ * @returns True on success; otherwise false.
+ */
+API b8 frame_stats_write_csv(const frame_stats* stats, const char* path);
+
+/**
+ * Writes the summary as JSON.
+ * @param stats A pointer to the stats.
+ * @param path The path of the file to write.
+ * @returns True on success; otherwise false.
+ */
+API b8 frame_stats_write_json(const frame_stats* stats, const char* path);
@@ -1,26 +1,166 @@
 #include "core/input.h"
 #include "core/event.h"
 #include "core/vmemory.h"
+#include "core/profiler.h"
 #include "core/logger.h"
+#include "core/timer.h"
+#include "core/vstring.h"
+#include "containers/darray.h"
+#include "platform/platform.h"
+#include "platform/filesystem.h"
+
+// One bit per key code, so chords can be tested against the whole keyboard with a few masks.
+#define KEYBOARD_STATE_WORDS (256 / 64)
 
 typedef struct keyboard_state {
-    b8 keys[256];
+    u64 keys[KEYBOARD_STATE_WORDS];
 } keyboard_state;
 
 typedef struct mouse_state {
-    b8 buttons[BUTTON_MAX_BUTTONS];
+    // One bit per button, see INPUT_BUTTON_MASK.
+    u32 buttons;
     i16 x, y;
 } mouse_state;
 
+#define KEY_WORD(key) ((u32)(key) >> 6)
+#define KEY_BIT(key) (1ULL << ((u32)(key) & 63))
+
+/**
+ * A set of keys and buttons which must all be held at once for the binding
+ * to be active.
+ */
+typedef struct input_chord {
+    u64 keys[KEYBOARD_STATE_WORDS];
+    u32 buttons;
+} input_chord;
+
+#define INPUT_ACTION_NAME_MAX_LENGTH 32
+
+typedef struct input_action_entry {
+    char name[INPUT_ACTION_NAME_MAX_LENGTH];
+    u32 chord_count;
+    input_chord chords[INPUT_MAX_ACTION_BINDINGS];
+} input_action_entry;
+
+typedef struct input_action_map {
+    u32 action_count;
+    input_action_entry actions[INPUT_MAX_ACTIONS];
+    // One bit per action, written once per frame by input_update_actions.
+    u64 held;
+    u64 pressed;
+    u64 released;
+} input_action_map;
+
+typedef enum input_record_type {
+    INPUT_RECORD_KEY,
+    INPUT_RECORD_BUTTON,
+    INPUT_RECORD_MOUSE_MOVE,
+    INPUT_RECORD_MOUSE_WHEEL,
+    // Written when recording stops so replays also cover trailing frames without input.
+    INPUT_RECORD_END,
+    // Written once per frame after the game updates, so a replay updates exactly as live play did.
+    INPUT_RECORD_FRAME
+} input_record_type;
+
+/**
+ * One input_process_* call as stored in a recording. For keys and buttons
+ * code is the key/button and x is pressed; for the wheel x is z_delta. For
+ * frames, code is the number of game updates run.
+ */
+typedef struct input_record {
+    u32 frame;
+    u8 type;
+    u8 reserved;
+    u16 code;
+    i16 x;
+    i16 y;
+    // Frames only: the delta time passed to each game update.
+    f32 delta_time;
+    // Seconds since the recording started. Frames: the application time timers were advanced to.
+    f64 time;
+} input_record;
+
+#define INPUT_RECORDING_MAGIC 0x52494756 // 'VGIR'
+#define INPUT_RECORDING_VERSION 3
+
+typedef struct input_recording_header {
+    u32 magic;
+    u16 version;
+    u16 record_size;
+} input_recording_header;
+
+// Records buffered in memory before being written out.
+#define INPUT_RECORD_FLUSH_COUNT 4096
+
+typedef struct input_recorder {
+    b8 active;
+    // Recording starts and stops at the end of a frame, so it holds whole frames only.
+    b8 starting;
+    b8 stopping;
+    file_handle file;
+    input_record* pending;
+    f64 start_time;
+    u32 start_frame;
+    u64 record_count;
+} input_recorder;
+
+typedef struct input_replayer {
+    b8 active;
+    // Replay starts at the end of a frame, so the first replayed frame is a whole one.
+    b8 starting;
+    b8 quit_when_done;
+    // Set once all records were fed; the replay ends at the start of the next frame
+    // so the game still sees the final frame as part of the replay.
+    b8 finished;
+    u8* data;
+    u64 data_size;
+    input_record* records;
+    u64 record_count;
+    u64 cursor;
+    u32 frame;
+
+    // The current frame's INPUT_RECORD_FRAME, if it has one.
+    b8 has_frame;
+    u32 frame_update_count;
+    f32 frame_delta_time;
+    f64 frame_time;
+    // Added to recorded times: whole timer ticks, so timers expire on the same frames as when recorded.
+    b8 time_offset_set;
+    f64 time_offset;
+} input_replayer;
+
+// Must be a power of 2. Events beyond this in a single frame overwrite the oldest.
+#define INPUT_EVENT_BUFFER_SIZE 512
+
+typedef struct input_event_buffer {
+    input_event events[INPUT_EVENT_BUFFER_SIZE];
+    // Monotonic counters, masked when indexing.
+    u32 head;
+    u32 frame_start;
+    b8 overflow_warned;
+} input_event_buffer;
+
 typedef struct input_state {
     keyboard_state keyboard_current;
     keyboard_state keyboard_previous;
     mouse_state mouse_current;
     mouse_state mouse_previous;
+
+    // Incremented by input_update, i.e. once per frame.
+    u32 frame;
+    input_event_buffer event_buffer;
+    input_action_map action_map;
+    input_recorder recorder;
+    input_replayer replayer;
 } input_state;
 
 static input_state* state_ptr;
 
+static void flush_recording();
+static void finish_recording();
+static void activate_recording();
+static void activate_replay();
+
 void input_system_initialize(u64* memory_requirement, void* state) {
     *memory_requirement = sizeof(input_state);
     if (state == 0) {
@@ -28,85 +168,469 @@ void input_system_initialize(u64* memory_requirement, void* state) {
     }
     vzero_memory(state, sizeof(input_state));
     state_ptr = state;
+
+    // OS messages can arrive many times per frame; listeners only need one of these per frame.
+    event_set_coalesce_policy(EVENT_CODE_MOUSE_MOVED, EVENT_COALESCE_KEEP_LATEST);
+    event_set_coalesce_policy(EVENT_CODE_MOUSE_WHEEL, EVENT_COALESCE_ACCUMULATE);
 }
 
 void input_system_shutdown(void* state) {
+    if (state_ptr) {
+        // Can't wait for the end of the frame.
+        if (state_ptr->recorder.active || state_ptr->recorder.starting) {
+            finish_recording();
+        }
+        input_replay_stop();
+    }
     state_ptr = 0;
 }
 
-void input_update() {
+void input_update(f64 delta_time) {
+    PROFILE_SCOPE("input_update");
     if (!state_ptr) {
         return;
     }
 
     vcopy_memory(&state_ptr->keyboard_previous, &state_ptr->keyboard_current, sizeof(keyboard_state));
     vcopy_memory(&state_ptr->mouse_previous, &state_ptr->mouse_current, sizeof(mouse_state));
+
+    // Start a new frame's worth of raw events.
+    state_ptr->event_buffer.frame_start = state_ptr->event_buffer.head;
+
+    // The end marker belongs to the frame just finished.
+    if (state_ptr->recorder.stopping) {
+        finish_recording();
+    }
+
+    state_ptr->frame++;
+    if (state_ptr->replayer.active) {
+        state_ptr->replayer.frame++;
+    }
+
+    if (state_ptr->recorder.starting) {
+        activate_recording();
+    }
+    if (state_ptr->replayer.starting) {
+        activate_replay();
+    }
+    if (state_ptr->recorder.active && darray_length(state_ptr->recorder.pending) >= INPUT_RECORD_FLUSH_COUNT) {
+        flush_recording();
+    }
 }
 
+static void record(input_record_type type, u16 code, i16 x, i16 y) {
+    input_recorder* recorder = &state_ptr->recorder;
+    input_record r = {};
+    r.frame = state_ptr->frame - recorder->start_frame;
+    r.time = platform_get_absolute_time() - recorder->start_time;
+    r.type = (u8)type;
+    r.code = code;
+    r.x = x;
+    r.y = y;
+    darray_push(recorder->pending, r);
+}
 
-void input_process_key(keys key, b8 pressed) {
+static input_event* push_event(input_event_type type) {
+    input_event_buffer* buffer = &state_ptr->event_buffer;
+    if (buffer->head - buffer->frame_start >= INPUT_EVENT_BUFFER_SIZE) {
+        // Drop the oldest event of this frame.
+        buffer->frame_start++;
+        if (!buffer->overflow_warned) {
+            WARN("Input event buffer overflow; more than %u input events in one frame.", INPUT_EVENT_BUFFER_SIZE);
+            buffer->overflow_warned = true;
+        }
+    }
+    input_event* e = &buffer->events[buffer->head & (INPUT_EVENT_BUFFER_SIZE - 1)];
+    buffer->head++;
+    vzero_memory(e, sizeof(input_event));
+    e->timestamp = platform_get_absolute_time();
+    e->type = type;
+    return e;
+}
+
+static void process_key(keys key, b8 pressed) {
     // if keyboard state changes, fire event
-    if (state_ptr->keyboard_current.keys[key] != pressed) {
-        state_ptr->keyboard_current.keys[key] = pressed;
+    u64* word = &state_ptr->keyboard_current.keys[KEY_WORD(key)];
+    if (((*word & KEY_BIT(key)) != 0) != pressed) {
+        if (pressed) {
+            *word |= KEY_BIT(key);
+        } else {
+            *word &= ~KEY_BIT(key);
+        }
+
+        input_event* e = push_event(INPUT_EVENT_KEY);
+        e->code = key;
+        e->pressed = pressed;
 
         event_context context;
         context.data.u16[0] = key;
-        event_fire(pressed ? EVENT_CODE_KEY_PRESSED : EVENT_CODE_KEY_RELEASED, 0, context);
+        event_post(pressed ? EVENT_CODE_KEY_PRESSED : EVENT_CODE_KEY_RELEASED, 0, context);
     }
 }
 
-void input_process_button(buttons button, b8 pressed) {
-    if (state_ptr->mouse_current.buttons[button] != pressed) {
-        state_ptr->mouse_current.buttons[button] = pressed;
+static void process_button(buttons button, b8 pressed) {
+    u32 bit = INPUT_BUTTON_MASK(button);
+    if (((state_ptr->mouse_current.buttons & bit) != 0) != pressed) {
+        if (pressed) {
+            state_ptr->mouse_current.buttons |= bit;
+        } else {
+            state_ptr->mouse_current.buttons &= ~bit;
+        }
+
+        input_event* e = push_event(INPUT_EVENT_BUTTON);
+        e->code = button;
+        e->pressed = pressed;
 
         event_context context;
         context.data.u16[0] = button;
-        event_fire(pressed ? EVENT_CODE_BUTTON_PRESSED : EVENT_CODE_BUTTON_RELEASED, 0, context);
+        event_post(pressed ? EVENT_CODE_BUTTON_PRESSED : EVENT_CODE_BUTTON_RELEASED, 0, context);
     }
 }
-void input_process_mouse_move(i16 x, i16 y) {
+
+static void process_mouse_move(i16 x, i16 y) {
     if (state_ptr->mouse_current.x != x ||state_ptr->mouse_current.y != y) {
         state_ptr->mouse_current.x = x;
         state_ptr->mouse_current.y = y;
+
+        input_event* e = push_event(INPUT_EVENT_MOUSE_MOVE);
+        e->x = x;
+        e->y = y;
         
         event_context context;
         context.data.u16[0] = x;
         context.data.u16[1] = y;
-        event_fire(EVENT_CODE_MOUSE_MOVED, 0, context);
+        event_post(EVENT_CODE_MOUSE_MOVED, 0, context);
+    }
+}
+
+static void process_mouse_wheel(i32 z) {
+    input_event* e = push_event(INPUT_EVENT_MOUSE_WHEEL);
+    e->z_delta = z;
+
+    event_context context = {};
+    context.data.i32[0] = z;
+    event_post(EVENT_CODE_MOUSE_WHEEL, 0, context);
+}
+
+// Live input from the platform layer is recorded when recording, and ignored while replaying.
+
+void input_process_key(keys key, b8 pressed) {
+    if (state_ptr->replayer.active) {
+        return;
+    }
+    if (state_ptr->recorder.active) {
+        record(INPUT_RECORD_KEY, key, pressed, 0);
+    }
+    process_key(key, pressed);
+}
+
+void input_process_button(buttons button, b8 pressed) {
+    if (state_ptr->replayer.active) {
+        return;
     }
+    if (state_ptr->recorder.active) {
+        record(INPUT_RECORD_BUTTON, button, pressed, 0);
+    }
+    process_button(button, pressed);
 }
+
+void input_process_mouse_move(i16 x, i16 y) {
+    if (state_ptr->replayer.active) {
+        return;
+    }
+    if (state_ptr->recorder.active) {
+        record(INPUT_RECORD_MOUSE_MOVE, 0, x, y);
+    }
+    process_mouse_move(x, y);
+}
+
 void input_process_mouse_wheel(i32 z) {
-    event_context context;
-    context.data.u8[0] = z;
-    event_fire(EVENT_CODE_MOUSE_WHEEL, 0, context);
+    if (state_ptr->replayer.active) {
+        return;
+    }
+    if (state_ptr->recorder.active) {
+        record(INPUT_RECORD_MOUSE_WHEEL, 0, (i16)z, 0);
+    }
+    process_mouse_wheel(z);
+}
+
+// RECORDING //
+static void flush_recording() {
+    input_recorder* recorder = &state_ptr->recorder;
+    u64 count = darray_length(recorder->pending);
+    if (count == 0) {
+        return;
+    }
+    u64 written = 0;
+    if (!filesystem_write(&recorder->file, count * sizeof(input_record), recorder->pending, &written)) {
+        ERROR("Failed to write input recording.");
+    }
+    recorder->record_count += count;
+    darray_clear(recorder->pending);
+}
+
+b8 input_recording_start(const char* path) {
+    if (!state_ptr || input_is_recording() || state_ptr->recorder.active || input_is_replaying()) {
+        return false;
+    }
+
+    input_recorder* recorder = &state_ptr->recorder;
+    if (!filesystem_open(path, FILE_MODE_WRITE, true, &recorder->file)) {
+        return false;
+    }
+
+    input_recording_header header = {};
+    header.magic = INPUT_RECORDING_MAGIC;
+    header.version = INPUT_RECORDING_VERSION;
+    header.record_size = sizeof(input_record);
+    u64 written = 0;
+    if (!filesystem_write(&recorder->file, sizeof(header), &header, &written)) {
+        ERROR("Failed to write input recording header to '%s'.", path);
+        filesystem_close(&recorder->file);
+        return false;
+    }
+
+    recorder->pending = darray_reserve(input_record, INPUT_RECORD_FLUSH_COUNT);
+    recorder->record_count = 0;
+    recorder->starting = true;
+    INFO("Input recording starts next frame: '%s'.", path);
+    return true;
+}
+
+static void activate_recording() {
+    input_recorder* recorder = &state_ptr->recorder;
+    recorder->starting = false;
+    recorder->active = true;
+    recorder->start_time = platform_get_absolute_time();
+    recorder->start_frame = state_ptr->frame;
+}
+
+static void finish_recording() {
+    input_recorder* recorder = &state_ptr->recorder;
+    if (recorder->active) {
+        record(INPUT_RECORD_END, 0, 0, 0);
+    }
+    flush_recording();
+    filesystem_close(&recorder->file);
+    darray_destroy(recorder->pending);
+    recorder->pending = 0;
+    b8 was_active = recorder->active;
+    recorder->active = false;
+    recorder->starting = false;
+    recorder->stopping = false;
+    if (was_active) {
+        INFO("Input recording stopped: %llu events over %u frames.", recorder->record_count, state_ptr->frame - recorder->start_frame + 1);
+    }
+}
+
+void input_recording_stop() {
+    if (!state_ptr) {
+        return;
+    }
+    input_recorder* recorder = &state_ptr->recorder;
+    if (recorder->starting) {
+        // Nothing recorded yet.
+        finish_recording();
+    } else if (recorder->active) {
+        recorder->stopping = true;
+    }
+}
+
+b8 input_is_recording() {
+    return state_ptr && (state_ptr->recorder.starting || (state_ptr->recorder.active && !state_ptr->recorder.stopping));
+}
+
+void input_recording_frame(u32 update_count, f32 update_delta_time, f64 time) {
+    if (!state_ptr || !state_ptr->recorder.active) {
+        return;
+    }
+    input_recorder* recorder = &state_ptr->recorder;
+    input_record r = {};
+    r.frame = state_ptr->frame - recorder->start_frame;
+    r.type = INPUT_RECORD_FRAME;
+    r.code = (u16)update_count;
+    r.delta_time = update_delta_time;
+    r.time = time;
+    darray_push(recorder->pending, r);
+}
+
+// REPLAY //
+b8 input_replay_start(const char* path, b8 quit_when_done) {
+    if (!state_ptr || state_ptr->recorder.active || state_ptr->recorder.starting || input_is_replaying()) {
+        return false;
+    }
+
+    file_handle file;
+    if (!filesystem_open(path, FILE_MODE_READ, true, &file)) {
+        return false;
+    }
+    input_replayer* replayer = &state_ptr->replayer;
+    b8 read = filesystem_read_all_bytes(&file, &replayer->data, &replayer->data_size);
+    filesystem_close(&file);
+    if (!read) {
+        ERROR("Failed to read input recording '%s'.", path);
+        if (replayer->data) {
+            vfree(replayer->data, replayer->data_size, MEMORY_TAG_STRING);
+        }
+        replayer->data = 0;
+        replayer->data_size = 0;
+        return false;
+    }
+
+    input_recording_header* header = (input_recording_header*)replayer->data;
+    if (replayer->data_size < sizeof(input_recording_header) ||
+        header->magic != INPUT_RECORDING_MAGIC ||
+        header->version != INPUT_RECORDING_VERSION ||
+        header->record_size != sizeof(input_record)) {
+        ERROR("'%s' is not a valid input recording.", path);
+        vfree(replayer->data, replayer->data_size, MEMORY_TAG_STRING);
+        replayer->data = 0;
+        replayer->data_size = 0;
+        return false;
+    }
+
+    replayer->records = (input_record*)(replayer->data + sizeof(input_recording_header));
+    replayer->record_count = (replayer->data_size - sizeof(input_recording_header)) / sizeof(input_record);
+    replayer->quit_when_done = quit_when_done;
+    replayer->starting = true;
+    INFO("Input replay starts next frame: '%s' (%llu events).", path, replayer->record_count);
+    return true;
+}
+
+static void activate_replay() {
+    input_replayer* replayer = &state_ptr->replayer;
+    replayer->starting = false;
+    replayer->active = true;
+    replayer->cursor = 0;
+    replayer->frame = 0;
+    replayer->finished = false;
+    replayer->has_frame = false;
+    replayer->time_offset_set = false;
+
+    // Start from a clean slate so the replay sees the same state the recording did.
+    vzero_memory(&state_ptr->keyboard_current, sizeof(keyboard_state));
+    vzero_memory(&state_ptr->keyboard_previous, sizeof(keyboard_state));
+    vzero_memory(&state_ptr->mouse_current, sizeof(mouse_state));
+    vzero_memory(&state_ptr->mouse_previous, sizeof(mouse_state));
+}
+
+void input_replay_stop() {
+    if (!state_ptr || !input_is_replaying()) {
+        return;
+    }
+    input_replayer* replayer = &state_ptr->replayer;
+    vfree(replayer->data, replayer->data_size, MEMORY_TAG_STRING);
+    replayer->data = 0;
+    replayer->data_size = 0;
+    replayer->records = 0;
+    replayer->active = false;
+    replayer->starting = false;
+    replayer->has_frame = false;
+}
+
+b8 input_is_replaying() {
+    return state_ptr && (state_ptr->replayer.active || state_ptr->replayer.starting);
+}
+
+b8 input_replay_frame(u32* out_update_count, f32* out_update_delta_time, f64* out_time) {
+    if (!state_ptr || !state_ptr->replayer.active || !state_ptr->replayer.has_frame) {
+        return false;
+    }
+    input_replayer* replayer = &state_ptr->replayer;
+    if (!replayer->time_offset_set) {
+        // The fewest whole ticks that put the first replayed frame after the last time the timers saw.
+        f64 ticks = (timer_system_time() - replayer->frame_time) / TIMER_TICK_SECONDS;
+        i64 whole = (i64)ticks;
+        if ((f64)whole > ticks) {
+            whole--;
+        }
+        replayer->time_offset = (f64)(whole + 1) * TIMER_TICK_SECONDS;
+        replayer->time_offset_set = true;
+    }
+    *out_update_count = replayer->frame_update_count;
+    *out_update_delta_time = replayer->frame_delta_time;
+    *out_time = replayer->frame_time + replayer->time_offset;
+    return true;
+}
+
+void input_replay_update() {
+    if (!state_ptr || !state_ptr->replayer.active) {
+        return;
+    }
+
+    input_replayer* replayer = &state_ptr->replayer;
+    replayer->has_frame = false;
+    if (replayer->finished) {
+        INFO("Input replay finished after %u frames.", replayer->frame);
+        b8 quit = replayer->quit_when_done;
+        input_replay_stop();
+        if (quit) {
+            event_context data = {};
+            event_post(EVENT_CODE_APPLICATION_QUIT, 0, data);
+        }
+        return;
+    }
+
+    while (replayer->cursor < replayer->record_count && replayer->records[replayer->cursor].frame <= replayer->frame) {
+        input_record r = replayer->records[replayer->cursor++];
+        switch (r.type) {
+            case INPUT_RECORD_END:
+                replayer->finished = true;
+                break;
+            case INPUT_RECORD_KEY:
+                process_key((keys)r.code, (b8)r.x);
+                break;
+            case INPUT_RECORD_BUTTON:
+                process_button((buttons)r.code, (b8)r.x);
+                break;
+            case INPUT_RECORD_MOUSE_MOVE:
+                process_mouse_move(r.x, r.y);
+                break;
+            case INPUT_RECORD_MOUSE_WHEEL:
+                process_mouse_wheel(r.x);
+                break;
+            case INPUT_RECORD_FRAME:
+                replayer->has_frame = true;
+                replayer->frame_update_count = r.code;
+                replayer->frame_delta_time = r.delta_time;
+                replayer->frame_time = r.time;
+                break;
+        }
+    }
+
+    // Recordings cut short (e.g. by a crash) have no end marker; finish when the data runs out.
+    if (replayer->cursor >= replayer->record_count) {
+        replayer->finished = true;
+    }
 }
+
 // KEY INPUTS //
 b8 input_key_down(keys key) {
     if (!state_ptr) {
         return false;
     }
-    return state_ptr->keyboard_current.keys[key] == true;
+    return (state_ptr->keyboard_current.keys[KEY_WORD(key)] & KEY_BIT(key)) != 0;
 }
 
 b8 input_key_up(keys key) {
     if (!state_ptr) {
         return false;
     }
-    return state_ptr->keyboard_current.keys[key] == false;
+    return (state_ptr->keyboard_current.keys[KEY_WORD(key)] & KEY_BIT(key)) == 0;
 }
 
 b8 input_was_key_down(keys key) {
     if (!state_ptr) {
         return false;
     }
-    return state_ptr->keyboard_previous.keys[key] == true;
+    return (state_ptr->keyboard_previous.keys[KEY_WORD(key)] & KEY_BIT(key)) != 0;
 }
 
 b8 input_was_key_up(keys key) {
     if (!state_ptr) {
         return false;
     }
-    return state_ptr->keyboard_previous.keys[key] == false;
+    return (state_ptr->keyboard_previous.keys[KEY_WORD(key)] & KEY_BIT(key)) == 0;
 }
 
 // MOUSE INPUTS //
@@ -114,28 +638,28 @@ b8 input_button_down(buttons button) {
     if (!state_ptr) {
         return false;
     }
-    return state_ptr->mouse_current.buttons[button] == true;
+    return (state_ptr->mouse_current.buttons & INPUT_BUTTON_MASK(button)) != 0;
 }
 
 b8 input_button_up(buttons button) {
     if (!state_ptr) {
         return false;
     }
-    return state_ptr->mouse_current.buttons[button] == false;
+    return (state_ptr->mouse_current.buttons & INPUT_BUTTON_MASK(button)) == 0;
 }
 
 b8 input_was_button_down(buttons button) {
     if (!state_ptr) {
         return false;
     }
-    return state_ptr->mouse_previous.buttons[button] == true;
+    return (state_ptr->mouse_previous.buttons & INPUT_BUTTON_MASK(button)) != 0;
 }
 
 b8 input_was_button_up(buttons button) {
     if (!state_ptr) {
         return false;
     }
-    return state_ptr->mouse_previous.buttons[button] == false;
+    return (state_ptr->mouse_previous.buttons & INPUT_BUTTON_MASK(button)) == 0;
 }
 
 void input_get_mouse_pos(i32* x, i32* y) {
@@ -157,3 +681,131 @@ void input_get_prev_mouse_pos(i32* x, i32* y){
     *x = state_ptr->mouse_previous.x;
     *y = state_ptr->mouse_previous.y;
 }
+
+u32 input_event_count() {
+    if (!state_ptr) {
+        return 0;
+    }
+    return state_ptr->event_buffer.head - state_ptr->event_buffer.frame_start;
+}
+
+const input_event* input_event_get(u32 index) {
+    if (!state_ptr || index >= input_event_count()) {
+        return 0;
+    }
+    input_event_buffer* buffer = &state_ptr->event_buffer;
+    return &buffer->events[(buffer->frame_start + index) & (INPUT_EVENT_BUFFER_SIZE - 1)];
+}
+
+// ACTIONS //
+u32 input_action_get(const char* name) {
+    if (!state_ptr || !name) {
+        return INVALID_ID;
+    }
+    input_action_map* map = &state_ptr->action_map;
+    for (u32 i = 0; i < map->action_count; ++i) {
+        if (strings_equal(map->actions[i].name, name)) {
+            return i;
+        }
+    }
+    return INVALID_ID;
+}
+
+u32 input_action_bind(const char* name, u32 key_count, const keys* chord_keys, u32 button_mask) {
+    if (!state_ptr || !name) {
+        return INVALID_ID;
+    }
+    if (key_count == 0 && button_mask == 0) {
+        WARN("input_action_bind - empty chord for action '%s' ignored.", name);
+        return INVALID_ID;
+    }
+
+    input_action_map* map = &state_ptr->action_map;
+    u32 action = input_action_get(name);
+    if (action == INVALID_ID) {
+        u64 length = string_length(name);
+        if (length >= INPUT_ACTION_NAME_MAX_LENGTH) {
+            ERROR("input_action_bind - action name '%s' is too long (max %u characters).", name, INPUT_ACTION_NAME_MAX_LENGTH - 1);
+            return INVALID_ID;
+        }
+        if (map->action_count == INPUT_MAX_ACTIONS) {
+            ERROR("input_action_bind - out of actions (max %u).", INPUT_MAX_ACTIONS);
+            return INVALID_ID;
+        }
+        action = map->action_count++;
+        vzero_memory(&map->actions[action], sizeof(input_action_entry));
+        vcopy_memory(map->actions[action].name, name, length + 1);
+    }
+
+    input_action_entry* entry = &map->actions[action];
+    if (entry->chord_count == INPUT_MAX_ACTION_BINDINGS) {
+        ERROR("input_action_bind - action '%s' already has %u bindings.", name, INPUT_MAX_ACTION_BINDINGS);
+        return INVALID_ID;
+    }
+    input_chord* chord = &entry->chords[entry->chord_count++];
+    vzero_memory(chord, sizeof(input_chord));
+    for (u32 i = 0; i < key_count; ++i) {
+        chord->keys[KEY_WORD(chord_keys[i])] |= KEY_BIT(chord_keys[i]);
+    }
+    chord->buttons = button_mask;
+    return action;
+}
+
+void input_action_unbind_all(u32 action) {
+    if (!state_ptr || action >= state_ptr->action_map.action_count) {
+        return;
+    }
+    state_ptr->action_map.actions[action].chord_count = 0;
+}
+
+void input_update_actions() {
+    if (!state_ptr) {
+        return;
+    }
+
+    input_action_map* map = &state_ptr->action_map;
+    const keyboard_state* keyboard = &state_ptr->keyboard_current;
+    u32 mouse_buttons = state_ptr->mouse_current.buttons;
+
+    u64 held = 0;
+    for (u32 a = 0; a < map->action_count; ++a) {
+        const input_action_entry* entry = &map->actions[a];
+        for (u32 c = 0; c < entry->chord_count; ++c) {
+            const input_chord* chord = &entry->chords[c];
+            u64 missing = (chord->keys[0] & ~keyboard->keys[0]) |
+                          (chord->keys[1] & ~keyboard->keys[1]) |
+                          (chord->keys[2] & ~keyboard->keys[2]) |
+                          (chord->keys[3] & ~keyboard->keys[3]) |
+                          (chord->buttons & ~mouse_buttons);
+            if (!missing) {
+                held |= 1ULL << a;
+                break;
+            }
+        }
+    }
+
+    map->pressed = held & ~map->held;
+    map->released = map->held & ~held;
+    map->held = held;
+}
+
+b8 input_action_held(u32 action) {
+    if (!state_ptr || action >= INPUT_MAX_ACTIONS) {
+        return false;
+    }
+    return (state_ptr->action_map.held >> action) & 1;
+}
+
+b8 input_action_pressed(u32 action) {
+    if (!state_ptr || action >= INPUT_MAX_ACTIONS) {
+        return false;
+    }
+    return (state_ptr->action_map.pressed >> action) & 1;
+}
+
+b8 input_action_released(u32 action) {
+    if (!state_ptr || action >= INPUT_MAX_ACTIONS) {
+        return false;
+    }
+    return (state_ptr->action_map.released >> action) & 1;
+}
@@ -9,6 +9,9 @@ typedef enum buttons {
     BUTTON_MAX_BUTTONS
 } buttons;
 
+/** @brief The bit for the given button in a button mask, as taken by input_action_bind. */
+#define INPUT_BUTTON_MASK(button) (1u << (button))
+
 #define DEFINE_KEY(name, code) KEY_##name = code
 
 typedef enum keys {
@@ -142,16 +145,42 @@ typedef enum keys {
     KEYS_MAX_KEYS
 } keys;
 
-void input_system_initialize(u64* memory_requirement, void* state);
-void input_system_shutdown(void* state);
-void input_update(f64 delta_time);
+typedef enum input_event_type {
+    INPUT_EVENT_KEY,
+    INPUT_EVENT_BUTTON,
+    INPUT_EVENT_MOUSE_MOVE,
+    INPUT_EVENT_MOUSE_WHEEL
+} input_event_type;
+
+/**
+ * A single raw input change, stamped with platform_get_absolute_time when it
+ * was received. Preserves what the per-frame state collapses, such as a press
+ * and release inside one frame or the path the mouse took between frames.
+ */
+typedef struct input_event {
+    f64 timestamp;
+    input_event_type type;
+    // The key (INPUT_EVENT_KEY) or button (INPUT_EVENT_BUTTON).
+    u16 code;
+    // For keys and buttons.
+    b8 pressed;
+    // For mouse moves.
+    i16 x;
+    i16 y;
+    // For the mouse wheel.
+    i32 z_delta;
+} input_event;
+
+API void input_system_initialize(u64* memory_requirement, void* state);
+API void input_system_shutdown(void* state);
+API void input_update(f64 delta_time);
 
 API b8 input_key_down(keys key);
 API b8 input_key_up(keys key);
 API b8 input_was_key_down(keys key);
 API b8 input_was_key_up(keys key);
 
-void input_process_key(keys key, b8 pressed);
+API void input_process_key(keys key, b8 pressed);
 
 API b8 input_button_down(buttons button);
 API b8 input_button_up(buttons button);
@@ -160,6 +189,127 @@ API b8 input_was_button_up(buttons button);
 API void input_get_mouse_pos(i32* x, i32* y);
 API void input_get_prev_mouse_pos(i32* x, i32* y);
 
-void input_process_button(buttons button, b8 pressed);
+/**
+ * @returns The number of raw input events received this frame.
+ */
+API u32 input_event_count();
+
+/**
+ * Gets a raw input event received this frame, in the order received. Events
+ * are available until the end of the frame (input_update).
+ * @param index The index of the event, from 0 to input_event_count() - 1.
+ * @returns A pointer to the event, or 0 if index is out of range.
+ */
+API const input_event* input_event_get(u32 index);
+
+// Actions are stored as one bit per action in a u64.
+#define INPUT_MAX_ACTIONS 64
+// Maximum number of alternative chords bound to a single action.
+#define INPUT_MAX_ACTION_BINDINGS 4
+
+/**
+ * Binds a chord of keys and mouse buttons to a named action, creating the
+ * action if it does not exist yet. An action is held while all keys and
+ * buttons of any one of its chords are held. Calling this again with the same
+ * name adds an alternative chord.
+ * @param name The name of the action, at most 31 characters.
+ * @param key_count The number of keys in chord_keys.
+ * @param chord_keys The keys of the chord. May be 0 if key_count is 0.
+ * @param button_mask The mouse buttons of the chord, built with INPUT_BUTTON_MASK.
+ * @returns The id of the action, or INVALID_ID on failure.
+ */
+API u32 input_action_bind(const char* name, u32 key_count, const keys* chord_keys, u32 button_mask);
+
+/**
+ * @param name The name of the action.
+ * @returns The id of the action with the given name, or INVALID_ID if there is none.
+ */
+API u32 input_action_get(const char* name);
+
+/**
+ * Removes all chords bound to an action, e.g. before rebinding it. The action id stays valid.
+ * @param action The id of the action.
+ */
+API void input_action_unbind_all(u32 action);
+
+/**
+ * Evaluates all actions against the current key and button state. Called by
+ * the application after pending events are dispatched, right before each game
+ * update, so actions reflect this frame's input.
+ */
+API void input_update_actions();
+
+/** @returns True while the action is held, as of the last input_update_actions. */
+API b8 input_action_held(u32 action);
+/** @returns True if the action became held this frame. */
+API b8 input_action_pressed(u32 action);
+/** @returns True if the action stopped being held this frame. */
+API b8 input_action_released(u32 action);
+
+API void input_process_button(buttons button, b8 pressed);
 void input_process_mouse_move(i16 x, i16 y);
-void input_process_mouse_wheel(i32 z);
\ No newline at end of file
+void input_process_mouse_wheel(i32 z);
+
+/**
+ * Starts recording every input_process_* call, with its frame number and
+ * timestamp, to a compact binary file. Along with the input, each frame's game
+ * update count and delta time and the time timers were advanced to are recorded,
+ * so a replay updates the game and expires timers on the same frames as live
+ * play did. Recording begins with the next frame.
+ * @param path The file to write the recording to.
+ * @returns True if recording started; otherwise false.
+ */
+API b8 input_recording_start(const char* path);
+
+/**
+ * Stops recording and closes the file at the end of the current frame.
+ */
+API void input_recording_stop();
+
+API b8 input_is_recording();
+
+/**
+ * Records how the game was updated this frame. Called once per frame by the
+ * application while recording, before input_update.
+ * @param update_count The number of game updates run this frame.
+ * @param update_delta_time The delta time passed to each of those updates, in seconds.
+ * @param time The time timer_system_update was called with this frame, in seconds.
+ */
+void input_recording_frame(u32 update_count, f32 update_delta_time, f64 time);
+
+/**
+ * Starts replaying a recording made with input_recording_start, beginning with
+ * the next frame. While replaying, live input from the platform layer is ignored,
+ * the recorded calls are fed back in frame by frame and the application runs the
+ * recorded game updates (see input_replay_frame). A replay only reproduces the
+ * recorded session if the game starts from the same state it was in when
+ * recording started.
+ * @param path The recording to replay.
+ * @param quit_when_done If true, posts EVENT_CODE_APPLICATION_QUIT once the recording runs out.
+ * @returns True if replay started; otherwise false.
+ */
+API b8 input_replay_start(const char* path, b8 quit_when_done);
+
+/**
+ * Stops an active replay.
+ */
+API void input_replay_stop();
+
+API b8 input_is_replaying();
+
+/**
+ * Gets how the game was updated on the current frame of the active replay.
+ * Timer time is shifted by whole ticks so it never runs backwards, which keeps
+ * timers expiring on the same frames as when recorded.
+ * @param out_update_count The number of game updates to run.
+ * @param out_update_delta_time The delta time to pass to each update, in seconds.
+ * @param out_time The time to advance timers to, in seconds.
+ * @returns True if replaying and the current frame was recorded; otherwise false.
+ */
+b8 input_replay_frame(u32* out_update_count, f32* out_update_delta_time, f64* out_time);
+
+/**
+ * Feeds the recorded input for the current frame. Called once per frame by the
+ * application, after messages are pumped.
+ */
+void input_replay_update();
@@ -0,0 +1,500 @@
+#include "core/job_system.h"
+
+#include "core/logger.h"
+#include "core/profiler.h"
+#include "core/vmemory.h"
+#include "core/vstring.h"
+#include "platform/platform.h"
+#include "platform/vatomic.h"
+#include "platform/vfiber.h"
+#include "platform/vthread.h"
+
+/*
+ * Each thread (the main thread is thread 0) owns one Chase-Lev deque per
+ * priority. The owner pushes and pops at the bottom without contention while
+ * idle threads steal from the top. Threads that are not part of the system
+ * submit through a small locked queue instead. Jobs submitted with a
+ * dependency wait in a pending list until the dependency's counter hits zero.
+ */
+
+#define JOB_MAX_THREADS 64
+// Must be a power of 2.
+#define JOB_DEQUE_CAPACITY 1024
+#define JOB_INJECT_CAPACITY 4096
+#define JOB_MAX_PENDING 4096
+// Times an idle thread checks for work before going to sleep.
+#define JOB_IDLE_SPINS 256
+
+typedef struct job {
+    pfn_job_entry entry;
+    void* params;
+    job_counter* counter;
+} job;
+
+typedef struct job_deque {
+    volatile i64 top;
+    u8 pad0[VCACHE_LINE_SIZE - sizeof(i64)];
+    volatile i64 bottom;
+    u8 pad1[VCACHE_LINE_SIZE - sizeof(i64)];
+    job jobs[JOB_DEQUE_CAPACITY];
+} job_deque;
+
+typedef struct job_worker {
+    vthread thread;
+    // The thread as a fiber, so jobs can switch to fiber tasks and back.
+    vfiber fiber;
+    u32 index;
+    // Picks the first victim to steal from.
+    u32 random_state;
+    job_deque deques[JOB_PRIORITY_COUNT];
+} job_worker;
+
+typedef struct job_inject_queue {
+    u32 head;
+    volatile u32 count;
+    job jobs[JOB_INJECT_CAPACITY];
+} job_inject_queue;
+
+typedef struct pending_job {
+    job_counter* dependency;
+    job job;
+    job_priority priority;
+} pending_job;
+
+typedef struct job_system_state {
+    u32 thread_count;
+    volatile u32 running;
+    volatile u32 sleeping_count;
+    vsemaphore wake;
+
+    vspinlock inject_lock;
+    job_inject_queue inject[JOB_PRIORITY_COUNT];
+
+    vmutex pending_mutex;
+    volatile u32 pending_count;
+    pending_job pending[JOB_MAX_PENDING];
+
+    // thread_count entries, directly after the state.
+    job_worker* workers;
+} job_system_state;
+
+static job_system_state* state_ptr;
+
+// Index of the calling thread's worker, or -1 if it is not part of the job system.
+static _Thread_local i32 tls_worker_index = -1;
+
+// DEQUE //
+static b8 deque_push(job_deque* deque, const job* j) {
+    i64 bottom = vatomic_load_i64(&deque->bottom, VMEMORY_ORDER_RELAXED);
+    i64 top = vatomic_load_i64(&deque->top, VMEMORY_ORDER_ACQUIRE);
+    if (bottom - top >= JOB_DEQUE_CAPACITY) {
+        return false;
+    }
+    deque->jobs[bottom & (JOB_DEQUE_CAPACITY - 1)] = *j;
+    vatomic_thread_fence(VMEMORY_ORDER_RELEASE);
+    vatomic_store_i64(&deque->bottom, bottom + 1, VMEMORY_ORDER_RELAXED);
+    return true;
+}
+
+static b8 deque_pop(job_deque* deque, job* out_job) {
+    i64 bottom = vatomic_load_i64(&deque->bottom, VMEMORY_ORDER_RELAXED) - 1;
+    vatomic_store_i64(&deque->bottom, bottom, VMEMORY_ORDER_RELAXED);
+    vatomic_thread_fence(VMEMORY_ORDER_SEQ_CST);
+    i64 top = vatomic_load_i64(&deque->top, VMEMORY_ORDER_RELAXED);
+
+    if (top > bottom) {
+        // Empty.
+        vatomic_store_i64(&deque->bottom, bottom + 1, VMEMORY_ORDER_RELAXED);
+        return false;
+    }
+
+    *out_job = deque->jobs[bottom & (JOB_DEQUE_CAPACITY - 1)];
+    if (top == bottom) {
+        // Last job; race thieves for it.
+        b8 won = vatomic_compare_exchange_i64(&deque->top, &top, top + 1, false, VMEMORY_ORDER_SEQ_CST, VMEMORY_ORDER_RELAXED);
+        vatomic_store_i64(&deque->bottom, bottom + 1, VMEMORY_ORDER_RELAXED);
+        return won;
+    }
+    return true;
+}
+
+static b8 deque_steal(job_deque* deque, job* out_job) {
+    i64 top = vatomic_load_i64(&deque->top, VMEMORY_ORDER_ACQUIRE);
+    vatomic_thread_fence(VMEMORY_ORDER_SEQ_CST);
+    i64 bottom = vatomic_load_i64(&deque->bottom, VMEMORY_ORDER_ACQUIRE);
+    if (top >= bottom) {
+        return false;
+    }
+    // May read a slot the owner is overwriting; the CAS then fails and the copy is discarded.
+    *out_job = deque->jobs[top & (JOB_DEQUE_CAPACITY - 1)];
+    return vatomic_compare_exchange_i64(&deque->top, &top, top + 1, false, VMEMORY_ORDER_SEQ_CST, VMEMORY_ORDER_RELAXED);
+}
+
+// INJECT QUEUE //
+static b8 inject_push(job_priority priority, const job* j) {
+    job_inject_queue* queue = &state_ptr->inject[priority];
+    b8 pushed = false;
+    vspinlock_lock(&state_ptr->inject_lock);
+    if (queue->count < JOB_INJECT_CAPACITY) {
+        queue->jobs[(queue->head + queue->count) % JOB_INJECT_CAPACITY] = *j;
+        vatomic_store_u32(&queue->count, queue->count + 1, VMEMORY_ORDER_RELEASE);
+        pushed = true;
+    }
+    vspinlock_unlock(&state_ptr->inject_lock);
+    return pushed;
+}
+
+static b8 inject_pop(job_priority priority, job* out_job) {
+    job_inject_queue* queue = &state_ptr->inject[priority];
+    // Checked without the lock first since this is usually empty.
+    if (vatomic_load_u32(&queue->count, VMEMORY_ORDER_ACQUIRE) == 0) {
+        return false;
+    }
+    b8 popped = false;
+    vspinlock_lock(&state_ptr->inject_lock);
+    if (queue->count > 0) {
+        *out_job = queue->jobs[queue->head];
+        queue->head = (queue->head + 1) % JOB_INJECT_CAPACITY;
+        vatomic_store_u32(&queue->count, queue->count - 1, VMEMORY_ORDER_RELEASE);
+        popped = true;
+    }
+    vspinlock_unlock(&state_ptr->inject_lock);
+    return popped;
+}
+
+// EXECUTION //
+static void release_dependents(job_counter* counter);
+
+static void run_job(const job* j) {
+    j->entry(j->params);
+    if (j->counter && vatomic_fetch_sub_u32(&j->counter->value, 1, VMEMORY_ORDER_ACQ_REL) == 1) {
+        release_dependents(j->counter);
+    }
+}
+
+static u32 next_random(u32* random_state) {
+    // xorshift32
+    u32 x = *random_state;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    *random_state = x;
+    return x;
+}
+
+/**
+ * Finds the next job for the given thread: its own queue first, then external
+ * submissions, then other threads' queues; all of a priority before the next.
+ */
+static b8 try_get_job(i32 worker_index, job* out_job) {
+    u32 thread_count = state_ptr->thread_count;
+    u32 first_victim = 0;
+    if (worker_index >= 0) {
+        first_victim = next_random(&state_ptr->workers[worker_index].random_state) % thread_count;
+    }
+
+    for (u32 p = 0; p < JOB_PRIORITY_COUNT; ++p) {
+        if (worker_index >= 0 && deque_pop(&state_ptr->workers[worker_index].deques[p], out_job)) {
+            return true;
+        }
+        if (inject_pop((job_priority)p, out_job)) {
+            return true;
+        }
+        for (u32 i = 0; i < thread_count; ++i) {
+            u32 victim = (first_victim + i) % thread_count;
+            if ((i32)victim != worker_index && deque_steal(&state_ptr->workers[victim].deques[p], out_job)) {
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+static void wake_workers(u32 job_count) {
+    // Pairs with the fence implied by the sleeping_count increment in worker_main.
+    vatomic_thread_fence(VMEMORY_ORDER_SEQ_CST);
+    u32 sleeping = vatomic_load_u32(&state_ptr->sleeping_count, VMEMORY_ORDER_RELAXED);
+    if (sleeping) {
+        vsemaphore_signal(&state_ptr->wake, job_count < sleeping ? job_count : sleeping);
+    }
+}
+
+static void push_jobs(const job_desc* jobs, u32 count, job_counter* counter) {
+    i32 worker_index = tls_worker_index;
+    for (u32 i = 0; i < count; ++i) {
+        job j = {jobs[i].entry, jobs[i].params, counter};
+        job_priority priority = jobs[i].priority < JOB_PRIORITY_COUNT ? jobs[i].priority : JOB_PRIORITY_NORMAL;
+        b8 pushed = worker_index >= 0
+                        ? deque_push(&state_ptr->workers[worker_index].deques[priority], &j)
+                        : inject_push(priority, &j);
+        if (!pushed) {
+            // Queue full; running it right away still makes progress.
+            run_job(&j);
+        }
+    }
+    wake_workers(count);
+}
+
+static u32 worker_main(void* params) {
+    job_worker* worker = params;
+    tls_worker_index = (i32)worker->index;
+    char name[16];
+    string_format(name, "job_worker_%u", worker->index);
+    profiler_set_thread_name(name);
+    if (!vfiber_from_current_thread(&worker->fiber)) {
+        WARN("Job worker %u could not become a fiber; it will convert for each fiber task instead.", worker->index);
+    }
+
+    u32 idle_spins = 0;
+    while (vatomic_load_u32(&state_ptr->running, VMEMORY_ORDER_ACQUIRE)) {
+        job j;
+        if (try_get_job(tls_worker_index, &j)) {
+            run_job(&j);
+            idle_spins = 0;
+            continue;
+        }
+        if (++idle_spins < JOB_IDLE_SPINS) {
+            vatomic_cpu_relax();
+            continue;
+        }
+        idle_spins = 0;
+
+        // Announce going to sleep, then check once more so a concurrent submission isn't missed.
+        vatomic_fetch_add_u32(&state_ptr->sleeping_count, 1, VMEMORY_ORDER_SEQ_CST);
+        if (try_get_job(tls_worker_index, &j)) {
+            vatomic_fetch_sub_u32(&state_ptr->sleeping_count, 1, VMEMORY_ORDER_SEQ_CST);
+            run_job(&j);
+            continue;
+        }
+        vsemaphore_wait(&state_ptr->wake);
+        vatomic_fetch_sub_u32(&state_ptr->sleeping_count, 1, VMEMORY_ORDER_SEQ_CST);
+    }
+    vfiber_release_thread(&worker->fiber);
+    return 0;
+}
+
+// DEPENDENCIES //
+// Jobs released per pass over the pending list.
+#define JOB_RELEASE_BATCH 64
+
+static void release_dependents(job_counter* counter) {
+    // Pairs with the pending_count increment in job_submit_after: either that sees the
+    // counter at zero, or this sees the pending job.
+    vatomic_thread_fence(VMEMORY_ORDER_SEQ_CST);
+    if (vatomic_load_u32(&state_ptr->pending_count, VMEMORY_ORDER_RELAXED) == 0) {
+        return;
+    }
+
+    // Released jobs are pushed outside the lock; a full queue runs them inline, which could
+    // in turn release more jobs.
+    job_desc descs[JOB_RELEASE_BATCH];
+    job_counter* counters[JOB_RELEASE_BATCH];
+    u32 released_count;
+    do {
+        released_count = 0;
+        vmutex_lock(&state_ptr->pending_mutex);
+        u32 i = 0;
+        while (i < state_ptr->pending_count && released_count < JOB_RELEASE_BATCH) {
+            pending_job* pending = &state_ptr->pending[i];
+            if (pending->dependency == counter && vatomic_load_u32(&counter->value, VMEMORY_ORDER_ACQUIRE) == 0) {
+                descs[released_count].entry = pending->job.entry;
+                descs[released_count].params = pending->job.params;
+                descs[released_count].priority = pending->priority;
+                counters[released_count] = pending->job.counter;
+                released_count++;
+                // Swap-remove; the list is unordered.
+                *pending = state_ptr->pending[state_ptr->pending_count - 1];
+                vatomic_fetch_sub_u32(&state_ptr->pending_count, 1, VMEMORY_ORDER_SEQ_CST);
+            } else {
+                ++i;
+            }
+        }
+        vmutex_unlock(&state_ptr->pending_mutex);
+
+        for (u32 r = 0; r < released_count; ++r) {
+            push_jobs(&descs[r], 1, counters[r]);
+        }
+    } while (released_count == JOB_RELEASE_BATCH);
+}
+
+// PUBLIC //
+b8 job_system_initialize(u64* memory_requirement, void* state, u32 worker_thread_count) {
+    if (worker_thread_count == 0) {
+        platform_cpu_info cpu_info;
+        platform_get_cpu_info(&cpu_info);
+        worker_thread_count = cpu_info.logical_core_count > 1 ? cpu_info.logical_core_count - 1 : 0;
+    }
+    u32 thread_count = worker_thread_count + 1;
+    if (thread_count > JOB_MAX_THREADS) {
+        thread_count = JOB_MAX_THREADS;
+    }
+
+    *memory_requirement = sizeof(job_system_state) + sizeof(job_worker) * thread_count;
+    if (state == 0) {
+        return true;
+    }
+
+    vzero_memory(state, *memory_requirement);
+    state_ptr = state;
+    state_ptr->thread_count = thread_count;
+    state_ptr->workers = (job_worker*)((u8*)state + sizeof(job_system_state));
+    state_ptr->running = true;
+
+    if (!vsemaphore_create(0, &state_ptr->wake) || !vmutex_create(&state_ptr->pending_mutex)) {
+        ERROR("Failed to create job system synchronization objects.");
+        state_ptr = 0;
+        return false;
+    }
+
+    // The main thread is worker 0, it runs jobs while waiting.
+    tls_worker_index = 0;
+    if (!vfiber_from_current_thread(&state_ptr->workers[0].fiber)) {
+        WARN("The main thread could not become a fiber; it will convert for each fiber task instead.");
+    }
+    for (u32 i = 0; i < thread_count; ++i) {
+        state_ptr->workers[i].index = i;
+        state_ptr->workers[i].random_state = 0x9E3779B9u * (i + 1);
+    }
+
+    for (u32 i = 1; i < thread_count; ++i) {
+        char name[16];
+        string_format(name, "job_worker_%u", i);
+        if (!vthread_create(name, worker_main, &state_ptr->workers[i], &state_ptr->workers[i].thread)) {
+            ERROR("Failed to create job worker thread %u; continuing with %u threads.", i, i);
+            state_ptr->thread_count = i;
+            break;
+        }
+    }
+
+    INFO("Job system started with %u threads.", state_ptr->thread_count);
+    return true;
+}
+
+void job_system_shutdown(void* state) {
+    if (!state_ptr) {
+        return;
+    }
+
+    vatomic_store_u32(&state_ptr->running, false, VMEMORY_ORDER_RELEASE);
+    vsemaphore_signal(&state_ptr->wake, state_ptr->thread_count);
+    for (u32 i = 1; i < state_ptr->thread_count; ++i) {
+        vthread_join(&state_ptr->workers[i].thread, 0);
+    }
+
+    vsemaphore_destroy(&state_ptr->wake);
+    vmutex_destroy(&state_ptr->pending_mutex);
+    vfiber_release_thread(&state_ptr->workers[0].fiber);
+    tls_worker_index = -1;
+    state_ptr = 0;
+}
+
+void job_submit(const job_desc* jobs, u32 count, job_counter* counter) {
+    if (count == 0) {
+        return;
+    }
+    if (!state_ptr) {
+        // No job system; run serially.
+        for (u32 i = 0; i < count; ++i) {
+            jobs[i].entry(jobs[i].params);
+        }
+        return;
+    }
+
+    if (counter) {
+        vatomic_fetch_add_u32(&counter->value, count, VMEMORY_ORDER_RELEASE);
+    }
+    push_jobs(jobs, count, counter);
+}
+
+void job_submit_after(job_counter* dependency, const job_desc* jobs, u32 count, job_counter* counter) {
+    if (count == 0) {
+        return;
+    }
+    if (!state_ptr || !dependency) {
+        job_wait(dependency);
+        job_submit(jobs, count, counter);
+        return;
+    }
+
+    if (counter) {
+        vatomic_fetch_add_u32(&counter->value, count, VMEMORY_ORDER_RELEASE);
+    }
+
+    vmutex_lock(&state_ptr->pending_mutex);
+    b8 parked = false;
+    u32 first = state_ptr->pending_count;
+    if (first + count <= JOB_MAX_PENDING) {
+        // Reserve the slots before checking the dependency; see release_dependents. They are
+        // filled before the lock is released, which release_dependents needs to take first.
+        vatomic_fetch_add_u32(&state_ptr->pending_count, count, VMEMORY_ORDER_SEQ_CST);
+        if (vatomic_load_u32(&dependency->value, VMEMORY_ORDER_SEQ_CST) != 0) {
+            for (u32 i = 0; i < count; ++i) {
+                pending_job* pending = &state_ptr->pending[first + i];
+                pending->dependency = dependency;
+                pending->job.entry = jobs[i].entry;
+                pending->job.params = jobs[i].params;
+                pending->job.counter = counter;
+                pending->priority = jobs[i].priority;
+            }
+            parked = true;
+        } else {
+            vatomic_fetch_sub_u32(&state_ptr->pending_count, count, VMEMORY_ORDER_SEQ_CST);
+        }
+    } else {
+        WARN("job_submit_after - pending list full, waiting for the dependency instead.");
+    }
+    vmutex_unlock(&state_ptr->pending_mutex);
+
+    if (!parked) {
+        job_wait(dependency);
+        push_jobs(jobs, count, counter);
+    }
+}
+
+void job_wait(job_counter* counter) {
+    if (!counter) {
+        return;
+    }
+    u32 idle_spins = 0;
+    while (vatomic_load_u32(&counter->value, VMEMORY_ORDER_ACQUIRE) != 0) {
+        if (job_run_one()) {
+            idle_spins = 0;
+        } else if (++idle_spins < JOB_IDLE_SPINS) {
+            vatomic_cpu_relax();
+        } else {
+            vthread_yield();
+            idle_spins = 0;
+        }
+    }
+}
+
+b8 job_run_one() {
+    job j;
+    if (state_ptr && try_get_job(tls_worker_index, &j)) {
+        run_job(&j);
+        return true;
+    }
+    return false;
+}
+
+void job_counter_increment(job_counter* counter, u32 count) {
+    vatomic_fetch_add_u32(&counter->value, count, VMEMORY_ORDER_RELEASE);
+}
+
+void job_counter_decrement(job_counter* counter) {
+    if (vatomic_fetch_sub_u32(&counter->value, 1, VMEMORY_ORDER_ACQ_REL) == 1 && state_ptr) {
+        release_dependents(counter);
+    }
+}
+
+struct vfiber* job_thread_fiber() {
+    if (!state_ptr || tls_worker_index < 0) {
+        return 0;
+    }
+    vfiber* fiber = &state_ptr->workers[tls_worker_index].fiber;
+    return fiber->internal_data ? fiber : 0;
+}
+
+u32 job_system_thread_count() {
+    return state_ptr ? state_ptr->thread_count : 1;
+}
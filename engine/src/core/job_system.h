@@ -0,0 +1,109 @@
+#pragma once
+
+#include "defines.h"
+
+struct vfiber;
+
+/**
+ * Entry point of a job.
+ * @param params The params given in the job's job_desc.
+ */
+typedef void (*pfn_job_entry)(void* params);
+
+typedef enum job_priority {
+    JOB_PRIORITY_HIGH,
+    JOB_PRIORITY_NORMAL,
+    JOB_PRIORITY_LOW,
+    JOB_PRIORITY_COUNT
+} job_priority;
+
+typedef struct job_desc {
+    pfn_job_entry entry;
+    void* params;
+    job_priority priority;
+} job_desc;
+
+/**
+ * Counts the unfinished jobs of one or more submissions. Zero-initialize
+ * before first use; it returns to zero once all its jobs have run.
+ */
+typedef struct job_counter {
+    volatile u32 value;
+} job_counter;
+
+/**
+ * @brief Initializes the job system. Call twice; once with state = 0 to get required memory size,
+ * then a second time passing allocated memory to state. The calling thread becomes the main
+ * thread and executes jobs while in job_wait.
+ *
+ * @param memory_requirement A pointer to hold the required memory size of internal state.
+ * @param state 0 if just requesting memory requirement, otherwise allocated block of memory.
+ * @param worker_thread_count The number of worker threads to start in addition to the main
+ * thread, or 0 for one per remaining logical core.
+ * @returns True on success; otherwise false.
+ */
+API b8 job_system_initialize(u64* memory_requirement, void* state, u32 worker_thread_count);
+
+/**
+ * Waits for all worker threads to finish their current job and stops them.
+ * Jobs still queued are not run.
+ */
+API void job_system_shutdown(void* state);
+
+/**
+ * Queues jobs for execution on any thread. Submitting from a worker (or the
+ * main thread) pushes to that thread's own queue, from which idle workers steal.
+ * @param jobs An array of job descriptions.
+ * @param count The number of jobs.
+ * @param counter Incremented by count now, and decremented as each job finishes. May be 0.
+ */
+API void job_submit(const job_desc* jobs, u32 count, job_counter* counter);
+
+/**
+ * Queues jobs to run once another counter reaches zero, e.g. once all jobs of
+ * a previous stage have finished.
+ * @param dependency The counter to wait on.
+ * @param jobs An array of job descriptions.
+ * @param count The number of jobs.
+ * @param counter Incremented by count now, and decremented as each job finishes. May be 0.
+ */
+API void job_submit_after(job_counter* dependency, const job_desc* jobs, u32 count, job_counter* counter);
+
+/**
+ * Waits until the counter reaches zero. Rather than blocking, the calling
+ * thread runs queued jobs in the meantime.
+ * @param counter The counter to wait on.
+ */
+API void job_wait(job_counter* counter);
+
+/**
+ * Runs one queued job on the calling thread, if there is one. For wait loops
+ * that check something other than a counter.
+ * @returns True if a job was run; otherwise false.
+ */
+API b8 job_run_one();
+
+/**
+ * Adds to a counter for work that doesn't finish with a single job, such as a
+ * fiber task. Pair each unit with a job_counter_decrement.
+ * @param counter The counter.
+ * @param count The amount to add.
+ */
+API void job_counter_increment(job_counter* counter, u32 count);
+
+/**
+ * Subtracts one from a counter, releasing jobs submitted after it once it reaches zero.
+ * @param counter The counter.
+ */
+API void job_counter_decrement(job_counter* counter);
+
+/**
+ * @returns The calling job thread's own fiber, or 0 if the thread is not part of
+ * the job system.
+ */
+API struct vfiber* job_thread_fiber();
+
+/**
+ * @returns The number of threads executing jobs, including the main thread.
+ */
+API u32 job_system_thread_count();
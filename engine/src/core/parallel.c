@@ -0,0 +1,223 @@
+#include "core/parallel.h"
+
+#include "core/job_system.h"
+#include "core/vmemory.h"
+#include "platform/platform.h"
+#include "platform/vatomic.h"
+
+// Chunks per thread with automatic grains; more than one evens out uneven chunk costs.
+#define PARALLEL_CHUNKS_PER_THREAD 4
+// Bounds the per-call bookkeeping, which lives on the stack. Grains are raised to fit.
+#define PARALLEL_MAX_CHUNKS 256
+// Partial results up to this size are kept on the stack.
+#define PARALLEL_STACK_PARTIALS_SIZE 4096
+
+typedef enum parallel_kind {
+    PARALLEL_KIND_RANGE,
+    PARALLEL_KIND_ARRAY,
+    PARALLEL_KIND_REDUCE
+} parallel_kind;
+
+typedef struct parallel_context {
+    parallel_kind kind;
+    u64 count;
+    u64 grain;
+    void* user_data;
+
+    pfn_parallel_range range_fn;
+
+    pfn_parallel_array array_fn;
+    u8* elements;
+    u64 element_size;
+
+    pfn_parallel_reduce_range reduce_fn;
+    u8* partials;
+    // Partials are a cache line apart so chunks on different threads don't false-share.
+    u64 partial_stride;
+} parallel_context;
+
+typedef struct parallel_chunk {
+    parallel_context* context;
+    u64 index;
+} parallel_chunk;
+
+static void run_chunk(parallel_context* context, u64 index) {
+    u64 begin = index * context->grain;
+    u64 end = begin + context->grain;
+    if (end > context->count) {
+        end = context->count;
+    }
+    switch (context->kind) {
+        case PARALLEL_KIND_RANGE:
+            context->range_fn(begin, end, context->user_data);
+            break;
+        case PARALLEL_KIND_ARRAY:
+            context->array_fn(context->elements + begin * context->element_size, begin, end - begin, context->user_data);
+            break;
+        case PARALLEL_KIND_REDUCE:
+            context->reduce_fn(begin, end, context->partials + index * context->partial_stride, context->user_data);
+            break;
+    }
+}
+
+static void chunk_job(void* params) {
+    parallel_chunk* chunk = params;
+    run_chunk(chunk->context, chunk->index);
+}
+
+static u64 chunk_count_for(u64 count, u64* grain) {
+    u64 chunks = (count + *grain - 1) / *grain;
+    if (chunks > PARALLEL_MAX_CHUNKS) {
+        *grain = (count + PARALLEL_MAX_CHUNKS - 1) / PARALLEL_MAX_CHUNKS;
+        chunks = (count + *grain - 1) / *grain;
+    }
+    return chunks;
+}
+
+static u64 automatic_grain(u64 count) {
+    u64 target_chunks = (u64)job_system_thread_count() * PARALLEL_CHUNKS_PER_THREAD;
+    u64 grain = (count + target_chunks - 1) / target_chunks;
+    return grain ? grain : 1;
+}
+
+static void get_cache_sizes(u64* out_line_size, u64* out_l2_size) {
+    // Topology doesn't change while running; query it once. Racing first calls store the same values.
+    static u64 line_size = 0;
+    static u64 l2_size = 0;
+    if (line_size == 0) {
+        platform_cpu_info info;
+        platform_get_cpu_info(&info);
+        l2_size = info.l2_cache_size ? info.l2_cache_size : 256 * 1024;
+        line_size = info.cache_line_size ? info.cache_line_size : 64;
+    }
+    *out_line_size = line_size;
+    *out_l2_size = l2_size;
+}
+
+/**
+ * Runs all chunks of the context, the first on the calling thread.
+ */
+static void run_chunks(parallel_context* context, u64 chunk_count) {
+    if (chunk_count == 1 || job_system_thread_count() == 1) {
+        for (u64 i = 0; i < chunk_count; ++i) {
+            run_chunk(context, i);
+        }
+        return;
+    }
+
+    parallel_chunk chunks[PARALLEL_MAX_CHUNKS];
+    job_desc jobs[PARALLEL_MAX_CHUNKS];
+    for (u64 i = 1; i < chunk_count; ++i) {
+        chunks[i].context = context;
+        chunks[i].index = i;
+        jobs[i - 1].entry = chunk_job;
+        jobs[i - 1].params = &chunks[i];
+        jobs[i - 1].priority = JOB_PRIORITY_NORMAL;
+    }
+
+    job_counter counter = {};
+    job_submit(jobs, (u32)(chunk_count - 1), &counter);
+    run_chunk(context, 0);
+    job_wait(&counter);
+}
+
+void parallel_for(u64 count, u64 grain, pfn_parallel_range fn, void* user_data) {
+    if (count == 0) {
+        return;
+    }
+    if (grain == 0) {
+        grain = automatic_grain(count);
+    }
+    u64 chunk_count = chunk_count_for(count, &grain);
+    if (chunk_count == 1 || job_system_thread_count() == 1) {
+        fn(0, count, user_data);
+        return;
+    }
+
+    parallel_context context = {};
+    context.kind = PARALLEL_KIND_RANGE;
+    context.count = count;
+    context.grain = grain;
+    context.user_data = user_data;
+    context.range_fn = fn;
+    run_chunks(&context, chunk_count);
+}
+
+void parallel_for_array(void* elements, u64 element_size, u64 count, u64 grain, pfn_parallel_array fn, void* user_data) {
+    if (count == 0) {
+        return;
+    }
+    if (grain == 0) {
+        grain = automatic_grain(count);
+
+        u64 line_size, l2_size;
+        get_cache_sizes(&line_size, &l2_size);
+        // Keep each chunk's working set within L2...
+        u64 max_grain = (l2_size / 2) / element_size;
+        if (max_grain && grain > max_grain) {
+            grain = max_grain;
+        }
+        // ...and a whole number of cache lines, so chunks written by different threads don't share one.
+        u64 line_elements = line_size / element_size;
+        if (line_elements > 1) {
+            grain = ((grain + line_elements - 1) / line_elements) * line_elements;
+        }
+    }
+    u64 chunk_count = chunk_count_for(count, &grain);
+    if (chunk_count == 1 || job_system_thread_count() == 1) {
+        fn(elements, 0, count, user_data);
+        return;
+    }
+
+    parallel_context context = {};
+    context.kind = PARALLEL_KIND_ARRAY;
+    context.count = count;
+    context.grain = grain;
+    context.user_data = user_data;
+    context.array_fn = fn;
+    context.elements = elements;
+    context.element_size = element_size;
+    run_chunks(&context, chunk_count);
+}
+
+void parallel_reduce(u64 count, u64 grain, u64 result_size, const void* identity,
+                     pfn_parallel_reduce_range fn, pfn_parallel_combine combine,
+                     void* user_data, void* out_result) {
+    vcopy_memory(out_result, identity, result_size);
+    if (count == 0) {
+        return;
+    }
+    if (grain == 0) {
+        grain = automatic_grain(count);
+    }
+    u64 chunk_count = chunk_count_for(count, &grain);
+
+    // Partials are allocated from the platform directly; this may run inside a job on
+    // any thread, and the tracked allocator is main-thread only.
+    _Alignas(VCACHE_LINE_SIZE) u8 stack_partials[PARALLEL_STACK_PARTIALS_SIZE];
+    u64 partial_stride = ((result_size + VCACHE_LINE_SIZE - 1) / VCACHE_LINE_SIZE) * VCACHE_LINE_SIZE;
+    u64 partials_size = chunk_count * partial_stride;
+    u8* partials = partials_size <= PARALLEL_STACK_PARTIALS_SIZE ? stack_partials : platform_allocate(partials_size, false);
+    for (u64 i = 0; i < chunk_count; ++i) {
+        vcopy_memory(partials + i * partial_stride, identity, result_size);
+    }
+
+    parallel_context context = {};
+    context.kind = PARALLEL_KIND_REDUCE;
+    context.count = count;
+    context.grain = grain;
+    context.user_data = user_data;
+    context.reduce_fn = fn;
+    context.partials = partials;
+    context.partial_stride = partial_stride;
+    // Also used single-threaded, so results don't depend on the thread count.
+    run_chunks(&context, chunk_count);
+
+    for (u64 i = 0; i < chunk_count; ++i) {
+        combine(out_result, partials + i * partial_stride, user_data);
+    }
+
+    if (partials != stack_partials) {
+        platform_free(partials, false);
+    }
+}
@@ -0,0 +1,76 @@
+#pragma once
+
+#include "defines.h"
+
+/**
+ * Processes the index range [begin, end).
+ */
+typedef void (*pfn_parallel_range)(u64 begin, u64 end, void* user_data);
+
+/**
+ * Processes count elements starting at elements, which is element first_index of the array.
+ */
+typedef void (*pfn_parallel_array)(void* elements, u64 first_index, u64 count, void* user_data);
+
+/**
+ * Reduces the index range [begin, end) into partial, which starts out as a copy of the identity.
+ */
+typedef void (*pfn_parallel_reduce_range)(u64 begin, u64 end, void* partial, void* user_data);
+
+/**
+ * Folds partial into accumulator.
+ */
+typedef void (*pfn_parallel_combine)(void* accumulator, const void* partial, void* user_data);
+
+/*
+ * All variants split the range into chunks of grain items, run them on the job
+ * system with the calling thread taking part, and return once every chunk is
+ * done. Chunk boundaries depend only on count and grain, so passing an explicit
+ * grain gives the same chunks (and the same reduction results) on every machine.
+ * A grain of 0 picks one from the thread count (and cache sizes, for arrays).
+ * With a single thread, or a single chunk, the range runs serially.
+ */
+
+/**
+ * Calls fn over [0, count) in parallel chunks.
+ * @param count The number of items.
+ * @param grain The number of items per chunk, or 0 for automatic.
+ * @param fn The function to call per chunk.
+ * @param user_data Passed to fn.
+ */
+API void parallel_for(u64 count, u64 grain, pfn_parallel_range fn, void* user_data);
+
+/**
+ * Calls fn over the elements of an array in parallel chunks. Automatic grains
+ * keep chunks at least a cache line and at most half the L2 cache in size.
+ * @param elements The first element of the array.
+ * @param element_size The size of each element in bytes.
+ * @param count The number of elements.
+ * @param grain The number of elements per chunk, or 0 for automatic.
+ * @param fn The function to call per chunk.
+ * @param user_data Passed to fn.
+ */
+API void parallel_for_array(void* elements, u64 element_size, u64 count, u64 grain, pfn_parallel_array fn, void* user_data);
+
+/**
+ * Reduces [0, count) in parallel chunks. Each chunk reduces into its own
+ * partial result; the partials are then combined in chunk order on the
+ * calling thread.
+ * @param count The number of items.
+ * @param grain The number of items per chunk, or 0 for automatic.
+ * @param result_size The size of the result in bytes.
+ * @param identity The initial value of each partial result, e.g. 0 for a sum.
+ * @param fn Reduces a chunk into its partial result.
+ * @param combine Folds a partial result into the final result.
+ * @param user_data Passed to fn and combine.
+ * @param out_result A pointer to hold the result. Starts out as a copy of identity.
+ */
+API void parallel_reduce(u64 count, u64 grain, u64 result_size, const void* identity,
+                         pfn_parallel_reduce_range fn, pfn_parallel_combine combine,
+                         void* user_data, void* out_result);
+
+/**
+ * Calls fn over the elements of a darray in parallel chunks. See parallel_for_array.
+ */
+#define darray_parallel_for(array, grain, fn, user_data) \
+    parallel_for_array((array), sizeof(*(array)), darray_length(array), (grain), (fn), (user_data))
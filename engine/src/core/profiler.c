@@ -0,0 +1,520 @@
+#include "core/profiler.h"
+
+#include "core/logger.h"
+#include "core/vmemory.h"
+#include "core/vstring.h"
+#include "platform/filesystem.h"
+#include "platform/platform.h"
+#include "platform/vatomic.h"
+#include "platform/vthread.h"
+
+#if PROFILER_ENABLED
+
+/*
+ * Every thread owns a ring of events which only it writes. The reader (the
+ * thread calling profiler_frame_end) follows behind each ring, keeping the
+ * zones still open on each thread on a stack of its own, so zones spanning
+ * frames are attributed to the frame in which they end.
+ */
+
+#define PROFILER_MAX_THREADS 64
+// Events per thread; must be a power of 2. Around a second of a busy thread.
+#define PROFILER_THREAD_EVENT_CAPACITY 65536
+#define PROFILER_MAX_DEPTH 64
+#define PROFILER_MAX_FRAME_ZONES 1024
+#define PROFILER_MAX_GPU_ZONES 64
+// Bytes of trace written per filesystem call.
+#define PROFILER_EXPORT_CHUNK_SIZE (64 * 1024)
+
+// Set in the timestamp of end events; timestamps never reach it.
+#define PROFILER_END_BIT (1ull << 63)
+
+typedef struct profiler_event {
+    const char* name;
+    u64 timestamp;
+} profiler_event;
+
+typedef struct profiler_open_zone {
+    const char* name;
+    u64 begin;
+    // Index in the frame's zones, or INVALID_ID if not created in this frame yet.
+    u32 zone_index;
+    u64 child_cycles;
+} profiler_open_zone;
+
+typedef struct profiler_thread {
+    u32 index;
+    u64 thread_id;
+    char name[32];
+    // Written by the owning thread only.
+    volatile u64 write_count;
+    profiler_event* events;
+
+    // Reader side.
+    u64 read_count;
+    u32 open_count;
+    profiler_open_zone open[PROFILER_MAX_DEPTH];
+} profiler_thread;
+
+typedef struct profiler_state {
+    u32 generation;
+    u64 start_cycles;
+
+    vspinlock threads_lock;
+    volatile u32 thread_count;
+    profiler_thread* threads[PROFILER_MAX_THREADS];
+
+    u32 zone_count;
+    profiler_zone_stats zones[PROFILER_MAX_FRAME_ZONES];
+    u64 zone_total_cycles[PROFILER_MAX_FRAME_ZONES];
+    u64 zone_child_cycles[PROFILER_MAX_FRAME_ZONES];
+    u64 dropped_events;
+
+    // GPU zones recorded since the last frame end, guarded by the lock, and those published for the last frame.
+    vspinlock gpu_lock;
+    u32 pending_gpu_zone_count;
+    profiler_gpu_zone pending_gpu_zones[PROFILER_MAX_GPU_ZONES];
+    u32 gpu_zone_count;
+    profiler_gpu_zone gpu_zones[PROFILER_MAX_GPU_ZONES];
+} profiler_state;
+
+static profiler_state* state_ptr;
+// Bumped per initialization, so thread buffers of an earlier run are never reused.
+static u32 profiler_generation = 0;
+
+static _Thread_local profiler_thread* tls_thread = 0;
+static _Thread_local u32 tls_generation = 0;
+
+static profiler_thread* get_thread() {
+    if (tls_thread && tls_generation == state_ptr->generation) {
+        return tls_thread;
+    }
+
+    profiler_thread* thread = platform_allocate(sizeof(profiler_thread), false);
+    platform_zero_memory(thread, sizeof(profiler_thread));
+    thread->events = platform_allocate(sizeof(profiler_event) * PROFILER_THREAD_EVENT_CAPACITY, false);
+    thread->thread_id = vthread_current_id();
+
+    vspinlock_lock(&state_ptr->threads_lock);
+    u32 count = state_ptr->thread_count;
+    if (count < PROFILER_MAX_THREADS) {
+        thread->index = count;
+        state_ptr->threads[count] = thread;
+        vatomic_store_u32(&state_ptr->thread_count, count + 1, VMEMORY_ORDER_RELEASE);
+    }
+    vspinlock_unlock(&state_ptr->threads_lock);
+
+    if (count >= PROFILER_MAX_THREADS) {
+        platform_free(thread->events, false);
+        platform_free(thread, false);
+        return 0;
+    }
+    tls_thread = thread;
+    tls_generation = state_ptr->generation;
+    return thread;
+}
+
+// Callers check state_ptr, so the cycle counter isn't read while the profiler is off.
+static void write_event(const char* name, u64 timestamp) {
+    profiler_thread* thread = get_thread();
+    if (!thread) {
+        return;
+    }
+    u64 write_count = thread->write_count;
+    profiler_event* event = &thread->events[write_count & (PROFILER_THREAD_EVENT_CAPACITY - 1)];
+    // Keeps the slot from being overwritten before the last count is visible, which read_thread checks against.
+    vatomic_thread_fence(VMEMORY_ORDER_RELEASE);
+    event->name = name;
+    event->timestamp = timestamp;
+    vatomic_store_u64(&thread->write_count, write_count + 1, VMEMORY_ORDER_RELEASE);
+}
+
+static f64 cycles_to_ms(u64 cycles) {
+    return platform_cycles_to_seconds(cycles) * 1000.0;
+}
+
+/**
+ * Finds or adds the zone for the open zone at the given depth of a thread,
+ * creating its ancestors first where needed.
+ */
+static u32 get_zone(profiler_thread* thread, u32 depth) {
+    profiler_open_zone* open = &thread->open[depth];
+    if (open->zone_index != INVALID_ID) {
+        return open->zone_index;
+    }
+    u32 parent = depth > 0 ? get_zone(thread, depth - 1) : INVALID_ID;
+    if (parent == INVALID_ID && depth > 0) {
+        return INVALID_ID;
+    }
+
+    for (u32 i = parent == INVALID_ID ? 0 : parent + 1; i < state_ptr->zone_count; ++i) {
+        profiler_zone_stats* zone = &state_ptr->zones[i];
+        if (zone->parent == parent && zone->thread_index == thread->index &&
+            (zone->name == open->name || strings_equal(zone->name, open->name))) {
+            open->zone_index = i;
+            return i;
+        }
+    }
+
+    if (state_ptr->zone_count == PROFILER_MAX_FRAME_ZONES) {
+        return INVALID_ID;
+    }
+    u32 index = state_ptr->zone_count++;
+    profiler_zone_stats* zone = &state_ptr->zones[index];
+    zone->name = open->name;
+    zone->parent = parent;
+    zone->depth = depth;
+    zone->thread_index = thread->index;
+    zone->call_count = 0;
+    state_ptr->zone_total_cycles[index] = 0;
+    state_ptr->zone_child_cycles[index] = 0;
+    open->zone_index = index;
+    return index;
+}
+
+/**
+ * Drops the unread events of a thread that lapped the reader. Reading resumes
+ * half a buffer behind the writer, as the trace export does, so the writer
+ * can't lap the reader again straight away.
+ */
+static void skip_lapped_events(profiler_thread* thread, u64 write_count) {
+    u64 resume = write_count - PROFILER_THREAD_EVENT_CAPACITY / 2;
+    state_ptr->dropped_events += resume - thread->read_count;
+    thread->read_count = resume;
+    // The open zones can't be matched up anymore.
+    thread->open_count = 0;
+}
+
+static void read_thread(profiler_thread* thread) {
+    u64 write_count = vatomic_load_u64(&thread->write_count, VMEMORY_ORDER_ACQUIRE);
+    if (write_count - thread->read_count > PROFILER_THREAD_EVENT_CAPACITY) {
+        skip_lapped_events(thread, write_count);
+    }
+
+    while (thread->read_count < write_count) {
+        u64 index = thread->read_count;
+        profiler_event event = thread->events[index & (PROFILER_THREAD_EVENT_CAPACITY - 1)];
+
+        // The thread keeps writing meanwhile. The copy is only whole if the writer
+        // hadn't come round to this slot again by the time it was taken.
+        vatomic_thread_fence(VMEMORY_ORDER_ACQUIRE);
+        u64 latest = vatomic_load_u64(&thread->write_count, VMEMORY_ORDER_RELAXED);
+        if (latest - index >= PROFILER_THREAD_EVENT_CAPACITY) {
+            skip_lapped_events(thread, latest);
+            write_count = latest;
+            continue;
+        }
+        thread->read_count++;
+
+        if (!(event.timestamp & PROFILER_END_BIT)) {
+            if (thread->open_count < PROFILER_MAX_DEPTH) {
+                profiler_open_zone* open = &thread->open[thread->open_count];
+                open->name = event.name;
+                open->begin = event.timestamp;
+                open->zone_index = INVALID_ID;
+                open->child_cycles = 0;
+            }
+            thread->open_count++;
+            continue;
+        }
+
+        if (thread->open_count == 0) {
+            // Ended a zone begun before the profiler started.
+            continue;
+        }
+        u32 depth = --thread->open_count;
+        if (depth >= PROFILER_MAX_DEPTH) {
+            continue;
+        }
+        profiler_open_zone* open = &thread->open[depth];
+        u64 end = event.timestamp & ~PROFILER_END_BIT;
+        u64 duration = end > open->begin ? end - open->begin : 0;
+        u32 zone = get_zone(thread, depth);
+        if (zone != INVALID_ID) {
+            state_ptr->zones[zone].call_count++;
+            state_ptr->zone_total_cycles[zone] += duration;
+            state_ptr->zone_child_cycles[zone] += open->child_cycles;
+        }
+        if (depth > 0) {
+            thread->open[depth - 1].child_cycles += duration;
+        }
+    }
+}
+
+b8 profiler_initialize(u64* memory_requirement, void* state) {
+    *memory_requirement = sizeof(profiler_state);
+    if (state == 0) {
+        return true;
+    }
+
+    vzero_memory(state, sizeof(profiler_state));
+    state_ptr = state;
+    state_ptr->generation = ++profiler_generation;
+    state_ptr->start_cycles = platform_get_cycles();
+    profiler_set_thread_name("main");
+    return true;
+}
+
+void profiler_shutdown(void* state) {
+    if (!state_ptr) {
+        return;
+    }
+    if (state_ptr->dropped_events) {
+        WARN("Profiler dropped %llu events to full thread buffers.", state_ptr->dropped_events);
+    }
+
+    profiler_state* old_state = state_ptr;
+    state_ptr = 0;
+    for (u32 i = 0; i < old_state->thread_count; ++i) {
+        platform_free(old_state->threads[i]->events, false);
+        platform_free(old_state->threads[i], false);
+    }
+}
+
+void profiler_set_thread_name(const char* name) {
+    if (!state_ptr) {
+        return;
+    }
+    profiler_thread* thread = get_thread();
+    if (thread) {
+        u64 length = string_length(name);
+        if (length >= sizeof(thread->name)) {
+            length = sizeof(thread->name) - 1;
+        }
+        vcopy_memory(thread->name, name, length);
+        thread->name[length] = 0;
+    }
+}
+
+void profiler_zone_begin(const char* name) {
+    if (!state_ptr) {
+        return;
+    }
+    write_event(name, platform_get_cycles() & ~PROFILER_END_BIT);
+}
+
+void profiler_zone_end() {
+    if (!state_ptr) {
+        return;
+    }
+    write_event(0, platform_get_cycles() | PROFILER_END_BIT);
+}
+
+void profiler_frame_end() {
+    if (!state_ptr) {
+        return;
+    }
+
+    state_ptr->zone_count = 0;
+    u32 thread_count = vatomic_load_u32(&state_ptr->thread_count, VMEMORY_ORDER_ACQUIRE);
+    for (u32 t = 0; t < thread_count; ++t) {
+        profiler_thread* thread = state_ptr->threads[t];
+        // Zones still open carry over, but their entries belong to the last frame's tree.
+        for (u32 d = 0; d < thread->open_count && d < PROFILER_MAX_DEPTH; ++d) {
+            thread->open[d].zone_index = INVALID_ID;
+        }
+        read_thread(thread);
+    }
+
+    vspinlock_lock(&state_ptr->gpu_lock);
+    state_ptr->gpu_zone_count = state_ptr->pending_gpu_zone_count;
+    vcopy_memory(state_ptr->gpu_zones, state_ptr->pending_gpu_zones, sizeof(profiler_gpu_zone) * state_ptr->gpu_zone_count);
+    state_ptr->pending_gpu_zone_count = 0;
+    vspinlock_unlock(&state_ptr->gpu_lock);
+
+    for (u32 i = 0; i < state_ptr->zone_count; ++i) {
+        u64 total = state_ptr->zone_total_cycles[i];
+        u64 child = state_ptr->zone_child_cycles[i];
+        state_ptr->zones[i].total_ms = cycles_to_ms(total);
+        state_ptr->zones[i].self_ms = cycles_to_ms(total > child ? total - child : 0);
+    }
+}
+
+const profiler_zone_stats* profiler_frame_zones(u32* out_count) {
+    if (!state_ptr) {
+        *out_count = 0;
+        return 0;
+    }
+    *out_count = state_ptr->zone_count;
+    return state_ptr->zones;
+}
+
+void profiler_record_gpu_zone(const char* name, u32 depth, f64 milliseconds) {
+    if (!state_ptr) {
+        return;
+    }
+    vspinlock_lock(&state_ptr->gpu_lock);
+    if (state_ptr->pending_gpu_zone_count < PROFILER_MAX_GPU_ZONES) {
+        profiler_gpu_zone* zone = &state_ptr->pending_gpu_zones[state_ptr->pending_gpu_zone_count++];
+        zone->name = name;
+        zone->depth = depth;
+        zone->milliseconds = milliseconds;
+    }
+    vspinlock_unlock(&state_ptr->gpu_lock);
+}
+
+const profiler_gpu_zone* profiler_frame_gpu_zones(u32* out_count) {
+    if (!state_ptr) {
+        *out_count = 0;
+        return 0;
+    }
+    *out_count = state_ptr->gpu_zone_count;
+    return state_ptr->gpu_zones;
+}
+
+void profiler_log_frame() {
+    if (!state_ptr) {
+        return;
+    }
+    static const char* indent = "                                ";
+    for (u32 i = 0; i < state_ptr->zone_count; ++i) {
+        const profiler_zone_stats* zone = &state_ptr->zones[i];
+        u32 indent_length = zone->depth * 2 < 32 ? zone->depth * 2 : 32;
+        INFO("[%u] %s%s: %.3fms (self %.3fms, %u calls)",
+             zone->thread_index, indent + 32 - indent_length, zone->name, zone->total_ms, zone->self_ms, zone->call_count);
+    }
+    for (u32 i = 0; i < state_ptr->gpu_zone_count; ++i) {
+        const profiler_gpu_zone* zone = &state_ptr->gpu_zones[i];
+        u32 indent_length = zone->depth * 2 < 32 ? zone->depth * 2 : 32;
+        INFO("[gpu] %s%s: %.3fms", indent + 32 - indent_length, zone->name, zone->milliseconds);
+    }
+}
+
+typedef struct trace_writer {
+    file_handle file;
+    u64 length;
+    b8 failed;
+    char buffer[PROFILER_EXPORT_CHUNK_SIZE];
+} trace_writer;
+
+static void trace_flush(trace_writer* writer) {
+    u64 written = 0;
+    if (writer->length && !filesystem_write(&writer->file, writer->length, writer->buffer, &written)) {
+        writer->failed = true;
+    }
+    writer->length = 0;
+}
+
+static void trace_append(trace_writer* writer, const char* text) {
+    u64 length = string_length(text);
+    if (writer->length + length > PROFILER_EXPORT_CHUNK_SIZE) {
+        trace_flush(writer);
+    }
+    vcopy_memory(writer->buffer + writer->length, text, length);
+    writer->length += length;
+}
+
+b8 profiler_export_chrome_trace(const char* path) {
+    if (!state_ptr) {
+        return false;
+    }
+
+    // Large, and only needed here.
+    trace_writer* writer = platform_allocate(sizeof(trace_writer), false);
+    writer->length = 0;
+    writer->failed = false;
+    if (!filesystem_open(path, FILE_MODE_WRITE, false, &writer->file)) {
+        ERROR("profiler_export_chrome_trace - unable to open '%s' for writing.", path);
+        platform_free(writer, false);
+        return false;
+    }
+
+    char line[256];
+    trace_append(writer, "{\"traceEvents\":[\n");
+    b8 first = true;
+    u64 event_count = 0;
+    u32 thread_count = vatomic_load_u32(&state_ptr->thread_count, VMEMORY_ORDER_ACQUIRE);
+    for (u32 t = 0; t < thread_count; ++t) {
+        profiler_thread* thread = state_ptr->threads[t];
+        if (thread->name[0]) {
+            string_format(line, "%s{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":0,\"tid\":%u,\"args\":{\"name\":\"%s\"}}",
+                          first ? "" : ",\n", thread->index, thread->name);
+            trace_append(writer, line);
+            first = false;
+        }
+
+        // The thread keeps writing meanwhile; start clear of the slots it may be overwriting.
+        u64 write_count = vatomic_load_u64(&thread->write_count, VMEMORY_ORDER_ACQUIRE);
+        u64 begin = write_count > PROFILER_THREAD_EVENT_CAPACITY / 2 ? write_count - PROFILER_THREAD_EVENT_CAPACITY / 2 : 0;
+        u32 depth = 0;
+        const char* names[PROFILER_MAX_DEPTH];
+        for (u64 i = begin; i < write_count; ++i) {
+            profiler_event event = thread->events[i & (PROFILER_THREAD_EVENT_CAPACITY - 1)];
+            // As in read_thread, the copy is only whole if the writer hadn't come round to
+            // this slot again. If it has, stop rather than pair zones across the gap.
+            vatomic_thread_fence(VMEMORY_ORDER_ACQUIRE);
+            u64 latest = vatomic_load_u64(&thread->write_count, VMEMORY_ORDER_RELAXED);
+            if (latest - i >= PROFILER_THREAD_EVENT_CAPACITY) {
+                break;
+            }
+            b8 is_end = (event.timestamp & PROFILER_END_BIT) != 0;
+            if (is_end && depth == 0) {
+                // Its begin is no longer in the buffer.
+                continue;
+            }
+            const char* name = 0;
+            if (is_end) {
+                depth--;
+                name = depth < PROFILER_MAX_DEPTH ? names[depth] : "";
+            } else {
+                if (depth < PROFILER_MAX_DEPTH) {
+                    names[depth] = event.name;
+                }
+                depth++;
+                name = event.name;
+            }
+            u64 cycles = (event.timestamp & ~PROFILER_END_BIT) - state_ptr->start_cycles;
+            string_format(line, "%s{\"name\":\"%s\",\"ph\":\"%s\",\"ts\":%.3f,\"pid\":0,\"tid\":%u}",
+                          first ? "" : ",\n", name, is_end ? "E" : "B", platform_cycles_to_seconds(cycles) * 1e6, thread->index);
+            trace_append(writer, line);
+            first = false;
+            event_count++;
+        }
+    }
+    trace_append(writer, "\n]}\n");
+    trace_flush(writer);
+    filesystem_close(&writer->file);
+
+    b8 failed = writer->failed;
+    platform_free(writer, false);
+    if (failed) {
+        ERROR("profiler_export_chrome_trace - failed writing '%s'.", path);
+        return false;
+    }
+    INFO("Exported %llu profiler events to '%s'.", event_count, path);
+    return true;
+}
+
+#else
+
+b8 profiler_initialize(u64* memory_requirement, void* state) {
+    *memory_requirement = 0;
+    return true;
+}
+
+void profiler_shutdown(void* state) {}
+void profiler_set_thread_name(const char* name) {}
+void profiler_zone_begin(const char* name) {}
+void profiler_zone_end() {}
+void profiler_frame_end() {}
+
+const profiler_zone_stats* profiler_frame_zones(u32* out_count) {
+    *out_count = 0;
+    return 0;
+}
+
+void profiler_record_gpu_zone(const char* name, u32 depth, f64 milliseconds) {}
+
+const profiler_gpu_zone* profiler_frame_gpu_zones(u32* out_count) {
+    *out_count = 0;
+    return 0;
+}
+
+void profiler_log_frame() {}
+
+b8 profiler_export_chrome_trace(const char* path) {
+    WARN("profiler_export_chrome_trace - the profiler is compiled out.");
+    return false;
+}
+
+#endif
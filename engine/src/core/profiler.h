@@ -0,0 +1,158 @@
+#pragma once
+
+#include "defines.h"
+
+/*
+ * Zones mark timed sections of code. Each thread writes zone begin/end events
+ * into its own buffer without locking; once per frame, profiler_frame_end
+ * gathers them into a tree of zones (per thread, merged by call path) for the
+ * frame just finished. The recent history of every thread can be exported as a
+ * Chrome trace, viewable in about:tracing or ui.perfetto.dev.
+ *
+ * With PROFILER_ENABLED 0, the zone macros compile to nothing and the
+ * functions do nothing.
+ */
+
+// On in debug builds by default; define PROFILER_ENABLED 1 to profile release builds.
+#ifndef PROFILER_ENABLED
+    #ifdef _DEBUG
+        #define PROFILER_ENABLED 1
+    #else
+        #define PROFILER_ENABLED 0
+    #endif
+#endif
+
+/** Statistics of one zone in the zone tree of a frame. */
+typedef struct profiler_zone_stats {
+    const char* name;
+    // Index of the parent zone, or INVALID_ID for a thread's outermost zones.
+    u32 parent;
+    u32 depth;
+    // Index of the thread, in order of first use. The main thread is usually 0.
+    u32 thread_index;
+    // Number of times the zone ended this frame.
+    u32 call_count;
+    // Time spent in the zone, including child zones.
+    f64 total_ms;
+    // Time spent in the zone, excluding child zones.
+    f64 self_ms;
+} profiler_zone_stats;
+
+/** GPU time of a region, as measured by the renderer. */
+typedef struct profiler_gpu_zone {
+    const char* name;
+    // Nesting depth within the GPU frame.
+    u32 depth;
+    f64 milliseconds;
+} profiler_gpu_zone;
+
+/**
+ * @brief Initializes the profiler. Call twice; once with state = 0 to get required memory size,
+ * then a second time passing allocated memory to state. Zones before this are ignored.
+ *
+ * @param memory_requirement A pointer to hold the required memory size of internal state.
+ * @param state 0 if just requesting memory requirement, otherwise allocated block of memory.
+ * @returns True on success; otherwise false.
+ */
+API b8 profiler_initialize(u64* memory_requirement, void* state);
+
+/**
+ * Frees all thread buffers. Zones after this are ignored.
+ */
+API void profiler_shutdown(void* state);
+
+/**
+ * Names the calling thread in exported traces.
+ * @param name The name, copied.
+ */
+API void profiler_set_thread_name(const char* name);
+
+/**
+ * Begins a zone on the calling thread. Prefer PROFILE_SCOPE.
+ * @param name The zone name. Must outlive the profiler, e.g. a string literal.
+ */
+API void profiler_zone_begin(const char* name);
+
+/**
+ * Ends the zone most recently begun on the calling thread.
+ */
+API void profiler_zone_end();
+
+/**
+ * Gathers the events written by all threads since the last call into the zone
+ * tree of the frame just finished. Call once per frame from one thread.
+ */
+API void profiler_frame_end();
+
+/**
+ * Gets the zone tree of the last finished frame. Parents come before their children.
+ * @param out_count A pointer to hold the number of zones.
+ * @returns The zones; valid until the next profiler_frame_end.
+ */
+API const profiler_zone_stats* profiler_frame_zones(u32* out_count);
+
+/**
+ * Records the GPU time of a region. GPU results arrive a few frames after the
+ * work was submitted; they are reported with the frame in which they arrive.
+ * May be called from any thread.
+ * @param name The region name. Must outlive the profiler, e.g. a string literal.
+ * @param depth The nesting depth of the region.
+ * @param milliseconds The time the GPU spent in the region.
+ */
+API void profiler_record_gpu_zone(const char* name, u32 depth, f64 milliseconds);
+
+/**
+ * Gets the GPU regions reported during the last finished frame, in the order recorded.
+ * @param out_count A pointer to hold the number of regions.
+ * @returns The regions; valid until the next profiler_frame_end.
+ */
+API const profiler_gpu_zone* profiler_frame_gpu_zones(u32* out_count);
+
+/**
+ * Logs the zone tree and GPU regions of the last finished frame.
+ */
+API void profiler_log_frame();
+
+/**
+ * Writes the events still held in the thread buffers (roughly the last few
+ * seconds) as a Chrome trace event JSON file.
+ * @param path The path of the file to write.
+ * @returns True on success; otherwise false.
+ */
+API b8 profiler_export_chrome_trace(const char* path);
+
+#if PROFILER_ENABLED
+
+typedef struct profiler_scope {
+    const char* name;
+} profiler_scope;
+
+VINLINE profiler_scope profiler_scope_begin(const char* name) {
+    profiler_zone_begin(name);
+    return (profiler_scope){name};
+}
+
+VINLINE void profiler_scope_end(profiler_scope* scope) {
+    profiler_zone_end();
+}
+
+#define PROFILE_CONCAT_INNER(a, b) a##b
+#define PROFILE_CONCAT(a, b) PROFILE_CONCAT_INNER(a, b)
+
+/**
+ * Times the rest of the enclosing block as a zone.
+ */
+#define PROFILE_SCOPE(name) \
+    profiler_scope PROFILE_CONCAT(profile_scope_, __LINE__) __attribute__((cleanup(profiler_scope_end))) = profiler_scope_begin(name)
+
+/** Begins a zone ended by PROFILE_END, for sections that aren't a block. */
+#define PROFILE_BEGIN(name) profiler_zone_begin(name)
+#define PROFILE_END() profiler_zone_end()
+
+#else
+
+#define PROFILE_SCOPE(name)
+#define PROFILE_BEGIN(name)
+#define PROFILE_END()
+
+#endif
@@ -0,0 +1,365 @@
+#include "core/task_system.h"
+
+#include "core/logger.h"
+#include "core/vmemory.h"
+#include "platform/vatomic.h"
+#include "platform/vfiber.h"
+#include "platform/vthread.h"
+
+/*
+ * Every run of a task on a fiber is a job: it switches from the thread's own
+ * fiber to the task's, and gets control back once the task finishes or
+ * suspends. Only then is a suspended fiber put on the wait list, so no other
+ * thread can resume it before its context has been saved.
+ *
+ * Fiber code may move between threads at any suspension, so nothing here reads
+ * thread-local state in a task after it has been resumed.
+ */
+
+#define TASK_DEFAULT_MAX_FIBERS 1024
+#define TASK_DEFAULT_STACK_SIZE (64 * 1024)
+// Tasks waiting for a free fiber.
+#define TASK_MAX_QUEUED 4096
+// Fibers resumed per pass over the wait list.
+#define TASK_RESUME_BATCH 64
+
+typedef enum task_fiber_status {
+    TASK_FIBER_STATUS_RUNNING,
+    TASK_FIBER_STATUS_WAITING,
+    TASK_FIBER_STATUS_DONE
+} task_fiber_status;
+
+typedef struct task {
+    pfn_task_entry entry;
+    void* params;
+    job_priority priority;
+    job_counter* counter;
+} task;
+
+typedef struct task_fiber {
+    // Created on first use.
+    vfiber fiber;
+    task task;
+    task_fiber_status status;
+    // Resumes to low priority, so a yielding task lets other work go first.
+    b8 yielding;
+    // The wait the task is suspended on.
+    pfn_task_poll poll;
+    void* poll_data;
+    // The fiber that switched to this one, to switch back to.
+    vfiber* return_fiber;
+} task_fiber;
+
+typedef struct task_system_state {
+    u32 max_fibers;
+    u64 stack_size;
+    task_fiber* fibers;
+
+    // Guards the free list and the queue.
+    vspinlock free_lock;
+    u32 free_count;
+    u32* free_list;
+    u32 queued_head;
+    u32 queued_count;
+    task queued[TASK_MAX_QUEUED];
+
+    vspinlock wait_lock;
+    u32 waiting_count;
+    u32* waiting;
+} task_system_state;
+
+static task_system_state* state_ptr;
+
+// The task running on the calling thread, if any.
+static _Thread_local task_fiber* tls_current_task = 0;
+
+static void resume_job(void* params);
+
+static void submit_resume(task_fiber* tf) {
+    job_desc desc;
+    desc.entry = resume_job;
+    desc.params = tf;
+    desc.priority = tf->yielding ? JOB_PRIORITY_LOW : tf->task.priority;
+    tf->yielding = false;
+    job_submit(&desc, 1, 0);
+}
+
+static void fiber_main(void* params) {
+    task_fiber* tf = params;
+    // Fibers are reused; each pass runs one task.
+    for (;;) {
+        tf->task.entry(tf->task.params);
+        tf->status = TASK_FIBER_STATUS_DONE;
+        vfiber_switch(&tf->fiber, tf->return_fiber);
+    }
+}
+
+/**
+ * Starts the task on the fiber, creating the fiber first if needed.
+ */
+static b8 start_task(task_fiber* tf, const task* t) {
+    if (!tf->fiber.internal_data && !vfiber_create(state_ptr->stack_size, fiber_main, tf, &tf->fiber)) {
+        ERROR("task_spawn - failed to create a fiber.");
+        return false;
+    }
+    tf->task = *t;
+    tf->status = TASK_FIBER_STATUS_RUNNING;
+    tf->poll = 0;
+    tf->poll_data = 0;
+    submit_resume(tf);
+    return true;
+}
+
+static void release_fiber(task_fiber* tf) {
+    u32 index = (u32)(tf - state_ptr->fibers);
+    vspinlock_lock(&state_ptr->free_lock);
+    state_ptr->free_list[state_ptr->free_count++] = index;
+    vspinlock_unlock(&state_ptr->free_lock);
+}
+
+static void finish_task(task_fiber* tf) {
+    job_counter* counter = tf->task.counter;
+
+    // Hand the fiber straight to the next queued task, if any.
+    task next;
+    b8 has_next = false;
+    vspinlock_lock(&state_ptr->free_lock);
+    if (state_ptr->queued_count > 0) {
+        next = state_ptr->queued[state_ptr->queued_head];
+        state_ptr->queued_head = (state_ptr->queued_head + 1) % TASK_MAX_QUEUED;
+        state_ptr->queued_count--;
+        has_next = true;
+    } else {
+        state_ptr->free_list[state_ptr->free_count++] = (u32)(tf - state_ptr->fibers);
+    }
+    vspinlock_unlock(&state_ptr->free_lock);
+
+    if (has_next) {
+        // The fiber already exists, so this can't fail.
+        start_task(tf, &next);
+    }
+    if (counter) {
+        job_counter_decrement(counter);
+    }
+}
+
+static void resume_job(void* params) {
+    task_fiber* tf = params;
+
+    // A task waiting in job_wait may run this; the resumed task then returns into it.
+    task_fiber* outer = tls_current_task;
+    vfiber* from = outer ? &outer->fiber : job_thread_fiber();
+    vfiber temporary = {};
+    if (!from) {
+        // Not a job thread; only becomes a fiber for the duration.
+        if (!vfiber_from_current_thread(&temporary)) {
+            FATAL("Could not switch to a task; the thread cannot become a fiber.");
+            return;
+        }
+        from = &temporary;
+    }
+
+    tf->return_fiber = from;
+    tls_current_task = tf;
+    vfiber_switch(from, &tf->fiber);
+    tls_current_task = outer;
+
+    if (temporary.internal_data) {
+        vfiber_release_thread(&temporary);
+    }
+
+    if (tf->status == TASK_FIBER_STATUS_DONE) {
+        finish_task(tf);
+    } else {
+        vspinlock_lock(&state_ptr->wait_lock);
+        state_ptr->waiting[state_ptr->waiting_count++] = (u32)(tf - state_ptr->fibers);
+        vspinlock_unlock(&state_ptr->wait_lock);
+    }
+    task_system_poll();
+}
+
+static b8 counter_is_zero(void* data) {
+    return vatomic_load_u32(&((job_counter*)data)->value, VMEMORY_ORDER_ACQUIRE) == 0;
+}
+
+static b8 always_ready(void* data) {
+    return true;
+}
+
+b8 task_system_initialize(u64* memory_requirement, void* state, u32 max_fibers, u64 stack_size) {
+    if (max_fibers == 0) {
+        max_fibers = TASK_DEFAULT_MAX_FIBERS;
+    }
+    if (stack_size == 0) {
+        stack_size = TASK_DEFAULT_STACK_SIZE;
+    }
+
+    *memory_requirement = sizeof(task_system_state) + (sizeof(task_fiber) + sizeof(u32) * 2) * max_fibers;
+    if (state == 0) {
+        return true;
+    }
+
+    vzero_memory(state, *memory_requirement);
+    state_ptr = state;
+    state_ptr->max_fibers = max_fibers;
+    state_ptr->stack_size = stack_size;
+    state_ptr->fibers = (task_fiber*)((u8*)state + sizeof(task_system_state));
+    state_ptr->free_list = (u32*)(state_ptr->fibers + max_fibers);
+    state_ptr->waiting = state_ptr->free_list + max_fibers;
+
+    // Reversed, so the lowest fibers are used (and created) first.
+    for (u32 i = 0; i < max_fibers; ++i) {
+        state_ptr->free_list[i] = max_fibers - 1 - i;
+    }
+    state_ptr->free_count = max_fibers;
+
+    INFO("Task system initialized with up to %u fibers of %llu KiB.", max_fibers, stack_size / 1024);
+    return true;
+}
+
+void task_system_shutdown(void* state) {
+    if (!state_ptr) {
+        return;
+    }
+
+    if (state_ptr->waiting_count > 0) {
+        WARN("Task system shutting down with %u tasks still waiting.", state_ptr->waiting_count);
+    }
+    for (u32 i = 0; i < state_ptr->max_fibers; ++i) {
+        vfiber_destroy(&state_ptr->fibers[i].fiber);
+    }
+    state_ptr = 0;
+}
+
+b8 task_spawn(pfn_task_entry entry, void* params, job_priority priority, job_counter* counter) {
+    if (!state_ptr) {
+        // No task system; run serially.
+        entry(params);
+        return true;
+    }
+
+    task t;
+    t.entry = entry;
+    t.params = params;
+    t.priority = priority < JOB_PRIORITY_COUNT ? priority : JOB_PRIORITY_NORMAL;
+    t.counter = counter;
+    if (counter) {
+        job_counter_increment(counter, 1);
+    }
+
+    task_fiber* tf = 0;
+    b8 queued = false;
+    vspinlock_lock(&state_ptr->free_lock);
+    if (state_ptr->free_count > 0) {
+        tf = &state_ptr->fibers[state_ptr->free_list[--state_ptr->free_count]];
+    } else if (state_ptr->queued_count < TASK_MAX_QUEUED) {
+        state_ptr->queued[(state_ptr->queued_head + state_ptr->queued_count) % TASK_MAX_QUEUED] = t;
+        state_ptr->queued_count++;
+        queued = true;
+    }
+    vspinlock_unlock(&state_ptr->free_lock);
+
+    if (queued) {
+        return true;
+    }
+    if (tf && start_task(tf, &t)) {
+        return true;
+    }
+
+    if (tf) {
+        release_fiber(tf);
+    } else {
+        WARN("task_spawn - all fibers busy and the queue is full.");
+    }
+    if (counter) {
+        job_counter_decrement(counter);
+    }
+    return false;
+}
+
+void task_wait_until(pfn_task_poll poll, void* data) {
+    if (poll(data)) {
+        return;
+    }
+
+    task_fiber* tf = tls_current_task;
+    if (!tf) {
+        u32 idle_spins = 0;
+        while (!poll(data)) {
+            task_system_poll();
+            if (job_run_one()) {
+                idle_spins = 0;
+            } else if (++idle_spins < 256) {
+                vatomic_cpu_relax();
+            } else {
+                vthread_yield();
+                idle_spins = 0;
+            }
+        }
+        return;
+    }
+
+    tf->poll = poll;
+    tf->poll_data = data;
+    tf->status = TASK_FIBER_STATUS_WAITING;
+    vfiber_switch(&tf->fiber, tf->return_fiber);
+    // Resumed, maybe on another thread; see the note at the top.
+}
+
+void task_wait_counter(job_counter* counter) {
+    if (counter) {
+        task_wait_until(counter_is_zero, counter);
+    }
+}
+
+void task_yield() {
+    task_fiber* tf = tls_current_task;
+    if (!tf) {
+        return;
+    }
+    tf->yielding = true;
+    tf->poll = always_ready;
+    tf->poll_data = 0;
+    tf->status = TASK_FIBER_STATUS_WAITING;
+    vfiber_switch(&tf->fiber, tf->return_fiber);
+}
+
+void task_system_poll() {
+    // Several threads finishing tasks at once only need one of them to poll.
+    if (!state_ptr || !vspinlock_try_lock(&state_ptr->wait_lock)) {
+        return;
+    }
+
+    task_fiber* ready[TASK_RESUME_BATCH];
+    u32 ready_count;
+    b8 locked = true;
+    do {
+        if (!locked) {
+            vspinlock_lock(&state_ptr->wait_lock);
+        }
+        ready_count = 0;
+        u32 i = 0;
+        while (i < state_ptr->waiting_count && ready_count < TASK_RESUME_BATCH) {
+            task_fiber* tf = &state_ptr->fibers[state_ptr->waiting[i]];
+            if (tf->poll(tf->poll_data)) {
+                tf->status = TASK_FIBER_STATUS_RUNNING;
+                ready[ready_count++] = tf;
+                // Swap-remove; the list is unordered.
+                state_ptr->waiting[i] = state_ptr->waiting[--state_ptr->waiting_count];
+            } else {
+                ++i;
+            }
+        }
+        vspinlock_unlock(&state_ptr->wait_lock);
+        locked = false;
+
+        // Submitted outside the lock; a full job queue runs resumes inline, which take it again.
+        for (u32 r = 0; r < ready_count; ++r) {
+            submit_resume(ready[r]);
+        }
+    } while (ready_count == TASK_RESUME_BATCH);
+}
+
+b8 task_is_running() {
+    return tls_current_task != 0;
+}
@@ -0,0 +1,89 @@
+#pragma once
+
+#include "defines.h"
+#include "core/job_system.h"
+
+/*
+ * Tasks are like jobs, but run on fibers from a pool so they can wait without
+ * blocking their thread. A waiting task is suspended and its thread goes back
+ * to running other jobs; the task is resumed, possibly on another thread, once
+ * the thing it waits for has happened. This suits work dominated by waits, such
+ * as asset loading, where thousands can be in flight on a handful of threads.
+ *
+ * Waits are checked by task_system_poll, which runs whenever a task finishes or
+ * suspends and once per frame from the application loop.
+ */
+
+/**
+ * Entry point of a task.
+ * @param params The params given to task_spawn.
+ */
+typedef void (*pfn_task_entry)(void* params);
+
+/**
+ * Checks whether a waiting task can continue, e.g. whether a fence is signalled
+ * or a file read has completed. Called from any thread, with the wait list
+ * locked, so it must be quick and must not block.
+ * @param data The data given to task_wait_until.
+ * @returns True once the wait is over; otherwise false.
+ */
+typedef b8 (*pfn_task_poll)(void* data);
+
+/**
+ * @brief Initializes the task system. Call twice; once with state = 0 to get required memory size,
+ * then a second time passing allocated memory to state. Initialize the job system first.
+ *
+ * @param memory_requirement A pointer to hold the required memory size of internal state.
+ * @param state 0 if just requesting memory requirement, otherwise allocated block of memory.
+ * @param max_fibers The number of tasks that can be running or waiting at once, or 0 for the
+ * default. Fibers are created as needed; further tasks are queued until one frees up.
+ * @param stack_size The stack size of each fiber in bytes, or 0 for the default.
+ * @returns True on success; otherwise false.
+ */
+API b8 task_system_initialize(u64* memory_requirement, void* state, u32 max_fibers, u64 stack_size);
+
+/**
+ * Destroys all fibers. Call after the job system has been shut down; tasks
+ * still waiting are abandoned.
+ */
+API void task_system_shutdown(void* state);
+
+/**
+ * Starts a task on a fiber, or queues it if all fibers are in use.
+ * @param entry The function to run.
+ * @param params Passed to entry.
+ * @param priority The priority of the jobs which run the task.
+ * @param counter Incremented now, and decremented once the task finishes. May be 0.
+ * @returns True if the task was started or queued; false if the queue is full.
+ */
+API b8 task_spawn(pfn_task_entry entry, void* params, job_priority priority, job_counter* counter);
+
+/**
+ * Waits until poll returns true. Inside a task, the task is suspended and its
+ * thread runs other work meanwhile. Elsewhere, the calling thread runs jobs
+ * while waiting, like job_wait.
+ * @param poll The function checking whether the wait is over.
+ * @param data Passed to poll.
+ */
+API void task_wait_until(pfn_task_poll poll, void* data);
+
+/**
+ * Waits until the counter reaches zero. Use this rather than job_wait inside a
+ * task, so the task is suspended instead of tying up its thread.
+ * @param counter The counter to wait on.
+ */
+API void task_wait_counter(job_counter* counter);
+
+/**
+ * Suspends the calling task to let other work run; it is resumed on the next
+ * poll. Does nothing outside a task.
+ */
+API void task_yield();
+
+/**
+ * Resumes the waiting tasks whose waits are over.
+ */
+API void task_system_poll();
+
+/** @returns True if the caller is running inside a task. */
+API b8 task_is_running();
@@ -0,0 +1,263 @@
+#include "core/timer.h"
+
+#include "core/asserts.h"
+#include "core/vmemory.h"
+#include "core/logger.h"
+
+/*
+ * Hierarchical timing wheel. Level 0 has one slot per tick (1ms), each level
+ * above covers 256 times the range of the one below, giving a total range of
+ * 2^32 ticks (~49 days). A timer is placed in the lowest level able to hold
+ * its deadline; when a level-0 lap completes, the next slot of the level above
+ * is cascaded down. Insert and cancel are O(1), and a frame only touches the
+ * slots for the ticks that elapsed.
+ */
+
+#define TIMER_WHEEL_BITS 8
+#define TIMER_WHEEL_SLOTS (1 << TIMER_WHEEL_BITS)
+#define TIMER_WHEEL_MASK (TIMER_WHEEL_SLOTS - 1)
+#define TIMER_WHEEL_LEVELS 4
+#define TIMER_MAX_DELTA_TICKS 0xFFFFFFFFULL
+
+#define MAX_TIMERS 4096
+
+typedef struct timer_node {
+    u64 expiry_tick;
+    // 0 for one-shot timers.
+    u64 period_ticks;
+    // Intrusive doubly-linked list through the bucket the timer is in.
+    u32 prev;
+    u32 next;
+    // Bucket index (level * TIMER_WHEEL_SLOTS + slot), or INVALID_ID when not in the wheel.
+    u32 bucket;
+    u32 generation;
+    b8 in_use;
+
+    u16 code;
+    void* sender;
+    event_context context;
+} timer_node;
+
+typedef struct timer_system_state {
+    // Last tick processed. Starts at 0 along with the application clock.
+    u64 current_tick;
+    // The time passed to the last update.
+    f64 current_time;
+    u32 active_count;
+    u32 first_free;
+    u32 buckets[TIMER_WHEEL_LEVELS * TIMER_WHEEL_SLOTS];
+    timer_node nodes[MAX_TIMERS];
+} timer_system_state;
+
+static timer_system_state* state_ptr;
+
+void timer_system_initialize(u64* memory_requirement, void* state) {
+    *memory_requirement = sizeof(timer_system_state);
+    if (state == 0) {
+        return;
+    }
+    vzero_memory(state, sizeof(timer_system_state));
+    state_ptr = state;
+
+    for (u32 i = 0; i < TIMER_WHEEL_LEVELS * TIMER_WHEEL_SLOTS; ++i) {
+        state_ptr->buckets[i] = INVALID_ID;
+    }
+    for (u32 i = 0; i < MAX_TIMERS; ++i) {
+        state_ptr->nodes[i].generation = 1;
+        state_ptr->nodes[i].bucket = INVALID_ID;
+        state_ptr->nodes[i].next = (i + 1 < MAX_TIMERS) ? i + 1 : INVALID_ID;
+    }
+    state_ptr->first_free = 0;
+}
+
+void timer_system_shutdown(void* state) {
+    state_ptr = 0;
+}
+
+static void link_node(u32 index) {
+    timer_node* node = &state_ptr->nodes[index];
+    // timer_schedule and periodic re-links always expire after the current tick. Cascading may
+    // link a timer due on the current tick, which is fine: cascades run before that tick's slot
+    // is expired. Anything earlier would sit in a processed slot for a whole lap.
+    ASSERT_MSG(node->expiry_tick >= state_ptr->current_tick, "Timer linked with an expiry in the past.");
+    u64 delta = node->expiry_tick - state_ptr->current_tick;
+    if (delta > TIMER_MAX_DELTA_TICKS) {
+        delta = TIMER_MAX_DELTA_TICKS;
+        node->expiry_tick = state_ptr->current_tick + delta;
+    }
+
+    u32 level = 0;
+    while (level < TIMER_WHEEL_LEVELS - 1 && delta >= (1ULL << (TIMER_WHEEL_BITS * (level + 1)))) {
+        ++level;
+    }
+    u32 slot = (u32)(node->expiry_tick >> (TIMER_WHEEL_BITS * level)) & TIMER_WHEEL_MASK;
+    u32 bucket = level * TIMER_WHEEL_SLOTS + slot;
+
+    node->bucket = bucket;
+    node->prev = INVALID_ID;
+    node->next = state_ptr->buckets[bucket];
+    if (node->next != INVALID_ID) {
+        state_ptr->nodes[node->next].prev = index;
+    }
+    state_ptr->buckets[bucket] = index;
+}
+
+static void unlink_node(u32 index) {
+    timer_node* node = &state_ptr->nodes[index];
+    if (node->prev != INVALID_ID) {
+        state_ptr->nodes[node->prev].next = node->next;
+    } else {
+        state_ptr->buckets[node->bucket] = node->next;
+    }
+    if (node->next != INVALID_ID) {
+        state_ptr->nodes[node->next].prev = node->prev;
+    }
+    node->prev = INVALID_ID;
+    node->next = INVALID_ID;
+    node->bucket = INVALID_ID;
+}
+
+static void free_node(u32 index) {
+    timer_node* node = &state_ptr->nodes[index];
+    node->in_use = false;
+    node->generation++;
+    node->next = state_ptr->first_free;
+    state_ptr->first_free = index;
+    state_ptr->active_count--;
+}
+
+/**
+ * Moves every timer in the given bucket down to a lower level.
+ */
+static void cascade(u32 level, u32 slot) {
+    u32 bucket = level * TIMER_WHEEL_SLOTS + slot;
+    u32 index = state_ptr->buckets[bucket];
+    state_ptr->buckets[bucket] = INVALID_ID;
+    while (index != INVALID_ID) {
+        u32 next = state_ptr->nodes[index].next;
+        link_node(index);
+        index = next;
+    }
+}
+
+static void expire_bucket(u32 slot) {
+    // Detach the whole list first, periodic timers are re-linked as we go.
+    u32 index = state_ptr->buckets[slot];
+    state_ptr->buckets[slot] = INVALID_ID;
+    while (index != INVALID_ID) {
+        timer_node* node = &state_ptr->nodes[index];
+        u32 next = node->next;
+        node->bucket = INVALID_ID;
+
+        event_post(node->code, node->sender, node->context);
+
+        if (node->period_ticks) {
+            node->expiry_tick += node->period_ticks;
+            link_node(index);
+        } else {
+            free_node(index);
+        }
+        index = next;
+    }
+}
+
+static u64 seconds_to_ticks(f64 seconds) {
+    if (seconds <= 0) {
+        return 0;
+    }
+    // Round up so a timer never fires early.
+    f64 ticks = seconds / TIMER_TICK_SECONDS;
+    u64 whole = (u64)ticks;
+    return (ticks > (f64)whole) ? whole + 1 : whole;
+}
+
+void timer_system_update(f64 current_time) {
+    if (!state_ptr) {
+        return;
+    }
+
+    state_ptr->current_time = current_time;
+    u64 target_tick = (u64)(current_time / TIMER_TICK_SECONDS);
+    if (state_ptr->active_count == 0) {
+        // Nothing to expire or cascade, skip straight ahead.
+        if (target_tick > state_ptr->current_tick) {
+            state_ptr->current_tick = target_tick;
+        }
+        return;
+    }
+
+    while (state_ptr->current_tick < target_tick) {
+        state_ptr->current_tick++;
+        u64 tick = state_ptr->current_tick;
+
+        // At the end of each lap of a level, pull the next slot of the level above down.
+        for (u32 level = 1; level < TIMER_WHEEL_LEVELS; ++level) {
+            if ((tick & ((1ULL << (TIMER_WHEEL_BITS * level)) - 1)) != 0) {
+                break;
+            }
+            cascade(level, (u32)(tick >> (TIMER_WHEEL_BITS * level)) & TIMER_WHEEL_MASK);
+        }
+
+        expire_bucket((u32)tick & TIMER_WHEEL_MASK);
+    }
+}
+
+timer_handle timer_schedule(f64 delay_seconds, f64 period_seconds, u16 code, void* sender, event_context context) {
+    if (!state_ptr) {
+        return INVALID_TIMER_HANDLE;
+    }
+    if (state_ptr->first_free == INVALID_ID) {
+        ERROR("timer_schedule - out of timer slots (max %u).", MAX_TIMERS);
+        return INVALID_TIMER_HANDLE;
+    }
+
+    u32 index = state_ptr->first_free;
+    timer_node* node = &state_ptr->nodes[index];
+    state_ptr->first_free = node->next;
+    state_ptr->active_count++;
+
+    u64 delay_ticks = seconds_to_ticks(delay_seconds);
+    node->in_use = true;
+    // The current tick has already been processed, so the earliest possible expiry is the next one.
+    node->expiry_tick = state_ptr->current_tick + (delay_ticks ? delay_ticks : 1);
+    node->period_ticks = seconds_to_ticks(period_seconds);
+    if (period_seconds > 0 && node->period_ticks == 0) {
+        node->period_ticks = 1;
+    }
+    node->code = code;
+    node->sender = sender;
+    node->context = context;
+    link_node(index);
+
+    return ((u64)node->generation << 32) | index;
+}
+
+b8 timer_cancel(timer_handle handle) {
+    if (!state_ptr) {
+        return false;
+    }
+
+    u32 index = (u32)(handle & 0xFFFFFFFF);
+    u32 generation = (u32)(handle >> 32);
+    if (index >= MAX_TIMERS) {
+        return false;
+    }
+    timer_node* node = &state_ptr->nodes[index];
+    if (!node->in_use || node->generation != generation) {
+        return false;
+    }
+
+    if (node->bucket != INVALID_ID) {
+        unlink_node(index);
+    }
+    free_node(index);
+    return true;
+}
+
+f64 timer_system_time() {
+    return state_ptr ? state_ptr->current_time : 0;
+}
+
+u32 timer_active_count() {
+    return state_ptr ? state_ptr->active_count : 0;
+}
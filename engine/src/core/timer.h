@@ -0,0 +1,63 @@
+#pragma once
+
+#include "defines.h"
+#include "core/event.h"
+
+/**
+ * Identifies a scheduled timer. Stale handles (expired or cancelled) are
+ * detected and rejected.
+ */
+typedef u64 timer_handle;
+
+#define INVALID_TIMER_HANDLE 0
+
+/** The timer resolution, in seconds. */
+#define TIMER_TICK_SECONDS 0.001
+
+/**
+ * @brief Initializes the timer system. Call twice; once with state = 0 to get required memory size,
+ * then a second time passing allocated memory to state.
+ *
+ * @param memory_requirement A pointer to hold the required memory size of internal state.
+ * @param state 0 if just requesting memory requirement, otherwise allocated block of memory.
+ */
+API void timer_system_initialize(u64* memory_requirement, void* state);
+API void timer_system_shutdown(void* state);
+
+/**
+ * Advances the timer wheel to the given time, posting an event for every timer
+ * that expired. Called once per frame by the application, before pending
+ * events are dispatched.
+ * @param current_time The current time in seconds, as reported by the application clock.
+ */
+API void timer_system_update(f64 current_time);
+
+/**
+ * @return The time passed to the last timer_system_update, in seconds.
+ */
+API f64 timer_system_time();
+
+/**
+ * Schedules a timer which posts an event (see event_post) when it expires.
+ * Timers have a resolution of 1ms and expire on the first frame at or after
+ * their deadline.
+ * @param delay_seconds Time from now until the first expiry.
+ * @param period_seconds Time between expiries for periodic timers, or 0 for a one-shot timer.
+ * @param code The event code to post on expiry.
+ * @param sender The sender passed to listeners.
+ * @param context The event data passed to listeners.
+ * @return A handle to the timer, or INVALID_TIMER_HANDLE if no timer slots are available.
+ */
+API timer_handle timer_schedule(f64 delay_seconds, f64 period_seconds, u16 code, void* sender, event_context context);
+
+/**
+ * Cancels a pending timer in constant time.
+ * @param handle The handle returned by timer_schedule.
+ * @return true if cancelled; false if the handle is invalid or the (one-shot) timer already expired.
+ */
+API b8 timer_cancel(timer_handle handle);
+
+/**
+ * @return The number of currently scheduled timers.
+ */
+API u32 timer_active_count();
@@ -3,6 +3,7 @@
 #include "core/logger.h"
 #include "core/vstring.h"
 #include "platform/platform.h"
+#include "platform/vatomic.h"
 
 #include <stdio.h>
 #include <string.h>
@@ -60,9 +61,10 @@ void* vallocate(u64 size, memory_tag tag) {
     }
 
     if (state_ptr) {
-        state_ptr->stats.total_allocated += size;
-        state_ptr->stats.tagged_allocations[tag] += size;
-        state_ptr->alloc_count++;
+        // Atomic, as the render thread and job workers allocate too. Relaxed; these are only counters.
+        vatomic_fetch_add_u64(&state_ptr->stats.total_allocated, size, VMEMORY_ORDER_RELAXED);
+        vatomic_fetch_add_u64(&state_ptr->stats.tagged_allocations[tag], size, VMEMORY_ORDER_RELAXED);
+        vatomic_fetch_add_u64(&state_ptr->alloc_count, 1, VMEMORY_ORDER_RELAXED);
     }
 
     void* block = platform_allocate(size, false);
@@ -76,8 +78,8 @@ void vfree(void* block, u64 size, memory_tag tag) {
     }
 
     if (state_ptr) {
-        state_ptr->stats.total_allocated -= size;
-        state_ptr->stats.tagged_allocations[tag] -= size;
+        vatomic_fetch_sub_u64(&state_ptr->stats.total_allocated, size, VMEMORY_ORDER_RELAXED);
+        vatomic_fetch_sub_u64(&state_ptr->stats.tagged_allocations[tag], size, VMEMORY_ORDER_RELAXED);
     }
 
     platform_free(block, false);
@@ -106,19 +108,20 @@ char* get_memory_usage_str() {
     for (u32 i=0; i<MEMORY_TAG_MAX_TAGS; i++) {
         char unit[4] = "xiB";
         float amount = 1.0f;
-        if (state_ptr->stats.tagged_allocations[i] > gib) {
+        u64 allocated = vatomic_load_u64(&state_ptr->stats.tagged_allocations[i], VMEMORY_ORDER_RELAXED);
+        if (allocated > gib) {
             unit[0] = 'G';
-            amount = state_ptr->stats.tagged_allocations[i] / (float)gib;
-        } else if (state_ptr->stats.tagged_allocations[i] > mib) {
+            amount = allocated / (float)gib;
+        } else if (allocated > mib) {
             unit[0] = 'M';
-            amount = state_ptr->stats.tagged_allocations[i] / (float)mib;
-        } else if (state_ptr->stats.tagged_allocations[i] > kib) {
+            amount = allocated / (float)mib;
+        } else if (allocated > kib) {
             unit[0] = 'K';
-            amount = state_ptr->stats.tagged_allocations[i] / (float)kib;
+            amount = allocated / (float)kib;
         } else {
             unit[0] = 'B';
             unit[1] = 0;
-            amount = (float)state_ptr->stats.tagged_allocations[i];
+            amount = (float)allocated;
         }
         i32 length = snprintf(buffer + offset, 8192 - offset, "  %s: %.2f %s\n", memory_tag_strings[i], amount, unit);
         offset += length;
@@ -129,7 +132,18 @@ char* get_memory_usage_str() {
 
 u64 get_memory_alloc_count() {
     if (state_ptr) {
-        return state_ptr->alloc_count;
+        return vatomic_load_u64(&state_ptr->alloc_count, VMEMORY_ORDER_RELAXED);
     }
     return 0;
+}
+
+u64 get_memory_tag_usage(memory_tag tag) {
+    if (state_ptr && tag < MEMORY_TAG_MAX_TAGS) {
+        return vatomic_load_u64(&state_ptr->stats.tagged_allocations[tag], VMEMORY_ORDER_RELAXED);
+    }
+    return 0;
+}
+
+const char* get_memory_tag_name(memory_tag tag) {
+    return tag < MEMORY_TAG_MAX_TAGS ? memory_tag_strings[tag] : "INVALID            ";
 }
\ No newline at end of file
@@ -34,4 +34,16 @@ API void* vzero_memory(void* block, u64 size);
 API void* vcopy_memory(void* dest, const void* src, u64 size);
 API void* vset_memory(void* dest, i32 value, u64 size);
 API char* get_memory_usage_str();
-API u64 get_memory_alloc_count();
\ No newline at end of file
+API u64 get_memory_alloc_count();
+
+/**
+ * @param tag The tag.
+ * @returns The bytes currently allocated with the tag.
+ */
+API u64 get_memory_tag_usage(memory_tag tag);
+
+/**
+ * @param tag The tag.
+ * @returns The tag's name, padded with spaces for aligned output.
+ */
+API const char* get_memory_tag_name(memory_tag tag);
\ No newline at end of file
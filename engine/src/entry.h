@@ -31,5 +31,5 @@ int main(void) {
         return 2;
     }
 
-    return 0;
+    return application_get_exit_code();
 }
\ No newline at end of file
@@ -6,7 +6,13 @@ typedef struct game {
     app_config config;
     b8 (*initialize) (struct game* game_inst);
     b8 (*update) (struct game* game_inst, f32 delta_time);
-    b8 (*render) (struct game* game_inst, f32 delta_time);
+    /**
+     * @param delta_time The time since the last frame, in seconds.
+     * @param alpha How far between the last two updates this frame is, from 0 to 1. Used to
+     * interpolate state when running a fixed timestep (see app_config.fixed_update_rate);
+     * always 1 otherwise.
+     */
+    b8 (*render) (struct game* game_inst, f32 delta_time, f32 alpha);
     void (*on_resize) (struct game* game_inst, u32 width, u32 height);
 
     void* state;
@@ -46,7 +46,8 @@ void* linear_allocator_allocate(linear_allocator* allocator, u64 size) {
 
 void linear_allocator_free_all(linear_allocator* allocator) {
     if (allocator && allocator->memory) {
+        // Only the used range can be dirty, no need to touch the rest.
+        vzero_memory(allocator->memory, allocator->allocated);
         allocator->allocated = 0;
-        vzero_memory(allocator->memory, allocator->total_size);
     }
 }
\ No newline at end of file
@@ -9,7 +9,8 @@ b8 platform_system_startup(
     i32 x,
     i32 y,
     i32 width,
-    i32 height);
+    i32 height,
+    b8 show_window);
     
 void platform_system_shutdown(void* plat_state);
 b8 platform_pump_messages();
@@ -23,4 +24,78 @@ void* platform_set_memory(void* dest, i32 value, u64 size);
 void platform_console_write(const char* msg, u8 color);
 void platform_console_write_error(const char* msg, u8 color);
 void platform_sleep(u64 ms);
-f64 platform_get_absolute_time();
\ No newline at end of file
+/**
+ * @returns Seconds from an arbitrary fixed point. Usable before platform_system_startup,
+ * so executables without a window can time things.
+ */
+API f64 platform_get_absolute_time();
+/**
+ * Reads the CPU timestamp counter (rdtsc on x86, cntvct_el0 on ARM64). Costs
+ * a few nanoseconds, far less than platform_get_absolute_time, which makes it
+ * suitable for timestamping fine-grained profiling zones. Use
+ * platform_cycles_to_seconds to convert. Falls back to platform_get_absolute_time
+ * in nanoseconds when the CPU has no invariant counter.
+ * @returns The current cycle count.
+ */
+API u64 platform_get_cycles();
+
+/**
+ * Measures the frequency of the cycle counter against the wall clock and checks
+ * that it is invariant (constant rate, unaffected by power states). Called by
+ * platform_system_startup.
+ */
+void platform_cycles_calibrate();
+
+/** @returns True if platform_get_cycles reads an invariant hardware counter. */
+API b8 platform_cycles_invariant();
+
+/** @returns The number of cycles per second of platform_get_cycles. */
+API f64 platform_cycles_frequency();
+
+API f64 platform_cycles_to_seconds(u64 cycles);
+API u64 platform_seconds_to_cycles(f64 seconds);
+
+/**
+ * Processor topology and cache sizes. Cache sizes are those seen by a single
+ * core; a shared cache reports its full size.
+ */
+typedef struct platform_cpu_info {
+    u32 physical_core_count;
+    // Hardware threads; larger than physical_core_count with SMT.
+    u32 logical_core_count;
+    u32 numa_node_count;
+    u32 cache_line_size;
+    u64 l1_data_cache_size;
+    u64 l2_cache_size;
+    u64 l3_cache_size;
+} platform_cpu_info;
+
+/**
+ * Queries processor topology and cache sizes from the OS. Values which could
+ * not be determined are 0, except core and node counts which are at least 1.
+ * @param out_info A pointer to hold the info.
+ * @returns True if the topology could be queried; otherwise false.
+ */
+API b8 platform_get_cpu_info(platform_cpu_info* out_info);
+
+typedef enum platform_thread_priority {
+    PLATFORM_THREAD_PRIORITY_LOW,
+    PLATFORM_THREAD_PRIORITY_NORMAL,
+    PLATFORM_THREAD_PRIORITY_HIGH,
+    PLATFORM_THREAD_PRIORITY_CRITICAL
+} platform_thread_priority;
+
+/**
+ * Restricts the calling thread to the given logical cores.
+ * @param core_mask One bit per logical core; bit 0 is core 0.
+ * @returns True on success; otherwise false.
+ */
+API b8 platform_set_current_thread_affinity(u64 core_mask);
+
+/**
+ * Sets the scheduling priority of the calling thread. Raising priority may
+ * require elevated privileges on some platforms.
+ * @param priority The priority to set.
+ * @returns True on success; otherwise false.
+ */
+API b8 platform_set_current_thread_priority(platform_thread_priority priority);
@@ -0,0 +1,362 @@
+#if defined(__linux__) && !defined(_GNU_SOURCE)
+// For sched_setaffinity and CPU_SET.
+#define _GNU_SOURCE
+#endif
+
+#include "platform/platform.h"
+
+#include "core/logger.h"
+#include "core/vstring.h"
+
+#if PLATFORM_WINDOWS
+#include <windows.h>
+#elif PLATFORM_LINUX
+#include <stdio.h>
+#include <sched.h>
+#include <unistd.h>
+#include <sys/resource.h>
+#include <sys/syscall.h>
+#endif
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define CYCLES_X86 1
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#else
+#include <cpuid.h>
+#include <x86intrin.h>
+#endif
+#elif defined(__aarch64__)
+#define CYCLES_ARM64 1
+#endif
+
+// How long to measure the counter against the wall clock at startup.
+#define CYCLES_CALIBRATION_SECONDS 0.02
+
+typedef struct cycle_counter {
+    b8 invariant;
+    f64 frequency;
+    f64 inverse_frequency;
+} cycle_counter;
+
+// Until calibrated, behaves like the fallback.
+static cycle_counter counter = {false, 1e9, 1e-9};
+
+#if CYCLES_X86
+static void cpuid(u32 leaf, u32 regs[4]) {
+#if defined(_MSC_VER) && !defined(__clang__)
+    __cpuid((int*)regs, (int)leaf);
+#else
+    __cpuid(leaf, regs[0], regs[1], regs[2], regs[3]);
+#endif
+}
+
+static b8 hardware_counter_invariant() {
+    u32 regs[4];
+    cpuid(0x80000000, regs);
+    if (regs[0] < 0x80000007) {
+        return false;
+    }
+    // Advanced power management leaf, EDX bit 8: invariant TSC.
+    cpuid(0x80000007, regs);
+    return (regs[3] & (1 << 8)) != 0;
+}
+
+VINLINE u64 read_hardware_counter() {
+    return __rdtsc();
+}
+#elif CYCLES_ARM64
+static b8 hardware_counter_invariant() {
+    // The generic timer runs at a fixed frequency by definition.
+    return true;
+}
+
+VINLINE u64 read_hardware_counter() {
+    u64 value;
+    __asm__ volatile("mrs %0, cntvct_el0" : "=r"(value));
+    return value;
+}
+#else
+static b8 hardware_counter_invariant() {
+    return false;
+}
+
+VINLINE u64 read_hardware_counter() {
+    return 0;
+}
+#endif
+
+u64 platform_get_cycles() {
+    if (counter.invariant) {
+        return read_hardware_counter();
+    }
+    return (u64)(platform_get_absolute_time() * 1e9);
+}
+
+void platform_cycles_calibrate() {
+    counter.invariant = false;
+    counter.frequency = 1e9;
+    counter.inverse_frequency = 1e-9;
+
+    if (!hardware_counter_invariant()) {
+        WARN("CPU has no invariant cycle counter; platform_get_cycles falls back to the platform clock.");
+        return;
+    }
+
+#if CYCLES_ARM64
+    u64 frequency;
+    __asm__ volatile("mrs %0, cntfrq_el0" : "=r"(frequency));
+    counter.frequency = (f64)frequency;
+#else
+    // Spin rather than sleep; the scheduler could stretch a sleep arbitrarily between the two reads.
+    f64 start_time = platform_get_absolute_time();
+    u64 start_cycles = read_hardware_counter();
+    f64 end_time = start_time;
+    while (end_time - start_time < CYCLES_CALIBRATION_SECONDS) {
+        end_time = platform_get_absolute_time();
+    }
+    u64 end_cycles = read_hardware_counter();
+    if (end_cycles <= start_cycles || end_time <= start_time) {
+        WARN("Cycle counter calibration failed; platform_get_cycles falls back to the platform clock.");
+        return;
+    }
+    counter.frequency = (f64)(end_cycles - start_cycles) / (end_time - start_time);
+#endif
+
+    counter.inverse_frequency = 1.0 / counter.frequency;
+    counter.invariant = true;
+    INFO("Cycle counter: invariant, %.3f MHz.", counter.frequency / 1e6);
+}
+
+b8 platform_cycles_invariant() {
+    return counter.invariant;
+}
+
+f64 platform_cycles_frequency() {
+    return counter.frequency;
+}
+
+f64 platform_cycles_to_seconds(u64 cycles) {
+    return (f64)cycles * counter.inverse_frequency;
+}
+
+u64 platform_seconds_to_cycles(f64 seconds) {
+    return (u64)(seconds * counter.frequency);
+}
+
+#if PLATFORM_WINDOWS
+
+b8 platform_get_cpu_info(platform_cpu_info* out_info) {
+    platform_zero_memory(out_info, sizeof(platform_cpu_info));
+    out_info->physical_core_count = 1;
+    out_info->logical_core_count = 1;
+    out_info->numa_node_count = 1;
+
+    DWORD size = 0;
+    GetLogicalProcessorInformationEx(RelationAll, 0, &size);
+    if (GetLastError() != ERROR_INSUFFICIENT_BUFFER) {
+        return false;
+    }
+    u8* buffer = platform_allocate(size, false);
+    if (!GetLogicalProcessorInformationEx(RelationAll, (PSYSTEM_LOGICAL_PROCESSOR_INFORMATION_EX)buffer, &size)) {
+        platform_free(buffer, false);
+        return false;
+    }
+
+    u32 physical = 0;
+    u32 logical = 0;
+    u32 nodes = 0;
+    for (DWORD offset = 0; offset < size;) {
+        PSYSTEM_LOGICAL_PROCESSOR_INFORMATION_EX entry = (PSYSTEM_LOGICAL_PROCESSOR_INFORMATION_EX)(buffer + offset);
+        switch (entry->Relationship) {
+            case RelationProcessorCore:
+                physical++;
+                for (WORD g = 0; g < entry->Processor.GroupCount; ++g) {
+                    logical += (u32)__builtin_popcountll(entry->Processor.GroupMask[g].Mask);
+                }
+                break;
+            case RelationNumaNode:
+                nodes++;
+                break;
+            case RelationCache: {
+                CACHE_RELATIONSHIP* cache = &entry->Cache;
+                if (cache->Level == 1 && cache->Type == CacheData) {
+                    out_info->l1_data_cache_size = cache->CacheSize;
+                    out_info->cache_line_size = cache->LineSize;
+                } else if (cache->Level == 2) {
+                    out_info->l2_cache_size = cache->CacheSize;
+                } else if (cache->Level == 3) {
+                    out_info->l3_cache_size = cache->CacheSize;
+                }
+            } break;
+            default:
+                break;
+        }
+        offset += entry->Size;
+    }
+    platform_free(buffer, false);
+
+    out_info->physical_core_count = physical ? physical : 1;
+    out_info->logical_core_count = logical ? logical : 1;
+    out_info->numa_node_count = nodes ? nodes : 1;
+    return true;
+}
+
+b8 platform_set_current_thread_affinity(u64 core_mask) {
+    return SetThreadAffinityMask(GetCurrentThread(), (DWORD_PTR)core_mask) != 0;
+}
+
+b8 platform_set_current_thread_priority(platform_thread_priority priority) {
+    int value = THREAD_PRIORITY_NORMAL;
+    switch (priority) {
+        case PLATFORM_THREAD_PRIORITY_LOW: value = THREAD_PRIORITY_BELOW_NORMAL; break;
+        case PLATFORM_THREAD_PRIORITY_NORMAL: value = THREAD_PRIORITY_NORMAL; break;
+        case PLATFORM_THREAD_PRIORITY_HIGH: value = THREAD_PRIORITY_ABOVE_NORMAL; break;
+        case PLATFORM_THREAD_PRIORITY_CRITICAL: value = THREAD_PRIORITY_TIME_CRITICAL; break;
+    }
+    return SetThreadPriority(GetCurrentThread(), value) != 0;
+}
+
+#elif PLATFORM_LINUX
+
+// Bounds the sysfs scans; well above any current machine.
+#define SYSFS_MAX_CPUS 1024
+#define SYSFS_MAX_NODES 256
+
+static b8 read_sysfs_u64(const char* path, u64* out_value) {
+    FILE* f = fopen(path, "r");
+    if (!f) {
+        return false;
+    }
+    unsigned long long value = 0;
+    char suffix = 0;
+    int read = fscanf(f, "%llu%c", &value, &suffix);
+    fclose(f);
+    if (read < 1) {
+        return false;
+    }
+    // Cache sizes are reported as e.g. "32K".
+    if (read == 2 && (suffix == 'K' || suffix == 'k')) {
+        value *= 1024;
+    } else if (read == 2 && suffix == 'M') {
+        value *= 1024 * 1024;
+    }
+    *out_value = value;
+    return true;
+}
+
+b8 platform_get_cpu_info(platform_cpu_info* out_info) {
+    platform_zero_memory(out_info, sizeof(platform_cpu_info));
+    out_info->physical_core_count = 1;
+    out_info->numa_node_count = 1;
+
+    long online = sysconf(_SC_NPROCESSORS_ONLN);
+    out_info->logical_core_count = online > 0 ? (u32)online : 1;
+
+    char path[128];
+    u64 value;
+
+    // A physical core is a unique (package, core) pair; SMT siblings share one.
+    u64 seen_cores[SYSFS_MAX_CPUS];
+    u32 physical = 0;
+    for (u32 cpu = 0; cpu < SYSFS_MAX_CPUS; ++cpu) {
+        u64 package, core;
+        string_format(path, "/sys/devices/system/cpu/cpu%u/topology/physical_package_id", cpu);
+        if (!read_sysfs_u64(path, &package)) {
+            // CPUs may be offline or numbered sparsely; stop only once past all online ones.
+            if (cpu >= out_info->logical_core_count) {
+                break;
+            }
+            continue;
+        }
+        string_format(path, "/sys/devices/system/cpu/cpu%u/topology/core_id", cpu);
+        if (!read_sysfs_u64(path, &core)) {
+            continue;
+        }
+        u64 key = (package << 32) | core;
+        b8 found = false;
+        for (u32 i = 0; i < physical; ++i) {
+            if (seen_cores[i] == key) {
+                found = true;
+                break;
+            }
+        }
+        if (!found) {
+            seen_cores[physical++] = key;
+        }
+    }
+    if (physical) {
+        out_info->physical_core_count = physical;
+    }
+
+    for (u32 index = 0;; ++index) {
+        u64 level;
+        string_format(path, "/sys/devices/system/cpu/cpu0/cache/index%u/level", index);
+        if (!read_sysfs_u64(path, &level)) {
+            break;
+        }
+        char type[16] = {0};
+        string_format(path, "/sys/devices/system/cpu/cpu0/cache/index%u/type", index);
+        FILE* f = fopen(path, "r");
+        if (f) {
+            if (fscanf(f, "%15s", type) != 1) {
+                type[0] = 0;
+            }
+            fclose(f);
+        }
+        string_format(path, "/sys/devices/system/cpu/cpu0/cache/index%u/size", index);
+        if (!read_sysfs_u64(path, &value)) {
+            continue;
+        }
+        if (level == 1 && strings_equal(type, "Data")) {
+            out_info->l1_data_cache_size = value;
+            string_format(path, "/sys/devices/system/cpu/cpu0/cache/index%u/coherency_line_size", index);
+            if (read_sysfs_u64(path, &value)) {
+                out_info->cache_line_size = (u32)value;
+            }
+        } else if (level == 2) {
+            out_info->l2_cache_size = value;
+        } else if (level == 3) {
+            out_info->l3_cache_size = value;
+        }
+    }
+
+    u32 nodes = 0;
+    for (u32 node = 0; node < SYSFS_MAX_NODES; ++node) {
+        string_format(path, "/sys/devices/system/node/node%u", node);
+        if (access(path, F_OK) == 0) {
+            nodes++;
+        }
+    }
+    if (nodes) {
+        out_info->numa_node_count = nodes;
+    }
+
+    return physical != 0;
+}
+
+b8 platform_set_current_thread_affinity(u64 core_mask) {
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    for (u32 i = 0; i < 64; ++i) {
+        if (core_mask & (1ULL << i)) {
+            CPU_SET(i, &set);
+        }
+    }
+    // 0 is the calling thread.
+    return sched_setaffinity(0, sizeof(set), &set) == 0;
+}
+
+b8 platform_set_current_thread_priority(platform_thread_priority priority) {
+    // Linux threads have their own nice value under the default scheduler.
+    int nice_value = 0;
+    switch (priority) {
+        case PLATFORM_THREAD_PRIORITY_LOW: nice_value = 5; break;
+        case PLATFORM_THREAD_PRIORITY_NORMAL: nice_value = 0; break;
+        case PLATFORM_THREAD_PRIORITY_HIGH: nice_value = -5; break;
+        case PLATFORM_THREAD_PRIORITY_CRITICAL: nice_value = -10; break;
+    }
+    return setpriority(PRIO_PROCESS, (id_t)syscall(SYS_gettid), nice_value) == 0;
+}
+
+#endif
@@ -19,17 +19,16 @@
         HINSTANCE hInstance;
         HWND hWnd;
         VkSurfaceKHR surface;
-        f64 clock_frequency;
-        LARGE_INTEGER start_time;
     } platform_state;
 
     static platform_state *state_ptr;
 
+    // Seconds per performance counter tick. Kept outside platform_state so the clock works without
+    // a window, e.g. in the test and microbenchmark executables.
     static f64 clock_frequency;
-    static LARGE_INTEGER start_time;
     LRESULT CALLBACK win32_process_message(HWND hWnd, u32 uMsg, WPARAM wParam, LPARAM lParam);
 
-b8 platform_system_startup(u64 *memory_requirement, void *state, const char *application_name, i32 x, i32 y, i32 w, i32 h) {
+b8 platform_system_startup(u64 *memory_requirement, void *state, const char *application_name, i32 x, i32 y, i32 w, i32 h, b8 show_window) {
         *memory_requirement = sizeof(platform_state);
         if (state == 0) {
             return true;
@@ -99,12 +98,16 @@ b8 platform_system_startup(u64 *memory_requirement, void *state, const char *app
         b32 should_activate = 1;
         i32 show_window_command_flags = should_activate ? SW_SHOW : SW_SHOWNOACTIVATE;
 
-        ShowWindow(state_ptr->hWnd, show_window_command_flags);
+        // A hidden window still has a surface to present to, for headless runs.
+        if (show_window) {
+            ShowWindow(state_ptr->hWnd, show_window_command_flags);
+        }
+
+        // Raise the scheduler resolution so platform_sleep(1) returns after ~1ms rather than a
+        // full 15.6ms tick. Required for frame pacing.
+        timeBeginPeriod(1);
 
-        LARGE_INTEGER frequency;
-        QueryPerformanceFrequency(&frequency);
-        state_ptr->clock_frequency = 1.0 / (f64)frequency.QuadPart;
-        QueryPerformanceCounter(&state_ptr->start_time);
+        platform_cycles_calibrate();
 
         return true;
     }
@@ -114,6 +117,9 @@ b8 platform_system_startup(u64 *memory_requirement, void *state, const char *app
             DestroyWindow(state_ptr->hWnd);
             state_ptr->hWnd = 0;
         }
+        if (state_ptr) {
+            timeEndPeriod(1);
+        }
     }
 
     b8 platform_pump_messages() {
@@ -181,12 +187,15 @@ b8 platform_system_startup(u64 *memory_requirement, void *state, const char *app
 
     f64 platform_get_absolute_time()
     {
-        if (state_ptr) {
-            LARGE_INTEGER now_time;
-            QueryPerformanceCounter(&now_time);
-            return (f64)now_time.QuadPart * state_ptr->clock_frequency;
+        if (clock_frequency == 0) {
+            // Set up on first use. Racing threads all store the same value.
+            LARGE_INTEGER frequency;
+            QueryPerformanceFrequency(&frequency);
+            clock_frequency = 1.0 / (f64)frequency.QuadPart;
         }
-        return 0;
+        LARGE_INTEGER now_time;
+        QueryPerformanceCounter(&now_time);
+        return (f64)now_time.QuadPart * clock_frequency;
     }
 
     void platform_sleep(u64 ms)
@@ -234,12 +243,12 @@ b8 platform_system_startup(u64 *memory_requirement, void *state, const char *app
                 u32 width = r.right - r.left;
                 u32 height = r.bottom - r.top;
 
-                // Fire the event. The application layer should pick this up, but not handle it
+                // Post the event. The application layer should pick this up, but not handle it
                 // as it shouldn be visible to other parts of the application.
                 event_context context;
                 context.data.u16[0] = (u16)width;
                 context.data.u16[1] = (u16)height;
-                event_fire(EVENT_CODE_RESIZED, 0, context);
+                event_post(EVENT_CODE_RESIZED, 0, context);
             } break;
             case WM_KEYDOWN:
             case WM_KEYUP:
@@ -0,0 +1,103 @@
+#pragma once
+
+#include "defines.h"
+
+/*
+ * C11-style atomic operations with explicit memory orders. Operands are plain
+ * integers/pointers accessed only through these functions; naturally aligned
+ * 32 and 64-bit values are lock-free on every supported target.
+ */
+
+#if !defined(__clang__) && !defined(__GNUC__)
+#error "vatomic.h requires the __atomic builtins of clang or gcc."
+#endif
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#include <immintrin.h>
+#endif
+
+/** @brief Assumed cache line size, used to pad data shared between threads. */
+#define VCACHE_LINE_SIZE 64
+
+typedef enum vmemory_order {
+    VMEMORY_ORDER_RELAXED = __ATOMIC_RELAXED,
+    VMEMORY_ORDER_ACQUIRE = __ATOMIC_ACQUIRE,
+    VMEMORY_ORDER_RELEASE = __ATOMIC_RELEASE,
+    VMEMORY_ORDER_ACQ_REL = __ATOMIC_ACQ_REL,
+    VMEMORY_ORDER_SEQ_CST = __ATOMIC_SEQ_CST
+} vmemory_order;
+
+/**
+ * Defines, for the given type:
+ *  - vatomic_load_<suffix>(ptr, order)
+ *  - vatomic_store_<suffix>(ptr, value, order)
+ *  - vatomic_exchange_<suffix>(ptr, value, order): returns the previous value.
+ *  - vatomic_compare_exchange_<suffix>(ptr, expected, desired, weak, success, failure):
+ *    if *ptr == *expected stores desired and returns true; otherwise writes the
+ *    current value to *expected and returns false. Weak may fail spuriously.
+ *  - vatomic_fetch_add/sub/and/or_<suffix>(ptr, value, order): returns the previous value.
+ */
+#define VATOMIC_DEFINE(suffix, type)                                                                           \
+    VINLINE type vatomic_load_##suffix(const volatile type* ptr, vmemory_order order) {                        \
+        return __atomic_load_n(ptr, order);                                                                    \
+    }                                                                                                          \
+    VINLINE void vatomic_store_##suffix(volatile type* ptr, type value, vmemory_order order) {                 \
+        __atomic_store_n(ptr, value, order);                                                                   \
+    }                                                                                                          \
+    VINLINE type vatomic_exchange_##suffix(volatile type* ptr, type value, vmemory_order order) {              \
+        return __atomic_exchange_n(ptr, value, order);                                                         \
+    }                                                                                                          \
+    VINLINE b8 vatomic_compare_exchange_##suffix(volatile type* ptr, type* expected, type desired, b8 weak,     \
+                                                 vmemory_order success, vmemory_order failure) {               \
+        return __atomic_compare_exchange_n(ptr, expected, desired, weak, success, failure);                    \
+    }                                                                                                          \
+    VINLINE type vatomic_fetch_add_##suffix(volatile type* ptr, type value, vmemory_order order) {             \
+        return __atomic_fetch_add(ptr, value, order);                                                          \
+    }                                                                                                          \
+    VINLINE type vatomic_fetch_sub_##suffix(volatile type* ptr, type value, vmemory_order order) {             \
+        return __atomic_fetch_sub(ptr, value, order);                                                          \
+    }                                                                                                          \
+    VINLINE type vatomic_fetch_and_##suffix(volatile type* ptr, type value, vmemory_order order) {             \
+        return __atomic_fetch_and(ptr, value, order);                                                          \
+    }                                                                                                          \
+    VINLINE type vatomic_fetch_or_##suffix(volatile type* ptr, type value, vmemory_order order) {              \
+        return __atomic_fetch_or(ptr, value, order);                                                           \
+    }
+
+VATOMIC_DEFINE(i32, i32)
+VATOMIC_DEFINE(u32, u32)
+VATOMIC_DEFINE(i64, i64)
+VATOMIC_DEFINE(u64, u64)
+
+VINLINE void* vatomic_load_ptr(void* const volatile* ptr, vmemory_order order) {
+    return __atomic_load_n(ptr, order);
+}
+
+VINLINE void vatomic_store_ptr(void* volatile* ptr, void* value, vmemory_order order) {
+    __atomic_store_n(ptr, value, order);
+}
+
+VINLINE void* vatomic_exchange_ptr(void* volatile* ptr, void* value, vmemory_order order) {
+    return __atomic_exchange_n(ptr, value, order);
+}
+
+VINLINE b8 vatomic_compare_exchange_ptr(void* volatile* ptr, void** expected, void* desired, b8 weak,
+                                        vmemory_order success, vmemory_order failure) {
+    return __atomic_compare_exchange_n(ptr, expected, desired, weak, success, failure);
+}
+
+VINLINE void vatomic_thread_fence(vmemory_order order) {
+    __atomic_thread_fence(order);
+}
+
+/**
+ * Hints to the CPU that the caller is busy-waiting, reducing power use and
+ * freeing resources for an SMT sibling.
+ */
+VINLINE void vatomic_cpu_relax() {
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+    _mm_pause();
+#elif defined(__aarch64__)
+    __asm__ volatile("yield");
+#endif
+}
@@ -0,0 +1,56 @@
+#pragma once
+
+#include "defines.h"
+
+/**
+ * Entry point of a fiber. Must never return; switch to another fiber instead.
+ * @param params The params passed to vfiber_create.
+ */
+typedef void (*pfn_fiber_start)(void* params);
+
+/**
+ * A user-mode execution context with its own stack. Switching between fibers
+ * is cooperative and doesn't involve the OS scheduler. A fiber may be resumed
+ * on a different thread than the one it was suspended on, so fiber code should
+ * not hold on to thread-local values across a switch.
+ */
+typedef struct vfiber {
+    void* internal_data;
+} vfiber;
+
+/**
+ * Turns the calling thread into a fiber so it can switch to other fibers and
+ * be switched back to. Call once per thread before its first switch.
+ * @param out_fiber A pointer to hold the thread's fiber.
+ * @returns True on success; otherwise false.
+ */
+API b8 vfiber_from_current_thread(vfiber* out_fiber);
+
+/**
+ * Releases a fiber created by vfiber_from_current_thread. Must be called on
+ * that thread, while it is running its own fiber.
+ */
+API void vfiber_release_thread(vfiber* fiber);
+
+/**
+ * Creates a suspended fiber. It starts running start_function on the first
+ * switch to it.
+ * @param stack_size The size of the fiber's stack in bytes.
+ * @param start_function The function the fiber runs.
+ * @param params Passed to start_function.
+ * @param out_fiber A pointer to hold the created fiber.
+ * @returns True on success; otherwise false.
+ */
+API b8 vfiber_create(u64 stack_size, pfn_fiber_start start_function, void* params, vfiber* out_fiber);
+
+/**
+ * Destroys a fiber and frees its stack. The fiber must not be running.
+ */
+API void vfiber_destroy(vfiber* fiber);
+
+/**
+ * Suspends the running fiber and resumes another.
+ * @param from The running fiber, which is resumed where it left off once switched back to.
+ * @param to The fiber to resume.
+ */
+API void vfiber_switch(vfiber* from, vfiber* to);
@@ -0,0 +1,101 @@
+#if defined(__APPLE__) && !defined(_XOPEN_SOURCE)
+// ucontext is deprecated on macOS and hidden without this.
+#define _XOPEN_SOURCE 600
+#endif
+
+#include "platform/vfiber.h"
+
+#if PLATFORM_LINUX || PLATFORM_UNIX || PLATFORM_POSIX || PLATFORM_APPLE
+
+#include "platform/platform.h"
+#include "core/logger.h"
+
+#include <ucontext.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+typedef struct fiber_internal {
+    ucontext_t context;
+    // Mapping holding the stack and its guard page; 0 for thread fibers.
+    u8* mapping;
+    u64 mapping_size;
+    pfn_fiber_start start_function;
+    void* params;
+} fiber_internal;
+
+// makecontext only passes int arguments, so the pointer is split in two.
+static void fiber_trampoline(u32 high, u32 low) {
+    fiber_internal* internal = (fiber_internal*)(((u64)high << 32) | (u64)low);
+    internal->start_function(internal->params);
+    FATAL("A fiber returned from its start function.");
+}
+
+b8 vfiber_from_current_thread(vfiber* out_fiber) {
+    fiber_internal* internal = platform_allocate(sizeof(fiber_internal), false);
+    platform_zero_memory(internal, sizeof(fiber_internal));
+    out_fiber->internal_data = internal;
+    return true;
+}
+
+void vfiber_release_thread(vfiber* fiber) {
+    if (fiber->internal_data) {
+        platform_free(fiber->internal_data, false);
+        fiber->internal_data = 0;
+    }
+}
+
+b8 vfiber_create(u64 stack_size, pfn_fiber_start start_function, void* params, vfiber* out_fiber) {
+    u64 page_size = (u64)sysconf(_SC_PAGESIZE);
+    stack_size = ((stack_size + page_size - 1) / page_size) * page_size;
+
+    // The stack is mapped rather than allocated so pages are only committed once touched, with
+    // an inaccessible page below it so an overflow faults instead of corrupting a neighbour.
+    u64 mapping_size = stack_size + page_size;
+    u8* mapping = mmap(0, mapping_size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (mapping == MAP_FAILED) {
+        ERROR("vfiber_create - failed to map a %llu byte stack.", stack_size);
+        return false;
+    }
+    mprotect(mapping, page_size, PROT_NONE);
+
+    fiber_internal* internal = platform_allocate(sizeof(fiber_internal), false);
+    platform_zero_memory(internal, sizeof(fiber_internal));
+    internal->mapping = mapping;
+    internal->mapping_size = mapping_size;
+    internal->start_function = start_function;
+    internal->params = params;
+
+    if (getcontext(&internal->context) != 0) {
+        ERROR("vfiber_create - getcontext failed.");
+        munmap(mapping, mapping_size);
+        platform_free(internal, false);
+        return false;
+    }
+    internal->context.uc_stack.ss_sp = mapping + page_size;
+    internal->context.uc_stack.ss_size = stack_size;
+    internal->context.uc_link = 0;
+    u64 address = (u64)internal;
+    makecontext(&internal->context, (void (*)(void))fiber_trampoline, 2, (u32)(address >> 32), (u32)address);
+
+    out_fiber->internal_data = internal;
+    return true;
+}
+
+void vfiber_destroy(vfiber* fiber) {
+    fiber_internal* internal = fiber->internal_data;
+    if (internal) {
+        if (internal->mapping) {
+            munmap(internal->mapping, internal->mapping_size);
+        }
+        platform_free(internal, false);
+        fiber->internal_data = 0;
+    }
+}
+
+void vfiber_switch(vfiber* from, vfiber* to) {
+    fiber_internal* from_internal = from->internal_data;
+    fiber_internal* to_internal = to->internal_data;
+    swapcontext(&from_internal->context, &to_internal->context);
+}
+
+#endif
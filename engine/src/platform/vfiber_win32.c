@@ -0,0 +1,85 @@
+#include "platform/vfiber.h"
+
+#if PLATFORM_WINDOWS
+
+#include "platform/platform.h"
+#include "core/logger.h"
+
+#include <windows.h>
+
+typedef struct fiber_start {
+    pfn_fiber_start start_function;
+    void* params;
+} fiber_start;
+
+typedef struct fiber_internal {
+    LPVOID handle;
+    // Only set for created fibers.
+    fiber_start* start;
+} fiber_internal;
+
+static VOID CALLBACK fiber_trampoline(LPVOID param) {
+    fiber_start* start = param;
+    start->start_function(start->params);
+    // Returning from a fiber procedure exits the thread.
+    FATAL("A fiber returned from its start function.");
+}
+
+b8 vfiber_from_current_thread(vfiber* out_fiber) {
+    LPVOID handle = ConvertThreadToFiberEx(0, FIBER_FLAG_FLOAT_SWITCH);
+    if (!handle) {
+        ERROR("vfiber_from_current_thread - ConvertThreadToFiberEx failed (error %u).", (u32)GetLastError());
+        return false;
+    }
+    fiber_internal* internal = platform_allocate(sizeof(fiber_internal), false);
+    platform_zero_memory(internal, sizeof(fiber_internal));
+    internal->handle = handle;
+    out_fiber->internal_data = internal;
+    return true;
+}
+
+void vfiber_release_thread(vfiber* fiber) {
+    if (fiber->internal_data) {
+        ConvertFiberToThread();
+        platform_free(fiber->internal_data, false);
+        fiber->internal_data = 0;
+    }
+}
+
+b8 vfiber_create(u64 stack_size, pfn_fiber_start start_function, void* params, vfiber* out_fiber) {
+    fiber_start* start = platform_allocate(sizeof(fiber_start), false);
+    start->start_function = start_function;
+    start->params = params;
+
+    // Reserves the whole stack but commits only what is touched.
+    LPVOID handle = CreateFiberEx(0, (SIZE_T)stack_size, FIBER_FLAG_FLOAT_SWITCH, fiber_trampoline, start);
+    if (!handle) {
+        ERROR("vfiber_create - CreateFiberEx failed (error %u).", (u32)GetLastError());
+        platform_free(start, false);
+        return false;
+    }
+
+    fiber_internal* internal = platform_allocate(sizeof(fiber_internal), false);
+    internal->handle = handle;
+    internal->start = start;
+    out_fiber->internal_data = internal;
+    return true;
+}
+
+void vfiber_destroy(vfiber* fiber) {
+    fiber_internal* internal = fiber->internal_data;
+    if (internal) {
+        DeleteFiber(internal->handle);
+        platform_free(internal->start, false);
+        platform_free(internal, false);
+        fiber->internal_data = 0;
+    }
+}
+
+void vfiber_switch(vfiber* from, vfiber* to) {
+    // The running fiber's state is saved by the switch itself.
+    (void)from;
+    SwitchToFiber(((fiber_internal*)to->internal_data)->handle);
+}
+
+#endif
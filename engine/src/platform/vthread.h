@@ -0,0 +1,149 @@
+#pragma once
+
+#include "defines.h"
+#include "platform/vatomic.h"
+
+/**
+ * Entry point of a thread.
+ * @param params The params passed to vthread_create.
+ * @returns An exit code.
+ */
+typedef u32 (*pfn_thread_start)(void* params);
+
+typedef struct vthread {
+    void* internal_data;
+    u64 thread_id;
+} vthread;
+
+/**
+ * Creates and starts a thread.
+ * @param name A name shown in debuggers and profilers. May be 0.
+ * @param start_function The function the thread runs.
+ * @param params Passed to start_function.
+ * @param out_thread A pointer to hold the created thread.
+ * @returns True on success; otherwise false.
+ */
+API b8 vthread_create(const char* name, pfn_thread_start start_function, void* params, vthread* out_thread);
+
+/**
+ * Waits for a thread to exit and releases it.
+ * @param thread A pointer to the thread.
+ * @param out_exit_code A pointer to hold the value returned by the thread. May be 0.
+ * @returns True on success; otherwise false.
+ */
+API b8 vthread_join(vthread* thread, u32* out_exit_code);
+
+/**
+ * Releases a thread without waiting for it; it keeps running to completion.
+ * @param thread A pointer to the thread.
+ */
+API void vthread_detach(vthread* thread);
+
+/** @returns The id of the calling thread. */
+API u64 vthread_current_id();
+
+/**
+ * Gives up the rest of the calling thread's time slice.
+ */
+API void vthread_yield();
+
+typedef struct vmutex {
+    void* internal_data;
+} vmutex;
+
+API b8 vmutex_create(vmutex* out_mutex);
+API void vmutex_destroy(vmutex* mutex);
+API void vmutex_lock(vmutex* mutex);
+/** @returns True if the mutex was acquired; false if it is held by another thread. */
+API b8 vmutex_try_lock(vmutex* mutex);
+API void vmutex_unlock(vmutex* mutex);
+
+typedef struct vcondition {
+    void* internal_data;
+} vcondition;
+
+API b8 vcondition_create(vcondition* out_condition);
+API void vcondition_destroy(vcondition* condition);
+
+/**
+ * Atomically releases the mutex and waits for the condition to be signalled,
+ * then reacquires the mutex. May wake spuriously, so wait in a loop checking
+ * the actual condition.
+ * @param condition A pointer to the condition.
+ * @param mutex A pointer to a mutex held by the calling thread.
+ */
+API void vcondition_wait(vcondition* condition, vmutex* mutex);
+
+/** Wakes one thread waiting on the condition. */
+API void vcondition_signal(vcondition* condition);
+/** Wakes all threads waiting on the condition. */
+API void vcondition_broadcast(vcondition* condition);
+
+typedef struct vsemaphore {
+    void* internal_data;
+} vsemaphore;
+
+/**
+ * Creates a counting semaphore.
+ * @param initial_count The initial count.
+ * @param out_semaphore A pointer to hold the created semaphore.
+ * @returns True on success; otherwise false.
+ */
+API b8 vsemaphore_create(u32 initial_count, vsemaphore* out_semaphore);
+API void vsemaphore_destroy(vsemaphore* semaphore);
+
+/**
+ * Increments the count by count, waking up to that many waiting threads.
+ */
+API void vsemaphore_signal(vsemaphore* semaphore, u32 count);
+
+/**
+ * Waits until the count is above zero, then decrements it.
+ */
+API void vsemaphore_wait(vsemaphore* semaphore);
+
+/**
+ * Decrements the count if it is above zero, without waiting.
+ * @returns True if the count was decremented; otherwise false.
+ */
+API b8 vsemaphore_try_wait(vsemaphore* semaphore);
+
+/**
+ * A lock which busy-waits instead of sleeping, for critical sections only a
+ * few instructions long. Zero-initialized is unlocked.
+ */
+typedef struct vspinlock {
+    volatile u32 locked;
+} vspinlock;
+
+// Spin iterations between yields once the backoff has maxed out.
+#define VSPINLOCK_MAX_BACKOFF 64
+
+VINLINE b8 vspinlock_try_lock(vspinlock* lock) {
+    return vatomic_exchange_u32(&lock->locked, 1, VMEMORY_ORDER_ACQUIRE) == 0;
+}
+
+VINLINE void vspinlock_lock(vspinlock* lock) {
+    u32 backoff = 1;
+    for (;;) {
+        if (vspinlock_try_lock(lock)) {
+            return;
+        }
+        // Spin on a plain load so waiters don't fight over the cache line, backing off
+        // exponentially and yielding once contention persists.
+        while (vatomic_load_u32(&lock->locked, VMEMORY_ORDER_RELAXED)) {
+            if (backoff < VSPINLOCK_MAX_BACKOFF) {
+                for (u32 i = 0; i < backoff; ++i) {
+                    vatomic_cpu_relax();
+                }
+                backoff <<= 1;
+            } else {
+                vthread_yield();
+            }
+        }
+    }
+}
+
+VINLINE void vspinlock_unlock(vspinlock* lock) {
+    vatomic_store_u32(&lock->locked, 0, VMEMORY_ORDER_RELEASE);
+}
@@ -0,0 +1,241 @@
+#if defined(__linux__) && !defined(_GNU_SOURCE)
+// For pthread_setname_np.
+#define _GNU_SOURCE
+#endif
+
+#include "platform/vthread.h"
+
+#if PLATFORM_LINUX || PLATFORM_UNIX || PLATFORM_POSIX || PLATFORM_APPLE
+
+#include "platform/platform.h"
+#include "core/logger.h"
+#include "core/vstring.h"
+
+#include <pthread.h>
+#include <sched.h>
+#if PLATFORM_LINUX
+#include <unistd.h>
+#include <sys/syscall.h>
+#endif
+
+typedef struct thread_start {
+    pfn_thread_start function;
+    void* params;
+    // Linux limits thread names to 15 characters.
+    char name[16];
+} thread_start;
+
+static void* thread_trampoline(void* param) {
+    thread_start start = *(thread_start*)param;
+    platform_free(param, false);
+
+    if (start.name[0]) {
+#if PLATFORM_APPLE
+        pthread_setname_np(start.name);
+#else
+        pthread_setname_np(pthread_self(), start.name);
+#endif
+    }
+    return (void*)(u64)start.function(start.params);
+}
+
+b8 vthread_create(const char* name, pfn_thread_start start_function, void* params, vthread* out_thread) {
+    if (!start_function || !out_thread) {
+        return false;
+    }
+    thread_start* start = platform_allocate(sizeof(thread_start), false);
+    platform_zero_memory(start, sizeof(thread_start));
+    start->function = start_function;
+    start->params = params;
+    if (name) {
+        u64 length = string_length(name);
+        if (length > sizeof(start->name) - 1) {
+            length = sizeof(start->name) - 1;
+        }
+        platform_copy_memory(start->name, name, length);
+    }
+
+    pthread_t* handle = platform_allocate(sizeof(pthread_t), false);
+    i32 result = pthread_create(handle, 0, thread_trampoline, start);
+    if (result != 0) {
+        ERROR("vthread_create - pthread_create failed (error %i).", result);
+        platform_free(handle, false);
+        platform_free(start, false);
+        return false;
+    }
+    out_thread->internal_data = handle;
+    out_thread->thread_id = (u64)*handle;
+    return true;
+}
+
+b8 vthread_join(vthread* thread, u32* out_exit_code) {
+    if (!thread || !thread->internal_data) {
+        return false;
+    }
+    void* exit_code = 0;
+    if (pthread_join(*(pthread_t*)thread->internal_data, &exit_code) != 0) {
+        return false;
+    }
+    if (out_exit_code) {
+        *out_exit_code = (u32)(u64)exit_code;
+    }
+    platform_free(thread->internal_data, false);
+    thread->internal_data = 0;
+    thread->thread_id = 0;
+    return true;
+}
+
+void vthread_detach(vthread* thread) {
+    if (thread && thread->internal_data) {
+        pthread_detach(*(pthread_t*)thread->internal_data);
+        platform_free(thread->internal_data, false);
+        thread->internal_data = 0;
+        thread->thread_id = 0;
+    }
+}
+
+u64 vthread_current_id() {
+#if PLATFORM_LINUX
+    return (u64)syscall(SYS_gettid);
+#else
+    return (u64)pthread_self();
+#endif
+}
+
+void vthread_yield() {
+    sched_yield();
+}
+
+// MUTEX //
+b8 vmutex_create(vmutex* out_mutex) {
+    pthread_mutex_t* mutex = platform_allocate(sizeof(pthread_mutex_t), false);
+    if (pthread_mutex_init(mutex, 0) != 0) {
+        ERROR("vmutex_create - pthread_mutex_init failed.");
+        platform_free(mutex, false);
+        return false;
+    }
+    out_mutex->internal_data = mutex;
+    return true;
+}
+
+void vmutex_destroy(vmutex* mutex) {
+    if (mutex->internal_data) {
+        pthread_mutex_destroy((pthread_mutex_t*)mutex->internal_data);
+        platform_free(mutex->internal_data, false);
+        mutex->internal_data = 0;
+    }
+}
+
+void vmutex_lock(vmutex* mutex) {
+    pthread_mutex_lock((pthread_mutex_t*)mutex->internal_data);
+}
+
+b8 vmutex_try_lock(vmutex* mutex) {
+    return pthread_mutex_trylock((pthread_mutex_t*)mutex->internal_data) == 0;
+}
+
+void vmutex_unlock(vmutex* mutex) {
+    pthread_mutex_unlock((pthread_mutex_t*)mutex->internal_data);
+}
+
+// CONDITION //
+b8 vcondition_create(vcondition* out_condition) {
+    pthread_cond_t* condition = platform_allocate(sizeof(pthread_cond_t), false);
+    if (pthread_cond_init(condition, 0) != 0) {
+        ERROR("vcondition_create - pthread_cond_init failed.");
+        platform_free(condition, false);
+        return false;
+    }
+    out_condition->internal_data = condition;
+    return true;
+}
+
+void vcondition_destroy(vcondition* condition) {
+    if (condition->internal_data) {
+        pthread_cond_destroy((pthread_cond_t*)condition->internal_data);
+        platform_free(condition->internal_data, false);
+        condition->internal_data = 0;
+    }
+}
+
+void vcondition_wait(vcondition* condition, vmutex* mutex) {
+    pthread_cond_wait((pthread_cond_t*)condition->internal_data, (pthread_mutex_t*)mutex->internal_data);
+}
+
+void vcondition_signal(vcondition* condition) {
+    pthread_cond_signal((pthread_cond_t*)condition->internal_data);
+}
+
+void vcondition_broadcast(vcondition* condition) {
+    pthread_cond_broadcast((pthread_cond_t*)condition->internal_data);
+}
+
+// SEMAPHORE //
+// Built on a mutex and condition variable; unnamed POSIX semaphores are not available everywhere (macOS).
+typedef struct semaphore_internal {
+    pthread_mutex_t mutex;
+    pthread_cond_t condition;
+    u32 count;
+} semaphore_internal;
+
+b8 vsemaphore_create(u32 initial_count, vsemaphore* out_semaphore) {
+    semaphore_internal* internal = platform_allocate(sizeof(semaphore_internal), false);
+    if (pthread_mutex_init(&internal->mutex, 0) != 0) {
+        platform_free(internal, false);
+        return false;
+    }
+    if (pthread_cond_init(&internal->condition, 0) != 0) {
+        pthread_mutex_destroy(&internal->mutex);
+        platform_free(internal, false);
+        return false;
+    }
+    internal->count = initial_count;
+    out_semaphore->internal_data = internal;
+    return true;
+}
+
+void vsemaphore_destroy(vsemaphore* semaphore) {
+    semaphore_internal* internal = semaphore->internal_data;
+    if (internal) {
+        pthread_cond_destroy(&internal->condition);
+        pthread_mutex_destroy(&internal->mutex);
+        platform_free(internal, false);
+        semaphore->internal_data = 0;
+    }
+}
+
+void vsemaphore_signal(vsemaphore* semaphore, u32 count) {
+    semaphore_internal* internal = semaphore->internal_data;
+    pthread_mutex_lock(&internal->mutex);
+    internal->count += count;
+    pthread_mutex_unlock(&internal->mutex);
+    if (count == 1) {
+        pthread_cond_signal(&internal->condition);
+    } else if (count > 1) {
+        pthread_cond_broadcast(&internal->condition);
+    }
+}
+
+void vsemaphore_wait(vsemaphore* semaphore) {
+    semaphore_internal* internal = semaphore->internal_data;
+    pthread_mutex_lock(&internal->mutex);
+    while (internal->count == 0) {
+        pthread_cond_wait(&internal->condition, &internal->mutex);
+    }
+    internal->count--;
+    pthread_mutex_unlock(&internal->mutex);
+}
+
+b8 vsemaphore_try_wait(vsemaphore* semaphore) {
+    semaphore_internal* internal = semaphore->internal_data;
+    b8 acquired = false;
+    pthread_mutex_lock(&internal->mutex);
+    if (internal->count > 0) {
+        internal->count--;
+        acquired = true;
+    }
+    pthread_mutex_unlock(&internal->mutex);
+    return acquired;
+}
+
+#endif
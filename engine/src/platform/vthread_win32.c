@@ -0,0 +1,178 @@
+#include "platform/vthread.h"
+
+#if PLATFORM_WINDOWS
+
+#include "platform/platform.h"
+#include "core/logger.h"
+
+#include <windows.h>
+
+typedef struct thread_start {
+    pfn_thread_start function;
+    void* params;
+    WCHAR name[64];
+} thread_start;
+
+// SetThreadDescription only exists on Windows 10 1607 and later, so it is looked up at runtime.
+typedef HRESULT(WINAPI* pfn_set_thread_description)(HANDLE thread, PCWSTR description);
+
+static DWORD WINAPI thread_trampoline(LPVOID param) {
+    thread_start start = *(thread_start*)param;
+    platform_free(param, false);
+
+    if (start.name[0]) {
+        pfn_set_thread_description set_description =
+            (pfn_set_thread_description)(void*)GetProcAddress(GetModuleHandleA("kernel32.dll"), "SetThreadDescription");
+        if (set_description) {
+            set_description(GetCurrentThread(), start.name);
+        }
+    }
+    return start.function(start.params);
+}
+
+b8 vthread_create(const char* name, pfn_thread_start start_function, void* params, vthread* out_thread) {
+    if (!start_function || !out_thread) {
+        return false;
+    }
+    thread_start* start = platform_allocate(sizeof(thread_start), false);
+    platform_zero_memory(start, sizeof(thread_start));
+    start->function = start_function;
+    start->params = params;
+    if (name) {
+        MultiByteToWideChar(CP_UTF8, 0, name, -1, start->name, 63);
+    }
+
+    DWORD thread_id;
+    HANDLE handle = CreateThread(0, 0, thread_trampoline, start, 0, &thread_id);
+    if (!handle) {
+        ERROR("vthread_create - CreateThread failed (error %u).", (u32)GetLastError());
+        platform_free(start, false);
+        return false;
+    }
+    out_thread->internal_data = handle;
+    out_thread->thread_id = thread_id;
+    return true;
+}
+
+b8 vthread_join(vthread* thread, u32* out_exit_code) {
+    if (!thread || !thread->internal_data) {
+        return false;
+    }
+    if (WaitForSingleObject((HANDLE)thread->internal_data, INFINITE) != WAIT_OBJECT_0) {
+        return false;
+    }
+    if (out_exit_code) {
+        DWORD exit_code = 0;
+        GetExitCodeThread((HANDLE)thread->internal_data, &exit_code);
+        *out_exit_code = exit_code;
+    }
+    CloseHandle((HANDLE)thread->internal_data);
+    thread->internal_data = 0;
+    thread->thread_id = 0;
+    return true;
+}
+
+void vthread_detach(vthread* thread) {
+    if (thread && thread->internal_data) {
+        CloseHandle((HANDLE)thread->internal_data);
+        thread->internal_data = 0;
+        thread->thread_id = 0;
+    }
+}
+
+u64 vthread_current_id() {
+    return (u64)GetCurrentThreadId();
+}
+
+void vthread_yield() {
+    SwitchToThread();
+}
+
+// MUTEX //
+b8 vmutex_create(vmutex* out_mutex) {
+    SRWLOCK* lock = platform_allocate(sizeof(SRWLOCK), false);
+    InitializeSRWLock(lock);
+    out_mutex->internal_data = lock;
+    return true;
+}
+
+void vmutex_destroy(vmutex* mutex) {
+    if (mutex->internal_data) {
+        // SRW locks need no cleanup.
+        platform_free(mutex->internal_data, false);
+        mutex->internal_data = 0;
+    }
+}
+
+void vmutex_lock(vmutex* mutex) {
+    AcquireSRWLockExclusive((SRWLOCK*)mutex->internal_data);
+}
+
+b8 vmutex_try_lock(vmutex* mutex) {
+    return TryAcquireSRWLockExclusive((SRWLOCK*)mutex->internal_data) != 0;
+}
+
+void vmutex_unlock(vmutex* mutex) {
+    ReleaseSRWLockExclusive((SRWLOCK*)mutex->internal_data);
+}
+
+// CONDITION //
+b8 vcondition_create(vcondition* out_condition) {
+    CONDITION_VARIABLE* condition = platform_allocate(sizeof(CONDITION_VARIABLE), false);
+    InitializeConditionVariable(condition);
+    out_condition->internal_data = condition;
+    return true;
+}
+
+void vcondition_destroy(vcondition* condition) {
+    if (condition->internal_data) {
+        platform_free(condition->internal_data, false);
+        condition->internal_data = 0;
+    }
+}
+
+void vcondition_wait(vcondition* condition, vmutex* mutex) {
+    SleepConditionVariableSRW((CONDITION_VARIABLE*)condition->internal_data, (SRWLOCK*)mutex->internal_data, INFINITE, 0);
+}
+
+void vcondition_signal(vcondition* condition) {
+    WakeConditionVariable((CONDITION_VARIABLE*)condition->internal_data);
+}
+
+void vcondition_broadcast(vcondition* condition) {
+    WakeAllConditionVariable((CONDITION_VARIABLE*)condition->internal_data);
+}
+
+// SEMAPHORE //
+b8 vsemaphore_create(u32 initial_count, vsemaphore* out_semaphore) {
+    HANDLE handle = CreateSemaphoreA(0, (LONG)initial_count, 0x7FFFFFFF, 0);
+    if (!handle) {
+        ERROR("vsemaphore_create - CreateSemaphore failed (error %u).", (u32)GetLastError());
+        return false;
+    }
+    out_semaphore->internal_data = handle;
+    return true;
+}
+
+void vsemaphore_destroy(vsemaphore* semaphore) {
+    if (semaphore->internal_data) {
+        CloseHandle((HANDLE)semaphore->internal_data);
+        semaphore->internal_data = 0;
+    }
+}
+
+void vsemaphore_signal(vsemaphore* semaphore, u32 count) {
+    if (count) {
+        ReleaseSemaphore((HANDLE)semaphore->internal_data, (LONG)count, 0);
+    }
+}
+
+void vsemaphore_wait(vsemaphore* semaphore) {
+    WaitForSingleObject((HANDLE)semaphore->internal_data, INFINITE);
+}
+
+b8 vsemaphore_try_wait(vsemaphore* semaphore) {
+    return WaitForSingleObject((HANDLE)semaphore->internal_data, 0) == WAIT_OBJECT_0;
+}
+
+#endif
@@ -2,25 +2,62 @@
 #include "renderer/renderer_backend.h"
 
 #include "core/logger.h"
+#include "core/profiler.h"
 #include "core/vmemory.h"
 #include "math/vmath.h"
+#include "platform/platform.h"
+#include "platform/vatomic.h"
+#include "platform/vthread.h"
 
 #include "resources/resource_types.h"
 
 static renderer_backend* backend = 0;
 
+#define RENDERER_MAX_BUFFERED_FRAMES 3
+// Frames between logs of the renderer's stats; about 10 seconds at 60Hz.
+#define RENDERER_STATS_LOG_INTERVAL 600
+
+/*
+ * With a render thread, the main thread fills render packets which the render
+ * thread draws in order. Packets cycle through a small ring: free_buffers
+ * counts those the main thread may fill and queued_buffers those waiting to be
+ * drawn, so the main thread runs at most buffered_frame_count - 1 frames ahead
+ * of the one being drawn. Everything touching the backend happens on the render
+ * thread; the main thread only hands over packets and resizes.
+ */
 typedef struct renderer_system_state {
     renderer_backend backend;
     mat4 projection;
+    // The view for the next submitted packet.
     mat4 view;
     f32 near_clip;
     f32 far_clip;
     texture default_texture;
+
+    b8 threaded;
+    u32 buffered_frame_count;
+    vthread render_thread;
+    volatile u32 running;
+    vsemaphore free_buffers;
+    vsemaphore queued_buffers;
+    render_packet packets[RENDERER_MAX_BUFFERED_FRAMES];
+    // Main thread only.
+    u64 submitted_count;
+    volatile u64 drawn_count;
+    volatile u32 draw_failed;
+    // Latest size as (width << 16) | height, or 0 if unchanged since the last frame.
+    volatile u32 pending_size;
+
+    // Copied from the backend after each frame, for whichever thread asks.
+    vspinlock stats_lock;
+    renderer_stats stats;
 } renderer_system_state;
 
 static renderer_system_state* state_ptr;
 
-b8 renderer_system_initialize(u64* memory_requirement, void* state, const char* application_name) {
+static u32 render_thread_main(void* params);
+
+b8 renderer_system_initialize(u64* memory_requirement, void* state, const char* application_name, u32 buffered_frame_count) {
     *memory_requirement = sizeof(renderer_system_state);
     if (state == 0) {
         return true;
@@ -80,11 +117,36 @@ b8 renderer_system_initialize(u64* memory_requirement, void* state, const char*
         false,
         &state_ptr->default_texture);
 
+    if (buffered_frame_count > 1) {
+        if (buffered_frame_count > RENDERER_MAX_BUFFERED_FRAMES) {
+            buffered_frame_count = RENDERER_MAX_BUFFERED_FRAMES;
+        }
+        state_ptr->buffered_frame_count = buffered_frame_count;
+        state_ptr->running = true;
+        if (!vsemaphore_create(buffered_frame_count, &state_ptr->free_buffers) ||
+            !vsemaphore_create(0, &state_ptr->queued_buffers) ||
+            !vthread_create("render", render_thread_main, 0, &state_ptr->render_thread)) {
+            ERROR("Failed to start the render thread; drawing on the main thread instead.");
+        } else {
+            state_ptr->threaded = true;
+            INFO("Render thread started with %u buffered frames.", buffered_frame_count);
+        }
+    }
+
     return true;
 }
 
 void renderer_system_shutdown(void* state) {
     if (state_ptr) {
+        if (state_ptr->threaded) {
+            renderer_flush();
+            vatomic_store_u32(&state_ptr->running, false, VMEMORY_ORDER_RELEASE);
+            vsemaphore_signal(&state_ptr->queued_buffers, 1);
+            vthread_join(&state_ptr->render_thread, 0);
+            vsemaphore_destroy(&state_ptr->free_buffers);
+            vsemaphore_destroy(&state_ptr->queued_buffers);
+            state_ptr->threaded = false;
+        }
         renderer_destroy_texture(&state_ptr->default_texture);
         state_ptr->backend.shutdown(&state_ptr->backend);
     }
@@ -109,10 +171,32 @@ b8 renderer_end_frame(f32 delta_time) {
     return result;
 }
 
-b8 renderer_draw_frame(render_packet* packet) {
+static void apply_pending_resize() {
+    u32 size = vatomic_exchange_u32(&state_ptr->pending_size, 0, VMEMORY_ORDER_ACQUIRE);
+    if (size) {
+        u16 width = (u16)(size >> 16);
+        u16 height = (u16)(size & 0xFFFF);
+        state_ptr->projection = mat4_perspective(deg_to_rad(45.0f), width / (f32)height, state_ptr->near_clip, state_ptr->far_clip);
+        state_ptr->backend.resized(&state_ptr->backend, width, height);
+    }
+}
+
+static void log_stats(const renderer_stats* stats) {
+    const renderer_counters* counters = &stats->counters;
+    DEBUG("Renderer frame %llu: %u draws, %llu triangles, %u pipeline binds, %u descriptor set binds, %u descriptor set updates, "
+          "%u maps, %u unmaps, %llu bytes uploaded, %u submits, %u queue waits, %u fence waits (%.3fms), present %.3fms, GPU %.3fms.",
+          stats->frame_number, counters->draw_calls, counters->triangles, counters->pipeline_binds,
+          counters->descriptor_set_binds, counters->descriptor_set_updates, counters->buffer_maps, counters->buffer_unmaps,
+          counters->bytes_uploaded, counters->queue_submits, counters->queue_waits, counters->fence_waits,
+          stats->fence_wait_ms, stats->present_ms, stats->gpu_ms);
+}
+
+static b8 draw_packet(const render_packet* packet) {
+    PROFILE_SCOPE("draw_packet");
+    apply_pending_resize();
     if (renderer_begin_frame(packet->delta_time)) {
         
-        state_ptr->backend.update_global_state(state_ptr->projection, state_ptr->view, vec3_zero(), vec4_one(), 0);
+        state_ptr->backend.update_global_state(state_ptr->projection, packet->view, vec3_zero(), vec4_one(), 0);
 
         mat4 model = mat4_translation((vec3){0, 0, 0});
         geometry_render_data data = {};
@@ -123,6 +207,13 @@ b8 renderer_draw_frame(render_packet* packet) {
         
         b8 result = renderer_end_frame(packet->delta_time);
 
+        vspinlock_lock(&state_ptr->stats_lock);
+        state_ptr->stats = state_ptr->backend.stats;
+        vspinlock_unlock(&state_ptr->stats_lock);
+        if (state_ptr->backend.stats.frame_number % RENDERER_STATS_LOG_INTERVAL == 0) {
+            log_stats(&state_ptr->backend.stats);
+        }
+
         if (!result) {
             ERROR("Failed to draw frame!");
             return false;
@@ -131,11 +222,70 @@ b8 renderer_draw_frame(render_packet* packet) {
     return true;
 }
 
+static u32 render_thread_main(void* params) {
+    platform_set_current_thread_priority(PLATFORM_THREAD_PRIORITY_HIGH);
+    profiler_set_thread_name("render");
+
+    u64 read_index = 0;
+    for (;;) {
+        vsemaphore_wait(&state_ptr->queued_buffers);
+        // Shutdown flushes first, so nothing is left queued once running is cleared.
+        if (!vatomic_load_u32(&state_ptr->running, VMEMORY_ORDER_ACQUIRE)) {
+            break;
+        }
+        if (!draw_packet(&state_ptr->packets[read_index % state_ptr->buffered_frame_count])) {
+            vatomic_store_u32(&state_ptr->draw_failed, true, VMEMORY_ORDER_RELAXED);
+        }
+        read_index++;
+        vatomic_store_u64(&state_ptr->drawn_count, read_index, VMEMORY_ORDER_RELEASE);
+        vsemaphore_signal(&state_ptr->free_buffers, 1);
+    }
+    return 0;
+}
+
+b8 renderer_draw_frame(render_packet* packet) {
+    PROFILE_SCOPE("renderer_draw_frame");
+    packet->view = state_ptr->view;
+    if (!state_ptr->threaded) {
+        return draw_packet(packet);
+    }
+
+    // Blocks only when the render thread is a full buffer count behind.
+    vsemaphore_wait(&state_ptr->free_buffers);
+    state_ptr->packets[state_ptr->submitted_count % state_ptr->buffered_frame_count] = *packet;
+    state_ptr->submitted_count++;
+    vsemaphore_signal(&state_ptr->queued_buffers, 1);
+
+    return !vatomic_exchange_u32(&state_ptr->draw_failed, false, VMEMORY_ORDER_RELAXED);
+}
+
+void renderer_flush() {
+    if (!state_ptr || !state_ptr->threaded) {
+        return;
+    }
+    while (vatomic_load_u64(&state_ptr->drawn_count, VMEMORY_ORDER_ACQUIRE) != state_ptr->submitted_count) {
+        vthread_yield();
+    }
+}
+
 void renderer_on_resized(u16 width, u16 height) {
     if (state_ptr) {
-        state_ptr->projection = mat4_perspective(deg_to_rad(45.0f), width / (f32)height, state_ptr->near_clip, state_ptr->far_clip);      
-        state_ptr->backend.resized(&state_ptr->backend, width, height);
+        // Applied before the next frame is drawn, on whichever thread draws it.
+        vatomic_store_u32(&state_ptr->pending_size, ((u32)width << 16) | height, VMEMORY_ORDER_RELEASE);
+        if (!state_ptr->threaded) {
+            apply_pending_resize();
+        }
+    }
+}
+
+void renderer_get_stats(renderer_stats* out_stats) {
+    if (!state_ptr) {
+        vzero_memory(out_stats, sizeof(renderer_stats));
+        return;
     }
+    vspinlock_lock(&state_ptr->stats_lock);
+    *out_stats = state_ptr->stats;
+    vspinlock_unlock(&state_ptr->stats_lock);
 }
 
 void renderer_set_view(mat4 view) {
@@ -145,9 +295,12 @@ void renderer_set_view(mat4 view) {
 }
 
 void renderer_create_texture(const char* name, b8 auto_release, i32 width, i32 height, i32 channel_count, const u8* pixels, b8 has_transparency, struct texture* out_texture) {
+    // The backend isn't thread-safe; let the render thread go idle first.
+    renderer_flush();
     state_ptr->backend.create_texture(name, auto_release, width, height, channel_count, pixels, has_transparency, out_texture);
 }
 
 void renderer_destroy_texture(struct texture* texture) {
+    renderer_flush();
     state_ptr->backend.destroy_texture(texture);
 }
\ No newline at end of file
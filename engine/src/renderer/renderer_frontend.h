@@ -2,13 +2,44 @@
 
 #include "renderer/renderer_types.inl"
 
-b8 renderer_system_initialize(u64* memory_requirement, void* state, const char* application_name);
+/**
+ * @brief Initializes the renderer. Call twice; once with state = 0 to get required memory size,
+ * then a second time passing allocated memory to state.
+ *
+ * @param memory_requirement A pointer to hold the required memory size of internal state.
+ * @param state 0 if just requesting memory requirement, otherwise allocated block of memory.
+ * @param application_name The name of the application.
+ * @param buffered_frame_count Render packets buffered between the main thread and a dedicated
+ * render thread: 2 for double buffering, 3 for triple. 0 or 1 draws on the main thread.
+ * @returns True on success; otherwise false.
+ */
+b8 renderer_system_initialize(u64* memory_requirement, void* state, const char* application_name, u32 buffered_frame_count);
 void renderer_system_shutdown(void* state);
 
 void renderer_on_resized(u16 width, u16 height);
 
+/**
+ * Draws a frame. With a render thread, the packet is copied into the next free
+ * buffer for the render thread to draw while the caller moves on to the next
+ * frame; this only blocks while every buffer is queued or being drawn.
+ * @param packet The packet describing the frame.
+ * @returns False if drawing this (or, with a render thread, an earlier) frame failed.
+ */
 b8 renderer_draw_frame(render_packet* packet);
 
+/**
+ * Waits until the render thread has drawn every submitted frame. Does nothing
+ * without a render thread.
+ */
+void renderer_flush();
+
+/**
+ * Gets the timings and call counters of the last frame drawn. With a render thread, that frame
+ * is usually a frame or two behind the one last submitted.
+ * @param out_stats A pointer to hold the stats.
+ */
+API void renderer_get_stats(renderer_stats* out_stats);
+
 API void renderer_set_view(mat4 view); // undo exposure outside of engine 
 
 void renderer_create_texture(
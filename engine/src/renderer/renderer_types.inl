@@ -30,8 +30,46 @@ typedef struct geometry_render_data {
     texture* textures[16];
 } geometry_render_data;
 
+/**
+ * Work the backend asked of the graphics API during a frame, including any done
+ * between frames, e.g. uploading a texture.
+ */
+typedef struct renderer_counters {
+    u32 draw_calls;
+    u64 triangles;
+    u32 pipeline_binds;
+    u32 descriptor_set_binds;
+    // Calls updating descriptor sets.
+    u32 descriptor_set_updates;
+    u32 buffer_maps;
+    u32 buffer_unmaps;
+    // Bytes written to buffers by the CPU.
+    u64 bytes_uploaded;
+    u32 queue_submits;
+    // Waits for a queue or the whole device to go idle.
+    u32 queue_waits;
+    // Fence waits that had to block.
+    u32 fence_waits;
+} renderer_counters;
+
+/** Timings and counters of the last frame drawn. Times are in milliseconds. */
+typedef struct renderer_stats {
+    // The backend frame number the stats belong to.
+    u64 frame_number;
+    // CPU time blocked on fences waiting for earlier frames in flight to finish.
+    f64 fence_wait_ms;
+    // CPU time spent handing the image to the swapchain.
+    f64 present_ms;
+    // GPU time of the latest frame whose timings have arrived, a few frames behind,
+    // or 0 when the GPU can't be timed.
+    f64 gpu_ms;
+    renderer_counters counters;
+} renderer_stats;
+
 typedef struct renderer_backend {
     u64 frame_number;
+    // Filled in by the backend as it draws each frame.
+    renderer_stats stats;
 
     b8 (*initialize)(struct renderer_backend* backend, const char* application_name);
     
@@ -63,4 +101,6 @@ typedef struct renderer_backend {
 
 typedef struct render_packet {
     f32 delta_time;
+    // Filled in by the frontend from renderer_set_view when the packet is submitted.
+    mat4 view;
 } render_packet;
\ No newline at end of file
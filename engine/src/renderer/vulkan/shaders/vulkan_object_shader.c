@@ -203,6 +203,7 @@ void vulkan_object_shader_destroy(vulkan_context* context, struct vulkan_object_
 void vulkan_object_shader_use(vulkan_context* context, struct vulkan_object_shader* shader) {
     u32 image_index = context->image_index;
     vulkan_pipeline_bind(&context->graphics_command_buffers[image_index], VK_PIPELINE_BIND_POINT_GRAPHICS, &shader->pipeline);
+    context->counters.pipeline_binds++;
 }
 
 void vulkan_object_shader_update_global_state(vulkan_context* context, struct vulkan_object_shader* shader, f32 delta_time) {
@@ -212,6 +213,7 @@ void vulkan_object_shader_update_global_state(vulkan_context* context, struct vu
 
     // bind the global descriptor set to be updated
     vkCmdBindDescriptorSets(command_buffer, VK_PIPELINE_BIND_POINT_GRAPHICS, shader->pipeline.pipeline_layout, 0, 1, &global_descriptor, 0, 0);
+    context->counters.descriptor_set_binds++;
 
     u32 range = sizeof(global_uniform_object);
     u64 offset = 0;
@@ -234,6 +236,7 @@ void vulkan_object_shader_update_global_state(vulkan_context* context, struct vu
     descriptor_write.pBufferInfo = &bufferInfo;
 
     vkUpdateDescriptorSets(context->device.logical_device, 1, &descriptor_write, 0, 0);
+    context->counters.descriptor_set_updates++;
 }
 
 void vulkan_object_shader_update_object(vulkan_context* context, struct vulkan_object_shader* shader, geometry_render_data data) {
@@ -319,10 +322,12 @@ void vulkan_object_shader_update_object(vulkan_context* context, struct vulkan_o
 
     if (descriptor_count > 0) {
         vkUpdateDescriptorSets(context->device.logical_device, descriptor_count, descriptor_writes, 0, 0);
+        context->counters.descriptor_set_updates++;
     }
 
     // Bind the descriptor set to be updated, or in case the shader changed.
     vkCmdBindDescriptorSets(command_buffer, VK_PIPELINE_BIND_POINT_GRAPHICS, shader->pipeline.pipeline_layout, 1, 1, &object_descriptor_set, 0, 0);
+    context->counters.descriptor_set_binds++;
 }
 
 b8 vulkan_object_shader_acquire_resources(vulkan_context* context, struct vulkan_object_shader* shader, u32* out_object_id) {
@@ -8,11 +8,13 @@
 #include "vulkan_command_buffer.h"
 #include "vulkan_framebuffer.h"
 #include "vulkan_fence.h"
+#include "vulkan_gpu_timer.h"
 #include "vulkan_utils.h"
 #include "vulkan_buffer.h"
 #include "vulkan_image.h"
 
 #include "core/logger.h"
+#include "core/profiler.h"
 #include "core/vstring.h"
 #include "core/vmemory.h"
 #include "core/application.h"
@@ -201,6 +203,8 @@ b8 vulkan_renderer_backend_initialize(renderer_backend* backend, const char* app
         vulkan_fence_create(&context, true, &context.in_flight_fences[i]);
     }
 
+    vulkan_gpu_timer_create(&context, context.swapchain.max_frames_in_flight, &context.gpu_timer);
+
     context.images_in_flight = darray_reserve(vulkan_fence, context.swapchain.image_count);
     for (u32 i = 0; i < context.swapchain.image_count; ++i) {
         context.images_in_flight[i] = 0;
@@ -255,6 +259,8 @@ void vulkan_renderer_backend_shutdown(renderer_backend* backend) {
     
     vulkan_object_shader_destroy(&context, &context.object_shader);
     
+    vulkan_gpu_timer_destroy(&context, &context.gpu_timer);
+
     // Sync objects
     vkDeviceWaitIdle(context.device.logical_device);
     for (u8 i = 0; i < context.swapchain.max_frames_in_flight; ++i) {
@@ -347,11 +353,13 @@ void vulkan_renderer_backend_on_resized(renderer_backend* backend, u16 width, u1
 }
 
 b8 vulkan_renderer_backend_begin_frame(renderer_backend* backend, f32 delta_time) {
+    PROFILE_SCOPE("vulkan_renderer_backend_begin_frame");
     context.frame_delta_time = delta_time;
     vulkan_device* device = &context.device;
 
     if (context.recreating_swapchain) {
         VkResult result = vkDeviceWaitIdle(device->logical_device);
+        context.counters.queue_waits++;
         if (!vulkan_result_is_success(result)) {
             ERROR("vulkan_renderer_backend_begin_frame - Failed to wait for device idle: %s", vulkan_result_string(result, true));
             return false;
@@ -362,6 +370,7 @@ b8 vulkan_renderer_backend_begin_frame(renderer_backend* backend, f32 delta_time
 
     if (context.framebuffer_size_generation != context.framebuffer_size_last_generation) {
         VkResult result = vkDeviceWaitIdle(device->logical_device);
+        context.counters.queue_waits++;
         if (!vulkan_result_is_success(result)) {
             ERROR("vulkan_renderer_backend_begin_frame - Failed to wait for device idle: %s", vulkan_result_string(result, true));
             return false;
@@ -374,10 +383,16 @@ b8 vulkan_renderer_backend_begin_frame(renderer_backend* backend, f32 delta_time
         return false;
     }
 
+    backend->stats.frame_number = backend->frame_number;
+    backend->stats.fence_wait_ms = 0;
+    backend->stats.present_ms = 0;
+
+    f64 wait_start = platform_get_absolute_time();
     if (!vulkan_fence_wait(&context, &context.in_flight_fences[context.current_frame], UINT64_MAX)) {
         WARN("Failed to wait for in flight fence.");
         return false;
     }
+    backend->stats.fence_wait_ms += (platform_get_absolute_time() - wait_start) * 1000.0;
 
     if(!vulkan_swapchain_acquire_next_image_index(
         &context,
@@ -393,6 +408,10 @@ b8 vulkan_renderer_backend_begin_frame(renderer_backend* backend, f32 delta_time
     vulkan_command_buffer_reset(command_buffer);
     vulkan_command_buffer_begin(command_buffer, false, false, false);
 
+    // This frame's fence has been waited on, so the queries it last used are ready to read.
+    vulkan_gpu_timer_begin_frame(&context, &context.gpu_timer, command_buffer, context.current_frame);
+    backend->stats.gpu_ms = context.gpu_timer.last_frame_ms;
+
     VkViewport viewport;
     viewport.x = 0.0f;
     viewport.y = (f32)context.framebuffer_height;
@@ -412,6 +431,7 @@ b8 vulkan_renderer_backend_begin_frame(renderer_backend* backend, f32 delta_time
     context.main_renderpass.w = context.framebuffer_width;
     context.main_renderpass.h = context.framebuffer_height;
 
+    vulkan_gpu_timer_region_begin(&context.gpu_timer, command_buffer, "main_renderpass");
     vulkan_renderpass_begin(command_buffer, &context.main_renderpass, context.swapchain.framebuffers[context.image_index].handle);
     return true;
 }
@@ -428,20 +448,25 @@ void vulkan_renderer_update_global_state(mat4 projection, mat4 view, vec3 view_p
 }
 
 b8 vulkan_renderer_backend_end_frame(renderer_backend* backend, f32 delta_time) {
+    PROFILE_SCOPE("vulkan_renderer_backend_end_frame");
     
     vulkan_command_buffer* command_buffer = &context.graphics_command_buffers[context.image_index];
 
     // End renderpass
     vulkan_renderpass_end(command_buffer, &context.main_renderpass);
+    vulkan_gpu_timer_region_end(&context.gpu_timer, command_buffer);
+    vulkan_gpu_timer_end_frame(&context.gpu_timer);
 
     vulkan_command_buffer_end(command_buffer);
 
     // Make sure the previous frame is not using this image (i.e. its fence is being waited on)
     if (context.images_in_flight[context.image_index] != VK_NULL_HANDLE) {  // was frame
+        f64 wait_start = platform_get_absolute_time();
         vulkan_fence_wait(
             &context,
             context.images_in_flight[context.image_index],
             UINT64_MAX);
+        backend->stats.fence_wait_ms += (platform_get_absolute_time() - wait_start) * 1000.0;
     }
 
     // Mark the image fence as in-use by this frame.
@@ -481,11 +506,13 @@ b8 vulkan_renderer_backend_end_frame(renderer_backend* backend, f32 delta_time)
         ERROR("vkQueueSubmit - failed with result: %s", vulkan_result_string(result, true));
         return false;
     }
+    context.counters.queue_submits++;
 
     vulkan_command_buffer_update_submitted(command_buffer);
     // End queue submission
 
     // Give the image back to the swapchain.
+    f64 present_start = platform_get_absolute_time();
     vulkan_swapchain_present(
         &context,
         &context.swapchain,
@@ -493,6 +520,10 @@ b8 vulkan_renderer_backend_end_frame(renderer_backend* backend, f32 delta_time)
         context.device.present_queue,
         context.queue_complete_semaphores[context.current_frame],
         context.image_index);
+    backend->stats.present_ms = (platform_get_absolute_time() - present_start) * 1000.0;
+
+    backend->stats.counters = context.counters;
+    vzero_memory(&context.counters, sizeof(renderer_counters));
 
     return true;
 }
@@ -512,7 +543,12 @@ void vulkan_backend_update_object(geometry_render_data data) {
     vkCmdBindIndexBuffer(command_buffer->handle, context.object_index_buffer.handle, 0, VK_INDEX_TYPE_UINT32);
 
     // Issue the draw.
-    vkCmdDrawIndexed(command_buffer->handle, 6, 1, 0, 0, 0);
+    const u32 index_count = 6;
+    vulkan_gpu_timer_region_begin(&context.gpu_timer, command_buffer, "objects");
+    vkCmdDrawIndexed(command_buffer->handle, index_count, 1, 0, 0, 0);
+    vulkan_gpu_timer_region_end(&context.gpu_timer, command_buffer);
+    context.counters.draw_calls++;
+    context.counters.triangles += index_count / 3;
 }
 
 VKAPI_ATTR VkBool32 VKAPI_CALL vk_debug_callback(
@@ -616,6 +652,7 @@ b8 recreate_swapchain(renderer_backend* backend) {
 
     // Wait for any operations to complete.
     vkDeviceWaitIdle(context.device.logical_device);
+    context.counters.queue_waits++;
 
     // Clear these out just in case.
     for (u32 i = 0; i < context.swapchain.image_count; ++i) {
@@ -793,6 +830,7 @@ void vulkan_renderer_create_texture(const char* name, b8 auto_release, i32 width
 
 void vulkan_renderer_destroy_texture(struct texture* texture) {
     vkDeviceWaitIdle(context.device.logical_device);
+    context.counters.queue_waits++;
     vulkan_texture_data* data = (vulkan_texture_data*)texture->internal_data;
 
     vulkan_image_destroy(&context, &data->image);
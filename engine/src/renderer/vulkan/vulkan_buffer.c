@@ -113,6 +113,7 @@ b8 vulkan_buffer_resize(
 
     // Make sure anything potentially using these is finished.
     vkDeviceWaitIdle(context->device.logical_device);
+    context->counters.queue_waits++;
 
     // Destroy the old
     if (buffer->memory) {
@@ -138,11 +139,13 @@ void vulkan_buffer_bind(vulkan_context* context, vulkan_buffer* buffer, u64 offs
 void* vulkan_buffer_lock_memory(vulkan_context* context, vulkan_buffer* buffer, u64 offset, u64 size, u32 flags) {
     void* data;
     VK_CHECK(vkMapMemory(context->device.logical_device, buffer->memory, offset, size, flags, &data));
+    context->counters.buffer_maps++;
     return data;
 }
 
 void vulkan_buffer_unlock_memory(vulkan_context* context, vulkan_buffer* buffer) {
     vkUnmapMemory(context->device.logical_device, buffer->memory);
+    context->counters.buffer_unmaps++;
 }
 
 void vulkan_buffer_load_data(vulkan_context* context, vulkan_buffer* buffer, u64 offset, u64 size, u32 flags, const void* data) {
@@ -150,6 +153,9 @@ void vulkan_buffer_load_data(vulkan_context* context, vulkan_buffer* buffer, u64
     VK_CHECK(vkMapMemory(context->device.logical_device, buffer->memory, offset, size, flags, &data_ptr));
     vcopy_memory(data_ptr, data, size);
     vkUnmapMemory(context->device.logical_device, buffer->memory);
+    context->counters.buffer_maps++;
+    context->counters.buffer_unmaps++;
+    context->counters.bytes_uploaded += size;
 }
 
 void vulkan_buffer_copy_to(
@@ -163,6 +169,7 @@ void vulkan_buffer_copy_to(
     u64 dest_offset,
     u64 size) {
     vkQueueWaitIdle(queue);
+    context->counters.queue_waits++;
     vulkan_command_buffer temp_command_buffer;
     vulkan_command_buffer_allocate_and_begin_single_use(context, pool, &temp_command_buffer);
 
@@ -95,6 +95,8 @@ void vulkan_command_buffer_end_single_use(
     VK_CHECK(vkQueueSubmit(queue, 1, &submit_info, 0));
 
     VK_CHECK(vkQueueWaitIdle(queue));
+    context->counters.queue_submits++;
+    context->counters.queue_waits++;
 
     vulkan_command_buffer_free(context, pool, command_buffer);
  }
\ No newline at end of file
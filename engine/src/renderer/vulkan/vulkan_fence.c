@@ -1,6 +1,7 @@
 #include "vulkan_fence.h"
 
 #include "core/logger.h"
+#include "core/profiler.h"
 
 void vulkan_fence_create(
     vulkan_context* context,
@@ -33,7 +34,9 @@ void vulkan_fence_destroy(vulkan_context* context, vulkan_fence* fence) {
 }
 
 b8 vulkan_fence_wait(vulkan_context* context, vulkan_fence* fence, u64 timeout_ns) {
+    PROFILE_SCOPE("vulkan_fence_wait");
     if (!fence->is_signaled) {
+        context->counters.fence_waits++;
         VkResult result = vkWaitForFences(
             context->device.logical_device,
             1,
@@ -0,0 +1,170 @@
+#include "vulkan_gpu_timer.h"
+
+#include "core/logger.h"
+#include "core/profiler.h"
+#include "core/vmemory.h"
+
+#define VULKAN_GPU_TIMER_MAX_QUEUE_FAMILIES 32
+
+static u32 graphics_timestamp_valid_bits(vulkan_context* context) {
+    u32 family_count = 0;
+    vkGetPhysicalDeviceQueueFamilyProperties(context->device.physical_device, &family_count, 0);
+    if (family_count > VULKAN_GPU_TIMER_MAX_QUEUE_FAMILIES) {
+        family_count = VULKAN_GPU_TIMER_MAX_QUEUE_FAMILIES;
+    }
+    VkQueueFamilyProperties families[VULKAN_GPU_TIMER_MAX_QUEUE_FAMILIES];
+    vkGetPhysicalDeviceQueueFamilyProperties(context->device.physical_device, &family_count, families);
+
+    i32 index = context->device.graphics_queue_index;
+    if (index < 0 || (u32)index >= family_count) {
+        return 0;
+    }
+    return families[index].timestampValidBits;
+}
+
+void vulkan_gpu_timer_create(vulkan_context* context, u32 frame_count, vulkan_gpu_timer* out_timer) {
+    vzero_memory(out_timer, sizeof(vulkan_gpu_timer));
+
+    u32 valid_bits = graphics_timestamp_valid_bits(context);
+    f32 period = context->device.properties.limits.timestampPeriod;
+    if (valid_bits == 0 || period <= 0) {
+        WARN("The graphics queue does not support timestamps; GPU timings are unavailable.");
+        return;
+    }
+
+    out_timer->frames = vallocate(sizeof(vulkan_gpu_timer_frame) * frame_count, MEMORY_TAG_RENDERER);
+    out_timer->frame_count = frame_count;
+    out_timer->period = period;
+    out_timer->valid_mask = valid_bits >= 64 ? ~0ull : ((1ull << valid_bits) - 1);
+
+    VkQueryPoolCreateInfo pool_info = {VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO};
+    pool_info.queryType = VK_QUERY_TYPE_TIMESTAMP;
+    pool_info.queryCount = VULKAN_GPU_TIMER_MAX_REGIONS * 2;
+    for (u32 i = 0; i < frame_count; ++i) {
+        VkResult result = vkCreateQueryPool(context->device.logical_device, &pool_info, context->allocator, &out_timer->frames[i].pool);
+        if (result != VK_SUCCESS) {
+            WARN("Failed to create a timestamp query pool; GPU timings are unavailable.");
+            vulkan_gpu_timer_destroy(context, out_timer);
+            return;
+        }
+    }
+
+    out_timer->supported = true;
+    INFO("GPU timer created: %u valid timestamp bits, %.3fns per tick.", valid_bits, period);
+}
+
+void vulkan_gpu_timer_destroy(vulkan_context* context, vulkan_gpu_timer* timer) {
+    for (u32 i = 0; i < timer->frame_count; ++i) {
+        if (timer->frames[i].pool) {
+            vkDestroyQueryPool(context->device.logical_device, timer->frames[i].pool, context->allocator);
+            timer->frames[i].pool = 0;
+        }
+    }
+    if (timer->frames) {
+        vfree(timer->frames, sizeof(vulkan_gpu_timer_frame) * timer->frame_count, MEMORY_TAG_RENDERER);
+        timer->frames = 0;
+    }
+    timer->frame_count = 0;
+    timer->supported = false;
+}
+
+static void report_results(vulkan_context* context, vulkan_gpu_timer* timer, vulkan_gpu_timer_frame* frame) {
+    u64 timestamps[VULKAN_GPU_TIMER_MAX_REGIONS * 2];
+    // No wait flag: the frame's fence has signalled, so these are ready, and if a driver
+    // disagrees the frame is skipped rather than stalled on.
+    VkResult result = vkGetQueryPoolResults(
+        context->device.logical_device,
+        frame->pool,
+        0,
+        frame->query_count,
+        sizeof(u64) * frame->query_count,
+        timestamps,
+        sizeof(u64),
+        VK_QUERY_RESULT_64_BIT);
+    if (result != VK_SUCCESS) {
+        return;
+    }
+
+    f64 frame_ms = 0;
+    for (u32 i = 0; i < frame->region_count; ++i) {
+        vulkan_gpu_region* region = &frame->regions[i];
+        u64 ticks = (timestamps[region->end_query] - timestamps[region->begin_query]) & timer->valid_mask;
+        f64 milliseconds = (f64)ticks * timer->period / 1000000.0;
+        profiler_record_gpu_zone(region->name, region->depth, milliseconds);
+        if (region->depth == 0) {
+            frame_ms += milliseconds;
+        }
+    }
+    timer->last_frame_ms = frame_ms;
+}
+
+void vulkan_gpu_timer_begin_frame(vulkan_context* context, vulkan_gpu_timer* timer, vulkan_command_buffer* command_buffer, u32 frame_index) {
+    if (!timer->supported) {
+        return;
+    }
+    timer->current_frame = frame_index % timer->frame_count;
+    vulkan_gpu_timer_frame* frame = &timer->frames[timer->current_frame];
+
+    if (frame->pending) {
+        report_results(context, timer, frame);
+        frame->pending = false;
+    }
+
+    vkCmdResetQueryPool(command_buffer->handle, frame->pool, 0, VULKAN_GPU_TIMER_MAX_REGIONS * 2);
+    frame->query_count = 0;
+    frame->region_count = 0;
+    timer->open_count = 0;
+    timer->ignored_count = 0;
+}
+
+void vulkan_gpu_timer_end_frame(vulkan_gpu_timer* timer) {
+    if (!timer->supported) {
+        return;
+    }
+    vulkan_gpu_timer_frame* frame = &timer->frames[timer->current_frame];
+    if (timer->open_count > 0 || timer->ignored_count > 0) {
+        WARN("vulkan_gpu_timer_end_frame - %u GPU regions left open; discarding this frame's timings.", timer->open_count);
+        frame->region_count = 0;
+        timer->open_count = 0;
+        timer->ignored_count = 0;
+    }
+    frame->pending = frame->region_count > 0;
+}
+
+void vulkan_gpu_timer_region_begin(vulkan_gpu_timer* timer, vulkan_command_buffer* command_buffer, const char* name) {
+    if (!timer->supported) {
+        return;
+    }
+    vulkan_gpu_timer_frame* frame = &timer->frames[timer->current_frame];
+    if (frame->region_count == VULKAN_GPU_TIMER_MAX_REGIONS || timer->ignored_count > 0) {
+        // Counted so the matching end is ignored too.
+        timer->ignored_count++;
+        return;
+    }
+
+    u32 index = frame->region_count++;
+    vulkan_gpu_region* region = &frame->regions[index];
+    region->name = name;
+    region->depth = timer->open_count;
+    region->begin_query = frame->query_count++;
+    region->end_query = INVALID_ID;
+    timer->open_regions[timer->open_count++] = index;
+    vkCmdWriteTimestamp(command_buffer->handle, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, frame->pool, region->begin_query);
+}
+
+void vulkan_gpu_timer_region_end(vulkan_gpu_timer* timer, vulkan_command_buffer* command_buffer) {
+    if (!timer->supported) {
+        return;
+    }
+    if (timer->ignored_count > 0) {
+        timer->ignored_count--;
+        return;
+    }
+    if (timer->open_count == 0) {
+        return;
+    }
+    vulkan_gpu_timer_frame* frame = &timer->frames[timer->current_frame];
+    vulkan_gpu_region* region = &frame->regions[timer->open_regions[--timer->open_count]];
+    region->end_query = frame->query_count++;
+    vkCmdWriteTimestamp(command_buffer->handle, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, frame->pool, region->end_query);
+}
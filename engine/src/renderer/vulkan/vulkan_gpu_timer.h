@@ -0,0 +1,50 @@
+#pragma once
+
+#include "vulkan_types.inl"
+
+/*
+ * Times regions of a frame on the GPU with timestamp queries, one query pool
+ * per frame in flight. Results are read when a frame's pool comes around
+ * again, after its fence has been waited on, so reading them never stalls.
+ * They are reported to the profiler beside the CPU zones of that later frame,
+ * and the frame's total is kept in last_frame_ms for the renderer's stats.
+ */
+
+/**
+ * Creates the query pools, if the graphics queue supports timestamps.
+ * @param context A pointer to the Vulkan context.
+ * @param frame_count The number of frames in flight.
+ * @param out_timer A pointer to hold the timer.
+ */
+void vulkan_gpu_timer_create(vulkan_context* context, u32 frame_count, vulkan_gpu_timer* out_timer);
+
+void vulkan_gpu_timer_destroy(vulkan_context* context, vulkan_gpu_timer* timer);
+
+/**
+ * Reports the results of the last use of this frame's queries, then resets
+ * them. Call after waiting on the frame's fence, while recording its command
+ * buffer and outside a render pass.
+ * @param context A pointer to the Vulkan context.
+ * @param timer A pointer to the timer.
+ * @param command_buffer The command buffer being recorded.
+ * @param frame_index The index of the frame in flight.
+ */
+void vulkan_gpu_timer_begin_frame(vulkan_context* context, vulkan_gpu_timer* timer, vulkan_command_buffer* command_buffer, u32 frame_index);
+
+/**
+ * Marks the frame's queries as submitted. Call before submitting its command buffer.
+ */
+void vulkan_gpu_timer_end_frame(vulkan_gpu_timer* timer);
+
+/**
+ * Begins a timed region. Regions may nest.
+ * @param timer A pointer to the timer.
+ * @param command_buffer The command buffer being recorded.
+ * @param name The region name. Must outlive the timer, e.g. a string literal.
+ */
+void vulkan_gpu_timer_region_begin(vulkan_gpu_timer* timer, vulkan_command_buffer* command_buffer, const char* name);
+
+/**
+ * Ends the most recently begun region.
+ */
+void vulkan_gpu_timer_region_end(vulkan_gpu_timer* timer, vulkan_command_buffer* command_buffer);
@@ -213,6 +213,7 @@ void create(vulkan_context* context, u32 width, u32 height, vulkan_swapchain* sw
 
 void destroy(vulkan_context* context, vulkan_swapchain* swapchain) {
     vkDeviceWaitIdle(context->device.logical_device);
+    context->counters.queue_waits++;
     vulkan_image_destroy(context, &swapchain->depth_attachment);
 
     // destroy the views, not the images
@@ -114,6 +114,43 @@ typedef struct vulkan_fence {
     b8 is_signaled;
 } vulkan_fence;
 
+// Timed regions per frame; each uses two timestamp queries.
+#define VULKAN_GPU_TIMER_MAX_REGIONS 32
+
+typedef struct vulkan_gpu_region {
+    const char* name;
+    u32 depth;
+    u32 begin_query;
+    u32 end_query;
+} vulkan_gpu_region;
+
+typedef struct vulkan_gpu_timer_frame {
+    VkQueryPool pool;
+    u32 query_count;
+    u32 region_count;
+    vulkan_gpu_region regions[VULKAN_GPU_TIMER_MAX_REGIONS];
+    // Submitted, with results not read yet.
+    b8 pending;
+} vulkan_gpu_timer_frame;
+
+typedef struct vulkan_gpu_timer {
+    b8 supported;
+    // Nanoseconds per timestamp tick.
+    f64 period;
+    // Timestamps only have this many valid bits, and wrap around.
+    u64 valid_mask;
+    u32 frame_count;
+    // One per frame in flight.
+    vulkan_gpu_timer_frame* frames;
+    u32 current_frame;
+    u32 open_count;
+    u32 open_regions[VULKAN_GPU_TIMER_MAX_REGIONS];
+    // Regions begun after the frame ran out of queries; always the innermost open ones.
+    u32 ignored_count;
+    // Total of the outermost regions of the latest frame whose results were read.
+    f64 last_frame_ms;
+} vulkan_gpu_timer;
+
 typedef struct vulkan_shader_stage {
     VkShaderModuleCreateInfo create_info;
     VkShaderModule handle;
@@ -201,6 +238,10 @@ typedef struct vulkan_context {
     b8 recreating_swapchain;
     
     vulkan_object_shader object_shader;
+
+    vulkan_gpu_timer gpu_timer;
+    // Counted as calls are made; handed over and reset at the end of each frame.
+    renderer_counters counters;
     
     u64 geometry_vertex_offset;
     u64 geometry_index_offset;
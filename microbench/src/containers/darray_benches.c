@@ -0,0 +1,68 @@
+#include "darray_benches.h"
+#include "../microbench_manager.h"
+
+#include <defines.h>
+
+#include <containers/darray.h>
+
+// Elements in the array for the insert and remove benchmarks.
+#define DARRAY_BENCH_LENGTH 1024
+
+static u64* array;
+
+static void darray_bench_setup(void* user_data) {
+    array = darray_create(u64);
+    for (u64 i = 0; i < DARRAY_BENCH_LENGTH; ++i) {
+        darray_push(array, i);
+    }
+}
+
+static void darray_bench_teardown(void* user_data) {
+    darray_destroy(array);
+    array = 0;
+}
+
+static void darray_push_bench(void* user_data, u64 iterations) {
+    // Pushes onto an empty array; it keeps its capacity between batches, so growth is only
+    // paid for while calibrating and warming up.
+    darray_clear(array);
+    for (u64 i = 0; i < iterations; ++i) {
+        darray_push(array, i);
+    }
+    microbench_consume(darray_length(array));
+}
+
+static void darray_pop_at_back_bench(void* user_data, u64 iterations) {
+    u64 sum = 0;
+    for (u64 i = 0; i < iterations; ++i) {
+        darray_push(array, i);
+        u64 value;
+        darray_pop_at(array, darray_length(array) - 1, &value);
+        sum += value;
+    }
+    microbench_consume(sum);
+}
+
+/**
+ * Inserts and then removes an element at the given index, shifting everything after it twice.
+ */
+static void darray_insert_pop_at_bench(void* user_data, u64 iterations) {
+    u64 index = *(u64*)user_data;
+    u64 sum = 0;
+    for (u64 i = 0; i < iterations; ++i) {
+        darray_insert_at(array, index, i);
+        u64 value;
+        darray_pop_at(array, index, &value);
+        sum += value;
+    }
+    microbench_consume(sum);
+}
+
+void darray_register_benches() {
+    static u64 front = 0;
+    static u64 middle = DARRAY_BENCH_LENGTH / 2;
+    microbench_manager_register("darray_push", darray_bench_setup, darray_push_bench, darray_bench_teardown, 0);
+    microbench_manager_register("darray_push + pop_at (back)", darray_bench_setup, darray_pop_at_back_bench, darray_bench_teardown, 0);
+    microbench_manager_register("darray_insert_at + pop_at (middle of 1024)", darray_bench_setup, darray_insert_pop_at_bench, darray_bench_teardown, &middle);
+    microbench_manager_register("darray_insert_at + pop_at (front of 1024)", darray_bench_setup, darray_insert_pop_at_bench, darray_bench_teardown, &front);
+}
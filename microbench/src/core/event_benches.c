@@ -0,0 +1,54 @@
+#include "event_benches.h"
+#include "../microbench_manager.h"
+
+#include <defines.h>
+
+#include <core/event.h>
+#include <core/vmemory.h>
+
+#define EVENT_BENCH_CODE 0x100
+#define EVENT_BENCH_MAX_LISTENERS 256
+
+static void* event_bench_state;
+static u64 event_bench_state_size;
+// One distinct listener each; only their addresses matter.
+static u8 listeners[EVENT_BENCH_MAX_LISTENERS];
+static u64 handled_count;
+
+static b8 event_bench_on_event(u16 code, void* sender, void* listener, event_context context) {
+    handled_count++;
+    // Not handled, so every listener is called.
+    return false;
+}
+
+static void event_bench_setup(void* user_data) {
+    u32 listener_count = *(u32*)user_data;
+    event_system_initialize(&event_bench_state_size, 0);
+    event_bench_state = vallocate(event_bench_state_size, MEMORY_TAG_APPLICATION);
+    event_system_initialize(&event_bench_state_size, event_bench_state);
+    for (u32 i = 0; i < listener_count; ++i) {
+        event_register(EVENT_BENCH_CODE, &listeners[i], event_bench_on_event);
+    }
+}
+
+static void event_bench_teardown(void* user_data) {
+    event_system_shutdown(event_bench_state);
+    vfree(event_bench_state, event_bench_state_size, MEMORY_TAG_APPLICATION);
+    event_bench_state = 0;
+}
+
+static void event_fire_bench(void* user_data, u64 iterations) {
+    event_context context = {};
+    for (u64 i = 0; i < iterations; ++i) {
+        context.data.u64[0] = i;
+        event_fire(EVENT_BENCH_CODE, 0, context);
+    }
+    microbench_consume(handled_count);
+}
+
+void event_register_benches() {
+    static u32 counts[] = {1, 16, EVENT_BENCH_MAX_LISTENERS};
+    microbench_manager_register("event_fire (1 listener)", event_bench_setup, event_fire_bench, event_bench_teardown, &counts[0]);
+    microbench_manager_register("event_fire (16 listeners)", event_bench_setup, event_fire_bench, event_bench_teardown, &counts[1]);
+    microbench_manager_register("event_fire (256 listeners)", event_bench_setup, event_fire_bench, event_bench_teardown, &counts[2]);
+}
@@ -0,0 +1,3 @@
+#pragma once
+
+void event_register_benches();
@@ -0,0 +1,24 @@
+#include "vmemory_benches.h"
+#include "../microbench_manager.h"
+
+#include <defines.h>
+
+#include <core/vmemory.h>
+
+static void vallocate_vfree_bench(void* user_data, u64 iterations) {
+    u64 size = *(u64*)user_data;
+    u64 sum = 0;
+    for (u64 i = 0; i < iterations; ++i) {
+        u8* block = vallocate(size, MEMORY_TAG_ARRAY);
+        sum += block[0];
+        vfree(block, size, MEMORY_TAG_ARRAY);
+    }
+    microbench_consume(sum);
+}
+
+void vmemory_register_benches() {
+    static u64 small = 64;
+    static u64 large = 64 * 1024;
+    microbench_manager_register("vallocate + vfree (64B)", 0, vallocate_vfree_bench, 0, &small);
+    microbench_manager_register("vallocate + vfree (64KiB)", 0, vallocate_vfree_bench, 0, &large);
+}
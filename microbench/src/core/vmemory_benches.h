@@ -0,0 +1,3 @@
+#pragma once
+
+void vmemory_register_benches();
@@ -0,0 +1,33 @@
+#include "microbench_manager.h"
+
+#include "math/vmath_benches.h"
+#include "containers/darray_benches.h"
+#include "memory/linear_allocator_benches.h"
+#include "core/vmemory_benches.h"
+#include "core/event_benches.h"
+#include <core/logger.h>
+#include <core/vmemory.h>
+
+int main() {
+    // Allocations are tracked as in the engine, which is part of their cost.
+    u64 memory_system_size;
+    memory_system_initialize(&memory_system_size, 0);
+    void* memory_system_state = vallocate(memory_system_size, MEMORY_TAG_APPLICATION);
+    memory_system_initialize(&memory_system_size, memory_system_state);
+
+    microbench_manager_init();
+
+    vmath_register_benches();
+    darray_register_benches();
+    linear_allocator_register_benches();
+    vmemory_register_benches();
+    event_register_benches();
+
+    DEBUG("=> Starting benchmarks...");
+
+    b8 result = microbench_manager_run();
+
+    memory_system_shutdown(memory_system_state);
+    vfree(memory_system_state, memory_system_size, MEMORY_TAG_APPLICATION);
+    return result ? 0 : 1;
+}
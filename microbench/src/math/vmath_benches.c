@@ -0,0 +1,97 @@
+#include "vmath_benches.h"
+#include "../microbench_manager.h"
+
+#include <defines.h>
+
+#include <math/vmath.h>
+
+// Inputs cycled through, so every operation has fresh operands but all stay in cache.
+#define VMATH_BENCH_INPUT_COUNT 64
+
+static mat4 matrices[VMATH_BENCH_INPUT_COUNT];
+static quat quats_from[VMATH_BENCH_INPUT_COUNT];
+static quat quats_to[VMATH_BENCH_INPUT_COUNT];
+static vec3 vectors[VMATH_BENCH_INPUT_COUNT];
+
+static void vmath_bench_setup(void* user_data) {
+    // Rigid transforms, so products and inverses stay well conditioned.
+    for (u32 i = 0; i < VMATH_BENCH_INPUT_COUNT; ++i) {
+        f32 a = (f32)i * 0.37f;
+        mat4 rotation = mat4_euler_xyz(a, a * 0.5f, a * 0.25f);
+        matrices[i] = mat4_mul(rotation, mat4_translation((vec3){a, -a, a * 2.0f}));
+        quats_from[i] = quat_from_axis_angle((vec3){0, 1, 0}, a, true);
+        quats_to[i] = quat_from_axis_angle((vec3){1, 0, 0}, a * 2.0f, true);
+        vectors[i] = (vec3){a + 1.0f, a * 2.0f - 3.0f, 5.0f - a};
+    }
+}
+
+// Every result is stored and summed once timing ends, so the inlined math can't be
+// trimmed down to the elements a sum would read.
+static mat4 mat4_results[VMATH_BENCH_INPUT_COUNT];
+static quat quat_results[VMATH_BENCH_INPUT_COUNT];
+static vec3 vec3_results[VMATH_BENCH_INPUT_COUNT];
+
+static f32 sum_floats(const f32* values, u32 count) {
+    f32 sum = 0;
+    for (u32 i = 0; i < count; ++i) {
+        sum += values[i];
+    }
+    return sum;
+}
+
+static void mat4_mul_bench(void* user_data, u64 iterations) {
+    for (u64 i = 0; i < iterations; ++i) {
+        u32 index = i % VMATH_BENCH_INPUT_COUNT;
+        mat4_results[index] = mat4_mul(matrices[index], matrices[(i + 1) % VMATH_BENCH_INPUT_COUNT]);
+    }
+    f32 sum = 0;
+    for (u32 i = 0; i < VMATH_BENCH_INPUT_COUNT; ++i) {
+        sum += sum_floats(mat4_results[i].data, 16);
+    }
+    microbench_consume_f32(sum);
+}
+
+static void mat4_inverse_bench(void* user_data, u64 iterations) {
+    for (u64 i = 0; i < iterations; ++i) {
+        u32 index = i % VMATH_BENCH_INPUT_COUNT;
+        mat4_results[index] = mat4_inverse(matrices[index]);
+    }
+    f32 sum = 0;
+    for (u32 i = 0; i < VMATH_BENCH_INPUT_COUNT; ++i) {
+        sum += sum_floats(mat4_results[i].data, 16);
+    }
+    microbench_consume_f32(sum);
+}
+
+static void quat_slerp_bench(void* user_data, u64 iterations) {
+    for (u64 i = 0; i < iterations; ++i) {
+        u32 index = i % VMATH_BENCH_INPUT_COUNT;
+        quat_results[index] = quat_slerp(quats_from[index], quats_to[index], (f32)(i & 255) / 255.0f);
+    }
+    f32 sum = 0;
+    for (u32 i = 0; i < VMATH_BENCH_INPUT_COUNT; ++i) {
+        sum += sum_floats(quat_results[i].elements, 4);
+    }
+    microbench_consume_f32(sum);
+}
+
+static void vec3_normalize_bench(void* user_data, u64 iterations) {
+    for (u64 i = 0; i < iterations; ++i) {
+        u32 index = i % VMATH_BENCH_INPUT_COUNT;
+        vec3 v = vectors[index];
+        vec3_normalize(&v);
+        vec3_results[index] = v;
+    }
+    f32 sum = 0;
+    for (u32 i = 0; i < VMATH_BENCH_INPUT_COUNT; ++i) {
+        sum += sum_floats(vec3_results[i].elements, 3);
+    }
+    microbench_consume_f32(sum);
+}
+
+void vmath_register_benches() {
+    microbench_manager_register("mat4_mul", vmath_bench_setup, mat4_mul_bench, 0, 0);
+    microbench_manager_register("mat4_inverse", vmath_bench_setup, mat4_inverse_bench, 0, 0);
+    microbench_manager_register("quat_slerp", vmath_bench_setup, quat_slerp_bench, 0, 0);
+    microbench_manager_register("vec3_normalize", vmath_bench_setup, vec3_normalize_bench, 0, 0);
+}
@@ -0,0 +1,3 @@
+#pragma once
+
+void vmath_register_benches();
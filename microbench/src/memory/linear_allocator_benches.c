@@ -0,0 +1,51 @@
+#include "linear_allocator_benches.h"
+#include "../microbench_manager.h"
+
+#include <defines.h>
+
+#include <memory/linear_allocator.h>
+
+#define LINEAR_ALLOCATOR_BENCH_SIZE (1024 * 1024)
+
+static linear_allocator allocator;
+
+static void linear_allocator_bench_setup(void* user_data) {
+    linear_allocator_create(LINEAR_ALLOCATOR_BENCH_SIZE, 0, &allocator);
+}
+
+static void linear_allocator_bench_teardown(void* user_data) {
+    linear_allocator_destroy(&allocator);
+}
+
+static void linear_allocator_allocate_bench(void* user_data, u64 iterations) {
+    u64 size = *(u64*)user_data;
+    u64 sum = 0;
+    for (u64 i = 0; i < iterations; ++i) {
+        // Rewound before running out. Not linear_allocator_free_all, which zeroes the
+        // used memory and would dominate the large case; that has its own benchmark.
+        if (allocator.allocated + size > allocator.total_size) {
+            allocator.allocated = 0;
+        }
+        sum += (u64)linear_allocator_allocate(&allocator, size);
+    }
+    microbench_consume(sum);
+}
+
+static void linear_allocator_free_all_bench(void* user_data, u64 iterations) {
+    u64 sum = 0;
+    for (u64 i = 0; i < iterations; ++i) {
+        // A full allocator, so every reset zeroes the whole block.
+        allocator.allocated = allocator.total_size;
+        linear_allocator_free_all(&allocator);
+        sum += ((u8*)allocator.memory)[i % allocator.total_size];
+    }
+    microbench_consume(sum);
+}
+
+void linear_allocator_register_benches() {
+    static u64 small = 16;
+    static u64 large = 4096;
+    microbench_manager_register("linear_allocator_allocate (16B)", linear_allocator_bench_setup, linear_allocator_allocate_bench, linear_allocator_bench_teardown, &small);
+    microbench_manager_register("linear_allocator_allocate (4KiB)", linear_allocator_bench_setup, linear_allocator_allocate_bench, linear_allocator_bench_teardown, &large);
+    microbench_manager_register("linear_allocator_free_all (1MiB)", linear_allocator_bench_setup, linear_allocator_free_all_bench, linear_allocator_bench_teardown, 0);
+}
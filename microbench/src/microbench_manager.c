@@ -0,0 +1,177 @@
+#include "microbench_manager.h"
+
+#include <containers/darray.h>
+#include <core/logger.h>
+#include <platform/platform.h>
+
+#include <math.h>
+
+typedef struct microbench_entry {
+    const char* name;
+    PFN_microbench_setup setup;
+    PFN_microbench_run run;
+    PFN_microbench_teardown teardown;
+    void* user_data;
+} microbench_entry;
+
+typedef struct microbench_result {
+    f64 mean_ns;
+    f64 median_ns;
+    f64 min_ns;
+    f64 stddev_ns;
+    u32 kept_count;
+    u64 iterations;
+} microbench_result;
+
+static microbench_entry* benches;
+
+static volatile u64 microbench_sink;
+
+void microbench_consume(u64 value) {
+    microbench_sink += value;
+}
+
+void microbench_consume_f32(f32 value) {
+    union {
+        f32 f;
+        u32 u;
+    } bits;
+    bits.f = value;
+    microbench_sink += bits.u;
+}
+
+static void sort_f64(f64* values, u32 count) {
+    for (u32 i = 1; i < count; ++i) {
+        f64 value = values[i];
+        u32 j = i;
+        while (j > 0 && values[j - 1] > value) {
+            values[j] = values[j - 1];
+            --j;
+        }
+        values[j] = value;
+    }
+}
+
+static f64 abs_f64(f64 value) {
+    return value < 0 ? -value : value;
+}
+
+static f64 median_of_sorted(const f64* sorted, u32 count) {
+    return count % 2 ? sorted[count / 2] : (sorted[count / 2 - 1] + sorted[count / 2]) * 0.5;
+}
+
+/**
+ * Runs one batch.
+ * @returns The time it took in seconds.
+ */
+static f64 time_batch(const microbench_entry* bench, u64 iterations) {
+    f64 start = platform_get_absolute_time();
+    bench->run(bench->user_data, iterations);
+    return platform_get_absolute_time() - start;
+}
+
+/**
+ * Times a benchmark.
+ * @returns False if the clock didn't advance, in which case nothing can be measured.
+ */
+static b8 measure(const microbench_entry* bench, microbench_result* out_result) {
+    // Grow the batch until the clock resolves it well.
+    u64 iterations = 1;
+    f64 batch_seconds;
+    while ((batch_seconds = time_batch(bench, iterations)) < MICROBENCH_MIN_SAMPLE_SECONDS && iterations < (1ull << 40)) {
+        if (batch_seconds <= 0 && iterations >= MICROBENCH_CLOCK_CHECK_ITERATIONS) {
+            ERROR("%s: %llu iterations took no time; the clock isn't advancing.", bench->name, iterations);
+            return false;
+        }
+        iterations *= 2;
+    }
+
+    f64 warmup_end = platform_get_absolute_time() + MICROBENCH_WARMUP_SECONDS;
+    while (platform_get_absolute_time() < warmup_end) {
+        time_batch(bench, iterations);
+    }
+
+    f64 samples[MICROBENCH_SAMPLE_COUNT];
+    for (u32 i = 0; i < MICROBENCH_SAMPLE_COUNT; ++i) {
+        samples[i] = time_batch(bench, iterations) * 1e9 / (f64)iterations;
+    }
+    sort_f64(samples, MICROBENCH_SAMPLE_COUNT);
+    f64 median = median_of_sorted(samples, MICROBENCH_SAMPLE_COUNT);
+
+    // Median absolute deviation, scaled to match the standard deviation of normal samples.
+    f64 deviations[MICROBENCH_SAMPLE_COUNT];
+    for (u32 i = 0; i < MICROBENCH_SAMPLE_COUNT; ++i) {
+        deviations[i] = abs_f64(samples[i] - median);
+    }
+    sort_f64(deviations, MICROBENCH_SAMPLE_COUNT);
+    f64 mad = median_of_sorted(deviations, MICROBENCH_SAMPLE_COUNT) * 1.4826;
+
+    // Two passes in f64: the one-pass sum of squares cancels badly when the spread is tiny next to the mean.
+    b8 kept_samples[MICROBENCH_SAMPLE_COUNT];
+    f64 sum = 0;
+    u32 kept = 0;
+    for (u32 i = 0; i < MICROBENCH_SAMPLE_COUNT; ++i) {
+        kept_samples[i] = mad == 0 || abs_f64(samples[i] - median) <= MICROBENCH_OUTLIER_MADS * mad;
+        if (kept_samples[i]) {
+            sum += samples[i];
+            kept++;
+        }
+    }
+    f64 mean = sum / kept;
+    f64 sum_squared_deviations = 0;
+    for (u32 i = 0; i < MICROBENCH_SAMPLE_COUNT; ++i) {
+        if (kept_samples[i]) {
+            sum_squared_deviations += (samples[i] - mean) * (samples[i] - mean);
+        }
+    }
+
+    out_result->mean_ns = mean;
+    out_result->stddev_ns = sqrt(sum_squared_deviations / kept);
+    out_result->median_ns = median;
+    out_result->min_ns = samples[0];
+    out_result->kept_count = kept;
+    out_result->iterations = iterations;
+    return true;
+}
+
+void microbench_manager_init() {
+    benches = darray_create(microbench_entry);
+}
+
+void microbench_manager_register(const char* name, PFN_microbench_setup setup, PFN_microbench_run run, PFN_microbench_teardown teardown, void* user_data) {
+    microbench_entry e;
+    e.name = name;
+    e.setup = setup;
+    e.run = run;
+    e.teardown = teardown;
+    e.user_data = user_data;
+    darray_push(benches, e);
+}
+
+b8 microbench_manager_run() {
+    u32 count = darray_length(benches);
+    INFO("%-48s %12s %16s %10s %10s %10s %8s", "benchmark", "ns/op", "ops/s", "median", "min", "stddev", "kept");
+    for (u32 i = 0; i < count; ++i) {
+        microbench_entry* bench = &benches[i];
+        if (bench->setup) {
+            bench->setup(bench->user_data);
+        }
+
+        microbench_result result;
+        b8 measured = measure(bench, &result);
+
+        if (bench->teardown) {
+            bench->teardown(bench->user_data);
+        }
+        if (!measured) {
+            return false;
+        }
+
+        f64 ops_per_second = result.mean_ns > 0 ? 1e9 / result.mean_ns : 0;
+        INFO("%-48s %12.3f %16.0f %10.3f %10.3f %10.3f %5u/%u",
+             bench->name, result.mean_ns, ops_per_second, result.median_ns, result.min_ns, result.stddev_ns,
+             result.kept_count, MICROBENCH_SAMPLE_COUNT);
+    }
+    INFO("Ran %u benchmarks, %u samples each.", count, MICROBENCH_SAMPLE_COUNT);
+    return true;
+}
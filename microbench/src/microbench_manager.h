@@ -0,0 +1,68 @@
+#pragma once
+
+#include <defines.h>
+
+/*
+ * Times small operations by running them in batches long enough for the clock
+ * to resolve, after a warmup. Each batch gives one sample of the time per
+ * operation; samples far from the median (preemption, page faults) are
+ * rejected before the rest are summarized.
+ */
+
+// Samples taken per benchmark.
+#define MICROBENCH_SAMPLE_COUNT 31
+// Each batch is grown until it takes at least this long.
+#define MICROBENCH_MIN_SAMPLE_SECONDS 0.002
+// Time spent running batches before sampling, to warm caches and branch predictors.
+#define MICROBENCH_WARMUP_SECONDS 0.05
+// Samples more than this many (scaled) median absolute deviations from the median are outliers.
+#define MICROBENCH_OUTLIER_MADS 3.0
+// A batch this large that takes no time at all means the clock isn't advancing.
+#define MICROBENCH_CLOCK_CHECK_ITERATIONS (1ull << 24)
+
+/**
+ * Prepares state for a benchmark. Not timed.
+ * @param user_data The user data given when registering.
+ */
+typedef void (*PFN_microbench_setup)(void* user_data);
+
+/**
+ * Runs the operation being measured the given number of times. Fold results
+ * into microbench_consume so the compiler can't remove the work.
+ * @param user_data The user data given when registering.
+ * @param iterations The number of operations to run.
+ */
+typedef void (*PFN_microbench_run)(void* user_data, u64 iterations);
+
+/**
+ * Releases what setup acquired. Not timed.
+ * @param user_data The user data given when registering.
+ */
+typedef void (*PFN_microbench_teardown)(void* user_data);
+
+void microbench_manager_init();
+
+/**
+ * Registers a benchmark.
+ * @param name The name reported with the results.
+ * @param setup Called before the benchmark runs. May be 0.
+ * @param run Runs the operation.
+ * @param teardown Called after the benchmark ran. May be 0.
+ * @param user_data Passed to setup, run and teardown.
+ */
+void microbench_manager_register(const char* name, PFN_microbench_setup setup, PFN_microbench_run run, PFN_microbench_teardown teardown, void* user_data);
+
+/**
+ * Runs and reports every registered benchmark.
+ * @returns False if the clock doesn't advance; otherwise true.
+ */
+b8 microbench_manager_run();
+
+/**
+ * Keeps a value alive so the work producing it can't be optimized away. Call
+ * once per batch with an accumulated value rather than once per operation.
+ */
+void microbench_consume(u64 value);
+
+/** As microbench_consume, for floating point results. */
+void microbench_consume_f32(f32 value);
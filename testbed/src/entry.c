@@ -9,6 +9,15 @@ b8 create_game(game* game) {
     game->config.width = 1280;
     game->config.height = 720;
     game->config.name = "vGo Engine";
+    game->config.target_frame_rate = 60;
+    // Optional, off by default: set to e.g. 60 for a fixed timestep with interpolated rendering.
+    game->config.fixed_update_rate = 0;
+    game->config.max_updates_per_frame = 0;
+    // Optional, off by default: set to 2 or 3 to draw on a render thread.
+    game->config.render_buffer_count = 0;
+    // Optional, off by default: set to a base path to write frame statistics on exit.
+    // F7 writes them on demand either way.
+    game->config.frame_stats_path = 0;
 
     game->initialize = game_initialize;
     game->update = game_update;
@@ -3,6 +3,7 @@
 #include <core/logger.h>
 #include <core/vmemory.h>
 #include <core/input.h>
+#include <core/profiler.h>
 
 // temporary
 #include <renderer/renderer_frontend.h>
@@ -51,6 +52,36 @@ b8 game_initialize(game* game_inst) {
     state->view = mat4_translation(state->camera_position);
     state->view = mat4_inverse(state->view);
     state->camera_view_dirty = true;
+    state->prev_camera_position = state->camera_position;
+    state->prev_camera_euler = state->camera_euler;
+
+    keys key;
+    key = 'W';
+    state->action_move_forward = input_action_bind("move_forward", 1, &key, 0);
+    key = 'S';
+    state->action_move_backward = input_action_bind("move_backward", 1, &key, 0);
+    key = 'A';
+    state->action_move_left = input_action_bind("move_left", 1, &key, 0);
+    key = 'D';
+    state->action_move_right = input_action_bind("move_right", 1, &key, 0);
+    key = KEY_LEFT;
+    state->action_yaw_left = input_action_bind("yaw_left", 1, &key, 0);
+    key = KEY_RIGHT;
+    state->action_yaw_right = input_action_bind("yaw_right", 1, &key, 0);
+    key = KEY_UP;
+    state->action_pitch_up = input_action_bind("pitch_up", 1, &key, 0);
+    key = KEY_DOWN;
+    state->action_pitch_down = input_action_bind("pitch_down", 1, &key, 0);
+    key = 'M';
+    state->action_debug_allocations = input_action_bind("debug_allocations", 1, &key, 0);
+    key = KEY_F9;
+    state->action_toggle_recording = input_action_bind("toggle_recording", 1, &key, 0);
+    key = KEY_F10;
+    state->action_replay = input_action_bind("replay", 1, &key, 0);
+    key = KEY_F8;
+    state->action_export_profile = input_action_bind("export_profile", 1, &key, 0);
+    key = KEY_F7;
+    state->action_export_frame_stats = input_action_bind("export_frame_stats", 1, &key, 0);
 
     DEBUG("Game initialized!");
     return true;
@@ -60,46 +91,75 @@ b8 game_update(game* game_inst, f32 delta_time) {
     static u64 alloc_count = 0;
     u64 prev_alloc_count = alloc_count;
     alloc_count = get_memory_alloc_count();
-    if (input_key_up('M') && input_was_key_down('M')) {
+    game_state* state = (game_state*)game_inst->state;
+    state->prev_camera_position = state->camera_position;
+    state->prev_camera_euler = state->camera_euler;
+
+    if (input_action_released(state->action_debug_allocations)) {
         DEBUG("Allocations: %llu (%llu this frame)", alloc_count, alloc_count - prev_alloc_count);
     }
-    game_state* state = (game_state*)game_inst->state;
 
-    if (input_key_down(KEY_LEFT)) {
+    // F8 logs the zones of the last frame and saves a trace of the last few seconds.
+    if (input_action_released(state->action_export_profile)) {
+        profiler_log_frame();
+        profiler_export_chrome_trace("profile.json");
+    }
+
+    // F7 logs frame time percentiles and saves the recent frames.
+    if (input_action_released(state->action_export_frame_stats)) {
+        application_write_frame_stats("frame_stats");
+    }
+
+    // F9 toggles input recording, F10 replays the last recording.
+    // Ignored during replay, the recording itself contains these key presses.
+    if (!input_is_replaying()) {
+        if (input_action_released(state->action_toggle_recording)) {
+            if (input_is_recording()) {
+                input_recording_stop();
+            } else {
+                input_recording_start("input.rec");
+            }
+        }
+        if (input_action_released(state->action_replay) && !input_is_recording()) {
+            input_replay_start("input.rec", false);
+        }
+    }
+
+    if (input_action_held(state->action_yaw_left)) {
         camera_yaw(state, 1.0f * delta_time);
     }
 
-    if (input_key_down(KEY_RIGHT)) {
+    if (input_action_held(state->action_yaw_right)) {
         camera_yaw(state, -1.0f * delta_time);
     }
 
-    if (input_key_down(KEY_UP)) {
+    if (input_action_held(state->action_pitch_up)) {
         camera_pitch(state, 1.0f * delta_time);
     }
 
-    if (input_key_down(KEY_DOWN)) {
+    if (input_action_held(state->action_pitch_down)) {
         camera_pitch(state, -1.0f * delta_time);
     }
 
     f32 move_speed = 50.0f;
     vec3 velocity = vec3_zero();
 
-    if (input_key_down('W')) {
+    if (input_action_held(state->action_move_forward)) {
         vec3 forward = mat4_forward(state->view);
         velocity = vec3_add(velocity, forward);
     }
 
-    if (input_key_down('S')) {
+    if (input_action_held(state->action_move_backward)) {
         vec3 backward = mat4_backward(state->view);
         velocity = vec3_add(velocity, backward);
     }
 
-    if (input_key_down('A')) {
+    if (input_action_held(state->action_move_left)) {
         vec3 left = mat4_left(state->view);
         velocity = vec3_add(velocity, left);
     }
 
-    if (input_key_down('D')) {
+    if (input_action_held(state->action_move_right)) {
         vec3 right = mat4_right(state->view);
         velocity = vec3_add(velocity, right);
     }
@@ -115,12 +175,22 @@ b8 game_update(game* game_inst, f32 delta_time) {
 
     recalculate_view_matrix(state);
 
-    renderer_set_view(state->view); // temporary
-
     return true;
 }
 
-b8 game_render(game* game_inst,  f32 delta_time) {
+static vec3 vec3_lerp(vec3 a, vec3 b, f32 t) {
+    return vec3_add(a, vec3_mul_scalar(vec3_sub(b, a), t));
+}
+
+b8 game_render(game* game_inst, f32 delta_time, f32 alpha) {
+    game_state* state = (game_state*)game_inst->state;
+
+    // Render between the last two updates so motion stays smooth when the update rate is fixed.
+    vec3 euler = vec3_lerp(state->prev_camera_euler, state->camera_euler, alpha);
+    vec3 position = vec3_lerp(state->prev_camera_position, state->camera_position, alpha);
+    mat4 view = mat4_mul(mat4_euler_xyz(euler.x, euler.y, euler.z), mat4_translation(position));
+    renderer_set_view(mat4_inverse(view)); // temporary
+
     return true;
 }
 
@@ -10,12 +10,30 @@ typedef struct game_state {
     vec3 camera_position;
     vec3 camera_euler;
     b8 camera_view_dirty;
+    // Camera as of the previous update, interpolated towards the current one when rendering.
+    vec3 prev_camera_position;
+    vec3 prev_camera_euler;
+
+    // Input action ids, bound in game_initialize.
+    u32 action_move_forward;
+    u32 action_move_backward;
+    u32 action_move_left;
+    u32 action_move_right;
+    u32 action_yaw_left;
+    u32 action_yaw_right;
+    u32 action_pitch_up;
+    u32 action_pitch_down;
+    u32 action_debug_allocations;
+    u32 action_toggle_recording;
+    u32 action_replay;
+    u32 action_export_profile;
+    u32 action_export_frame_stats;
 } game_state;
 
 b8 game_initialize(struct game* game_inst);
 
 b8 game_update(struct game* game_inst, f32 delta_time);
 
-b8 game_render(struct game* game_inst, f32 delta_time);
+b8 game_render(struct game* game_inst, f32 delta_time, f32 alpha);
 
 void game_on_resize(struct game* game_inst, u32 width, u32 height);
\ No newline at end of file
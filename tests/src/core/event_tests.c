@@ -0,0 +1,395 @@
+#include "event_tests.h"
+#include "../test_manager.h"
+#include "../expect.h"
+#include "../test_systems.h"
+
+#include <defines.h>
+
+#include <core/event.h>
+#include <core/vmemory.h>
+#include <core/logger.h>
+
+#define TEST_CODE_A 0x100
+#define TEST_CODE_B 0x101
+
+typedef struct event_test_listener {
+    u16 codes[32];
+    u32 values[32];
+    u32 count;
+} event_test_listener;
+
+static b8 event_test_record(u16 code, void* sender, void* listener, event_context context) {
+    event_test_listener* l = listener;
+    if (l->count < 32) {
+        l->codes[l->count] = code;
+        l->values[l->count] = context.data.u32[0];
+    }
+    l->count++;
+    return false;
+}
+
+static b8 event_test_post_again(u16 code, void* sender, void* listener, event_context context) {
+    event_test_record(code, sender, listener, context);
+    event_post(TEST_CODE_B, 0, context);
+    return false;
+}
+
+static void event_test_post(u16 code, u32 value) {
+    event_context context = {};
+    context.data.u32[0] = value;
+    event_post(code, 0, context);
+}
+
+u8 event_post_should_defer_until_dispatch() {
+    test_event_system_begin();
+    event_test_listener l = {};
+    event_register(TEST_CODE_A, &l, event_test_record);
+
+    event_test_post(TEST_CODE_A, 1);
+    expect_should_be(0, l.count);
+
+    event_dispatch_pending();
+    expect_should_be(1, l.count);
+    expect_should_be(1, l.values[0]);
+
+    // Queue should be empty after dispatch.
+    event_dispatch_pending();
+    expect_should_be(1, l.count);
+
+    test_event_system_end();
+    return true;
+}
+
+u8 event_dispatch_should_group_by_code() {
+    test_event_system_begin();
+    event_test_listener l = {};
+    event_register(TEST_CODE_A, &l, event_test_record);
+    event_register(TEST_CODE_B, &l, event_test_record);
+
+    event_test_post(TEST_CODE_A, 1);
+    event_test_post(TEST_CODE_B, 2);
+    event_test_post(TEST_CODE_A, 3);
+    event_test_post(TEST_CODE_B, 4);
+    event_dispatch_pending();
+
+    expect_should_be(4, l.count);
+    expect_should_be(TEST_CODE_A, l.codes[0]);
+    expect_should_be(1, l.values[0]);
+    expect_should_be(TEST_CODE_A, l.codes[1]);
+    expect_should_be(3, l.values[1]);
+    expect_should_be(TEST_CODE_B, l.codes[2]);
+    expect_should_be(2, l.values[2]);
+    expect_should_be(TEST_CODE_B, l.codes[3]);
+    expect_should_be(4, l.values[3]);
+
+    test_event_system_end();
+    return true;
+}
+
+u8 event_post_during_dispatch_should_defer_to_next_dispatch() {
+    test_event_system_begin();
+    event_test_listener a = {};
+    event_test_listener b = {};
+    event_register(TEST_CODE_A, &a, event_test_post_again);
+    event_register(TEST_CODE_B, &b, event_test_record);
+
+    event_test_post(TEST_CODE_A, 7);
+    event_dispatch_pending();
+    expect_should_be(1, a.count);
+    expect_should_be(0, b.count);
+
+    event_dispatch_pending();
+    expect_should_be(1, b.count);
+    expect_should_be(7, b.values[0]);
+
+    test_event_system_end();
+    return true;
+}
+
+static event_test_listener* unregister_target;
+
+static b8 event_test_unregister_other(u16 code, void* sender, void* listener, event_context context) {
+    event_test_record(code, sender, listener, context);
+    event_unregister(code, unregister_target, event_test_record);
+    event_register(code, listener, event_test_record);
+    return false;
+}
+
+u8 event_unregister_during_fire_should_be_safe() {
+    test_event_system_begin();
+    event_test_listener first = {};
+    event_test_listener second = {};
+    event_test_listener third = {};
+    unregister_target = &second;
+    event_register(TEST_CODE_A, &first, event_test_unregister_other);
+    event_register(TEST_CODE_A, &second, event_test_record);
+    event_register(TEST_CODE_A, &third, event_test_record);
+
+    event_context context = {};
+    event_fire(TEST_CODE_A, 0, context);
+    expect_should_be(1, first.count);
+    expect_should_be(0, second.count);
+    // Must not be skipped by the removal of the listener before it.
+    expect_should_be(1, third.count);
+
+    // Unregistered listener should be gone, and able to register again.
+    expect_to_be_false(event_unregister(TEST_CODE_A, &second, event_test_record));
+    expect_to_be_true(event_register(TEST_CODE_A, &second, event_test_record));
+
+    test_event_system_end();
+    return true;
+}
+
+u8 event_post_threadsafe_should_deliver_on_dispatch() {
+    test_event_system_begin();
+    event_test_listener l = {};
+    event_register(TEST_CODE_A, &l, event_test_record);
+
+    event_context context = {};
+    context.data.u32[0] = 42;
+    expect_to_be_true(event_post_threadsafe(TEST_CODE_A, 0, context));
+    expect_should_be(0, l.count);
+
+    event_dispatch_pending();
+    expect_should_be(1, l.count);
+    expect_should_be(42, l.values[0]);
+
+    // Fill the inbox until it reports full, then make sure it recovers after draining.
+    u32 posted = 0;
+    while (event_post_threadsafe(TEST_CODE_A, 0, context)) {
+        posted++;
+    }
+    expect_should_not_be(0, posted);
+    event_dispatch_pending();
+    expect_should_be(1 + posted, l.count);
+    expect_to_be_true(event_post_threadsafe(TEST_CODE_A, 0, context));
+
+    test_event_system_end();
+    return true;
+}
+
+u8 event_coalesce_should_keep_latest_or_accumulate() {
+    test_event_system_begin();
+    event_test_listener l = {};
+    event_register(TEST_CODE_A, &l, event_test_record);
+    event_register(TEST_CODE_B, &l, event_test_record);
+    event_set_coalesce_policy(TEST_CODE_A, EVENT_COALESCE_KEEP_LATEST);
+    event_set_coalesce_policy(TEST_CODE_B, EVENT_COALESCE_ACCUMULATE);
+
+    for (u32 i = 1; i <= 10; ++i) {
+        event_test_post(TEST_CODE_A, i);
+        event_test_post(TEST_CODE_B, i);
+    }
+    event_dispatch_pending();
+
+    expect_should_be(2, l.count);
+    expect_should_be(TEST_CODE_A, l.codes[0]);
+    expect_should_be(10, l.values[0]);
+    expect_should_be(TEST_CODE_B, l.codes[1]);
+    expect_should_be(55, l.values[1]);
+
+    // Coalescing only applies within a frame.
+    event_test_post(TEST_CODE_A, 11);
+    event_dispatch_pending();
+    expect_should_be(3, l.count);
+    expect_should_be(11, l.values[2]);
+
+    test_event_system_end();
+    return true;
+}
+
+static char payload_received[64];
+static u64 payload_received_size;
+
+static b8 event_test_copy_payload(u16 code, void* sender, void* listener, event_context context) {
+    payload_received_size = context.data.payload.size;
+    u64 size = payload_received_size < sizeof(payload_received) ? payload_received_size : sizeof(payload_received);
+    vcopy_memory(payload_received, context.data.payload.block, size);
+    return false;
+}
+
+u8 event_post_payload_should_copy_data() {
+    test_event_system_begin();
+    event_register(TEST_CODE_A, 0, event_test_copy_payload);
+
+    char path[] = "assets/shaders/Builtin.ObjectShader.frag.spv";
+    expect_to_be_true(event_post_payload(TEST_CODE_A, 0, path, sizeof(path)));
+    // The sender's buffer does not need to outlive the post.
+    vzero_memory(path, sizeof(path));
+
+    event_dispatch_pending();
+    expect_should_be(sizeof(path), payload_received_size);
+    expect_should_be('a', payload_received[0]);
+    expect_should_be('v', payload_received[sizeof(path) - 2]);
+
+    test_event_system_end();
+    return true;
+}
+
+u8 event_post_payload_should_fail_when_arena_exhausted() {
+    test_event_system_begin();
+    // Only counts; the payloads are larger than payload_received.
+    event_test_listener l = {};
+    event_register(TEST_CODE_A, &l, event_test_record);
+
+    static u8 big[4096];
+    DEBUG("Note: The following warning is intentionally caused by this test.");
+    u32 posted = 0;
+    while (event_post_payload(TEST_CODE_A, 0, big, sizeof(big))) {
+        posted++;
+    }
+    expect_should_not_be(0, posted);
+
+    // Arena is recycled after dispatch.
+    event_dispatch_pending();
+    expect_should_be(posted, l.count);
+    event_dispatch_pending();
+    expect_to_be_true(event_post_payload(TEST_CODE_A, 0, big, sizeof(big)));
+
+    test_event_system_end();
+    return true;
+}
+
+static u32 call_order[8];
+static u32 call_order_count;
+
+static b8 event_test_order_low(u16 code, void* sender, void* listener, event_context context) {
+    call_order[call_order_count++] = 1;
+    return false;
+}
+
+static b8 event_test_order_normal(u16 code, void* sender, void* listener, event_context context) {
+    call_order[call_order_count++] = 2;
+    return false;
+}
+
+static b8 event_test_order_high_handled(u16 code, void* sender, void* listener, event_context context) {
+    call_order[call_order_count++] = 3;
+    return context.data.u32[0] == 1;
+}
+
+u8 event_register_handle_should_order_by_priority() {
+    test_event_system_begin();
+    call_order_count = 0;
+    event_register_handle(TEST_CODE_A, 0, event_test_order_low, EVENT_PRIORITY_LOW);
+    event_register_handle(TEST_CODE_A, 0, event_test_order_normal, EVENT_PRIORITY_NORMAL);
+    event_handle high = event_register_handle(TEST_CODE_A, 0, event_test_order_high_handled, EVENT_PRIORITY_HIGH);
+    expect_should_not_be(INVALID_EVENT_HANDLE, high);
+
+    event_context context = {};
+    event_fire(TEST_CODE_A, 0, context);
+    expect_should_be(3, call_order_count);
+    expect_should_be(3, call_order[0]);
+    expect_should_be(2, call_order[1]);
+    expect_should_be(1, call_order[2]);
+
+    // Highest priority listener handling the event stops the rest.
+    call_order_count = 0;
+    context.data.u32[0] = 1;
+    expect_to_be_true(event_fire(TEST_CODE_A, 0, context));
+    expect_should_be(1, call_order_count);
+
+    test_event_system_end();
+    return true;
+}
+
+u8 event_unregister_handle_should_remove_only_that_registration() {
+    test_event_system_begin();
+    event_test_listener l = {};
+    event_handle first = event_register_handle(TEST_CODE_A, &l, event_test_record, EVENT_PRIORITY_NORMAL);
+    event_handle second = event_register_handle(TEST_CODE_A, &l, event_test_record, EVENT_PRIORITY_NORMAL);
+
+    event_context context = {};
+    event_fire(TEST_CODE_A, 0, context);
+    expect_should_be(2, l.count);
+
+    expect_to_be_true(event_unregister_handle(first));
+    // Stale handles are rejected.
+    expect_to_be_false(event_unregister_handle(first));
+
+    event_fire(TEST_CODE_A, 0, context);
+    expect_should_be(3, l.count);
+
+    expect_to_be_true(event_unregister_handle(second));
+    event_fire(TEST_CODE_A, 0, context);
+    expect_should_be(3, l.count);
+
+    test_event_system_end();
+    return true;
+}
+
+u8 event_profiling_should_count_fires_and_calls() {
+    test_event_system_begin();
+    event_test_listener l = {};
+    event_handle handle = event_register_handle(TEST_CODE_A, &l, event_test_record, EVENT_PRIORITY_NORMAL);
+
+    event_context context = {};
+    event_fire(TEST_CODE_A, 0, context);
+    expect_should_be(0, event_profiling_get_fire_count(TEST_CODE_A));
+
+    event_profiling_set_enabled(true);
+    for (u32 i = 0; i < 5; ++i) {
+        event_fire(TEST_CODE_A, 0, context);
+    }
+    event_fire(TEST_CODE_B, 0, context);
+
+    expect_should_be(5, event_profiling_get_fire_count(TEST_CODE_A));
+    expect_should_be(1, event_profiling_get_fire_count(TEST_CODE_B));
+
+    event_handler_stats stats;
+    expect_to_be_true(event_profiling_get_handler_stats(handle, &stats));
+    expect_should_be(5, stats.call_count);
+    b8 max_within_total = stats.total_seconds >= stats.max_seconds;
+    expect_to_be_true(max_within_total);
+
+    event_profiling_reset();
+    expect_should_be(0, event_profiling_get_fire_count(TEST_CODE_A));
+
+    test_event_system_end();
+    return true;
+}
+
+static event_handle reregister_handle;
+
+static b8 event_test_reregister(u16 code, void* sender, void* listener, event_context context) {
+    event_unregister_handle(reregister_handle);
+    // Takes the slot just freed.
+    reregister_handle = event_register_handle(code, listener, event_test_record, EVENT_PRIORITY_NORMAL);
+    return false;
+}
+
+u8 event_profiling_should_not_charge_a_reused_slot() {
+    test_event_system_begin();
+    event_test_listener l = {};
+    event_handle first = event_register_handle(TEST_CODE_A, &l, event_test_reregister, EVENT_PRIORITY_NORMAL);
+    reregister_handle = first;
+
+    event_profiling_set_enabled(true);
+    event_context context = {};
+    event_fire(TEST_CODE_A, 0, context);
+
+    b8 slot_reused = (reregister_handle & 0xFFFFFFFF) == (first & 0xFFFFFFFF);
+    expect_to_be_true(slot_reused);
+    event_handler_stats stats;
+    expect_to_be_true(event_profiling_get_handler_stats(reregister_handle, &stats));
+    expect_should_be(0, stats.call_count);
+    expect_should_be(0, l.count);
+
+    test_event_system_end();
+    return true;
+}
+
+void event_register_tests() {
+    test_manager_register_test(event_post_should_defer_until_dispatch, "Event post should defer until dispatch");
+    test_manager_register_test(event_dispatch_should_group_by_code, "Event dispatch should group by code");
+    test_manager_register_test(event_post_during_dispatch_should_defer_to_next_dispatch, "Event posted during dispatch should defer to next dispatch");
+    test_manager_register_test(event_unregister_during_fire_should_be_safe, "Event unregister during fire should be safe");
+    test_manager_register_test(event_post_threadsafe_should_deliver_on_dispatch, "Event threadsafe post should deliver on dispatch");
+    test_manager_register_test(event_coalesce_should_keep_latest_or_accumulate, "Event coalescing should keep latest or accumulate");
+    test_manager_register_test(event_post_payload_should_copy_data, "Event payload should be copied into the frame arena");
+    test_manager_register_test(event_post_payload_should_fail_when_arena_exhausted, "Event payload post should fail when arena exhausted");
+    test_manager_register_test(event_register_handle_should_order_by_priority, "Event listeners should be called in priority order");
+    test_manager_register_test(event_unregister_handle_should_remove_only_that_registration, "Event unregister by handle should remove only that registration");
+    test_manager_register_test(event_profiling_should_count_fires_and_calls, "Event profiling should count fires and handler calls");
+    test_manager_register_test(event_profiling_should_not_charge_a_reused_slot, "Event profiling should not charge a reregistration in a reused slot");
+}
@@ -0,0 +1,145 @@
+#include "frame_stats_tests.h"
+#include "../test_manager.h"
+#include "../expect.h"
+
+#include <defines.h>
+
+#include <core/frame_stats.h>
+#include <core/vmemory.h>
+#include <core/vstring.h>
+#include <platform/filesystem.h>
+
+#include <stdio.h>
+
+static void record_frame_time(frame_stats* stats, f32 frame_ms) {
+    frame_sample sample = {};
+    sample.values[FRAME_STAT_FRAME] = frame_ms;
+    sample.values[FRAME_STAT_CPU] = frame_ms * 0.5f;
+    frame_stats_record(stats, &sample);
+}
+
+u8 frame_stats_should_compute_percentiles() {
+    frame_stats* stats = vallocate(sizeof(frame_stats), MEMORY_TAG_APPLICATION);
+    frame_stats_reset(stats);
+
+    // 1..100ms, recorded out of order.
+    for (u32 i = 0; i < 100; ++i) {
+        record_frame_time(stats, (f32)((i * 37) % 100 + 1));
+    }
+
+    frame_stats_summary summary;
+    frame_stats_summarize(stats, &summary);
+    expect_should_be(100, summary.sample_count);
+    const frame_stat_summary* frame = &summary.stats[FRAME_STAT_FRAME];
+    expect_float_to_be(50.5f, frame->mean);
+    expect_float_to_be(50.0f, frame->p50);
+    expect_float_to_be(95.0f, frame->p95);
+    expect_float_to_be(99.0f, frame->p99);
+    expect_float_to_be(100.0f, frame->max);
+    expect_float_to_be(25.0f, summary.stats[FRAME_STAT_CPU].p50);
+    expect_float_to_be(0.0f, summary.stats[FRAME_STAT_GPU].max);
+
+    vfree(stats, sizeof(frame_stats), MEMORY_TAG_APPLICATION);
+    return true;
+}
+
+u8 frame_stats_should_keep_most_recent_frames() {
+    frame_stats* stats = vallocate(sizeof(frame_stats), MEMORY_TAG_APPLICATION);
+    frame_stats_reset(stats);
+
+    // A slow start that falls out of the ring.
+    for (u32 i = 0; i < 10; ++i) {
+        record_frame_time(stats, 500.0f);
+    }
+    for (u32 i = 0; i < FRAME_STATS_CAPACITY; ++i) {
+        record_frame_time(stats, 16.0f);
+    }
+
+    frame_stats_summary summary;
+    frame_stats_summarize(stats, &summary);
+    expect_should_be(FRAME_STATS_CAPACITY, summary.sample_count);
+    expect_should_be(FRAME_STATS_CAPACITY + 10, stats->frame_count);
+    expect_float_to_be(16.0f, summary.stats[FRAME_STAT_FRAME].max);
+    expect_should_be(0, summary.hitch_count);
+
+    vfree(stats, sizeof(frame_stats), MEMORY_TAG_APPLICATION);
+    return true;
+}
+
+u8 frame_stats_should_count_hitches() {
+    frame_stats* stats = vallocate(sizeof(frame_stats), MEMORY_TAG_APPLICATION);
+    frame_stats_reset(stats);
+
+    for (u32 i = 0; i < 200; ++i) {
+        // Every 50th frame takes three times as long.
+        record_frame_time(stats, i % 50 == 49 ? 48.0f : 16.0f);
+    }
+    // Not over twice the median.
+    record_frame_time(stats, 30.0f);
+
+    frame_stats_summary summary;
+    frame_stats_summarize(stats, &summary);
+    expect_should_be(4, summary.hitch_count);
+
+    frame_stats_reset(stats);
+    frame_stats_summarize(stats, &summary);
+    expect_should_be(0, summary.sample_count);
+
+    vfree(stats, sizeof(frame_stats), MEMORY_TAG_APPLICATION);
+    return true;
+}
+
+u8 frame_stats_should_write_csv_and_json() {
+    frame_stats* stats = vallocate(sizeof(frame_stats), MEMORY_TAG_APPLICATION);
+    frame_stats_reset(stats);
+    for (u32 i = 0; i < 3; ++i) {
+        record_frame_time(stats, 10.0f + i);
+    }
+
+    const char* csv_path = "frame_stats_test.csv";
+    const char* json_path = "frame_stats_test.json";
+    expect_to_be_true(frame_stats_write_csv(stats, csv_path));
+    expect_to_be_true(frame_stats_write_json(stats, json_path));
+
+    file_handle file;
+    char* line = 0;
+    expect_to_be_true(filesystem_open(csv_path, FILE_MODE_READ, false, &file));
+    u32 line_count = 0;
+    b8 header_ok = false;
+    b8 last_row_ok = false;
+    while (filesystem_read_line(&file, &line)) {
+        if (line_count == 0) {
+            header_ok = strings_equal(line, "frame,frame_ms,cpu_ms,gpu_ms,fence_wait_ms,present_ms\n");
+        } else if (line_count == 3) {
+            last_row_ok = strings_equal(line, "2,12.0000,6.0000,0.0000,0.0000,0.0000\n");
+        }
+        line_count++;
+        vfree(line, string_length(line) + 1, MEMORY_TAG_STRING);
+        line = 0;
+    }
+    filesystem_close(&file);
+    expect_should_be(4, line_count);
+    expect_to_be_true(header_ok);
+    expect_to_be_true(last_row_ok);
+
+    u8* bytes = 0;
+    u64 size = 0;
+    expect_to_be_true(filesystem_open(json_path, FILE_MODE_READ, false, &file));
+    expect_to_be_true(filesystem_read_all_bytes(&file, &bytes, &size));
+    filesystem_close(&file);
+    b8 valid = size > 2 && bytes[0] == '{' && bytes[size - 2] == '}';
+    vfree(bytes, size, MEMORY_TAG_STRING);
+    expect_to_be_true(valid);
+
+    remove(csv_path);
+    remove(json_path);
+    vfree(stats, sizeof(frame_stats), MEMORY_TAG_APPLICATION);
+    return true;
+}
+
+void frame_stats_register_tests() {
+    test_manager_register_test(frame_stats_should_compute_percentiles, "Frame stats should compute percentiles");
+    test_manager_register_test(frame_stats_should_keep_most_recent_frames, "Frame stats should keep most recent frames");
+    test_manager_register_test(frame_stats_should_count_hitches, "Frame stats should count hitches");
+    test_manager_register_test(frame_stats_should_write_csv_and_json, "Frame stats should write CSV and JSON");
+}
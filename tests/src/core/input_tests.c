@@ -0,0 +1,269 @@
+#include "input_tests.h"
+#include "../test_manager.h"
+#include "../expect.h"
+#include "../test_systems.h"
+
+#include <defines.h>
+
+#include <core/event.h>
+#include <core/input.h>
+#include <core/vmemory.h>
+
+#include <stdio.h>
+
+static void input_test_begin() {
+    test_event_system_begin();
+    test_input_system_begin();
+}
+
+static void input_test_end() {
+    test_input_system_end();
+    test_event_system_end();
+}
+
+static void input_test_next_frame() {
+    event_dispatch_pending();
+    input_update_actions();
+    input_update(0);
+}
+
+u8 input_action_should_report_pressed_held_released() {
+    input_test_begin();
+    keys key = 'W';
+    u32 action = input_action_bind("forward", 1, &key, 0);
+    expect_should_not_be(INVALID_ID, action);
+    expect_should_be(action, input_action_get("forward"));
+
+    input_process_key('W', true);
+    input_test_next_frame();
+    expect_to_be_true(input_action_pressed(action));
+    expect_to_be_true(input_action_held(action));
+    expect_to_be_false(input_action_released(action));
+
+    input_test_next_frame();
+    expect_to_be_false(input_action_pressed(action));
+    expect_to_be_true(input_action_held(action));
+
+    input_process_key('W', false);
+    input_test_next_frame();
+    expect_to_be_false(input_action_held(action));
+    expect_to_be_true(input_action_released(action));
+
+    input_test_next_frame();
+    expect_to_be_false(input_action_released(action));
+
+    input_test_end();
+    return true;
+}
+
+u8 input_action_chord_should_require_all_inputs() {
+    input_test_begin();
+    keys chord[2] = {KEY_CONTROL, 'S'};
+    u32 save = input_action_bind("save", 2, chord, 0);
+    keys alt_key = KEY_F2;
+    // An alternative binding with a mouse button.
+    expect_should_be(save, input_action_bind("save", 1, &alt_key, INPUT_BUTTON_MASK(BUTTON_RIGHT)));
+
+    input_process_key('S', true);
+    input_test_next_frame();
+    expect_to_be_false(input_action_held(save));
+
+    input_process_key(KEY_CONTROL, true);
+    input_test_next_frame();
+    expect_to_be_true(input_action_pressed(save));
+
+    input_process_key('S', false);
+    input_process_key(KEY_CONTROL, false);
+    input_process_key(KEY_F2, true);
+    input_test_next_frame();
+    expect_to_be_false(input_action_held(save));
+
+    input_process_button(BUTTON_RIGHT, true);
+    input_test_next_frame();
+    expect_to_be_true(input_action_held(save));
+
+    input_action_unbind_all(save);
+    input_test_next_frame();
+    expect_to_be_true(input_action_released(save));
+
+    input_test_end();
+    return true;
+}
+
+u8 input_events_should_keep_order_until_end_of_frame() {
+    input_test_begin();
+
+    input_process_key('W', true);
+    input_process_button(BUTTON_LEFT, true);
+    input_process_mouse_move(10, 20);
+    input_process_mouse_wheel(-3);
+    input_process_key('W', false);
+
+    expect_should_be(5, input_event_count());
+    const input_event* e = input_event_get(0);
+    expect_should_be(INPUT_EVENT_KEY, e->type);
+    expect_should_be('W', e->code);
+    b8 pressed = e->pressed;
+    expect_to_be_true(pressed);
+    e = input_event_get(1);
+    expect_should_be(INPUT_EVENT_BUTTON, e->type);
+    expect_should_be(BUTTON_LEFT, e->code);
+    e = input_event_get(2);
+    expect_should_be(INPUT_EVENT_MOUSE_MOVE, e->type);
+    expect_should_be(10, e->x);
+    expect_should_be(20, e->y);
+    e = input_event_get(3);
+    expect_should_be(INPUT_EVENT_MOUSE_WHEEL, e->type);
+    expect_should_be(-3, e->z_delta);
+    e = input_event_get(4);
+    expect_should_be(INPUT_EVENT_KEY, e->type);
+    pressed = e->pressed;
+    expect_to_be_false(pressed);
+    expect_should_be(0, input_event_get(5));
+
+    // Stamped as received.
+    for (u32 i = 1; i < 5; ++i) {
+        b8 in_order = input_event_get(i)->timestamp >= input_event_get(i - 1)->timestamp;
+        expect_to_be_true(in_order);
+    }
+
+    // Only the frame's own events are kept.
+    input_test_next_frame();
+    expect_should_be(0, input_event_count());
+    expect_should_be(0, input_event_get(0));
+
+    input_process_mouse_wheel(1);
+    expect_should_be(1, input_event_count());
+    expect_should_be(1, input_event_get(0)->z_delta);
+
+    input_test_end();
+    return true;
+}
+
+// INPUT_EVENT_BUFFER_SIZE in input.c.
+#define INPUT_TEST_EVENT_BUFFER_SIZE 512
+// More than the buffer holds.
+#define INPUT_TEST_EVENT_COUNT 600
+
+u8 input_events_should_wrap_and_keep_newest_on_overflow() {
+    input_test_begin();
+
+    // Leaves the next frame starting partway through the buffer, so its events wrap around the end.
+    for (i32 i = 0; i < 300; ++i) {
+        input_process_mouse_wheel(i + 1);
+    }
+    input_test_next_frame();
+
+    for (i32 i = 0; i < 300; ++i) {
+        input_process_mouse_wheel(i + 1);
+    }
+    expect_should_be(300, input_event_count());
+    for (u32 i = 0; i < 300; ++i) {
+        expect_should_be((i32)i + 1, input_event_get(i)->z_delta);
+    }
+    input_test_next_frame();
+
+    // The oldest events of the frame are dropped.
+    for (i32 i = 0; i < INPUT_TEST_EVENT_COUNT; ++i) {
+        input_process_mouse_wheel(i + 1);
+    }
+    expect_should_be(INPUT_TEST_EVENT_BUFFER_SIZE, input_event_count());
+    for (u32 i = 0; i < INPUT_TEST_EVENT_BUFFER_SIZE; ++i) {
+        expect_should_be((i32)(INPUT_TEST_EVENT_COUNT - INPUT_TEST_EVENT_BUFFER_SIZE + i + 1), input_event_get(i)->z_delta);
+    }
+    input_test_next_frame();
+    expect_should_be(0, input_event_count());
+
+    input_test_end();
+    return true;
+}
+
+#define INPUT_TEST_RECORDING "input_test.rec"
+
+u8 input_replay_should_reproduce_recording() {
+    input_test_begin();
+
+    // Recording starts with the next frame.
+    b8 started = input_recording_start(INPUT_TEST_RECORDING);
+    expect_to_be_true(started);
+    input_test_next_frame();
+
+    // Frame 0: two fixed updates.
+    input_process_key('W', true);
+    input_recording_frame(2, 0.25f, 10.0004);
+    input_test_next_frame();
+
+    // Frame 1: no update, as when the frame took less than a fixed step.
+    input_recording_frame(0, 0.25f, 10.1004);
+    input_test_next_frame();
+
+    // Frame 2: the recording ends with this frame.
+    input_process_key('W', false);
+    input_recording_stop();
+    b8 recording = input_is_recording();
+    expect_to_be_false(recording);
+    input_recording_frame(1, 0.25f, 10.3004);
+    input_test_next_frame();
+
+    // Live input is ignored while replaying.
+    started = input_replay_start(INPUT_TEST_RECORDING, false);
+    expect_to_be_true(started);
+    input_test_next_frame();
+
+    u32 update_count = 0;
+    f32 update_delta_time = 0;
+    f64 time = 0;
+    input_replay_update();
+    b8 down = input_key_down('W');
+    expect_to_be_true(down);
+    b8 has_frame = input_replay_frame(&update_count, &update_delta_time, &time);
+    expect_to_be_true(has_frame);
+    expect_should_be(2, update_count);
+    expect_float_to_be(0.25f, update_delta_time);
+    // Shifted by whole ticks to just after the (unstarted) timers' time of 0.
+    f64 first_time = time;
+    b8 in_range = first_time > 0 && first_time < 0.001;
+    expect_to_be_true(in_range);
+    input_test_next_frame();
+
+    input_replay_update();
+    down = input_key_down('W');
+    expect_to_be_true(down);
+    has_frame = input_replay_frame(&update_count, &update_delta_time, &time);
+    expect_to_be_true(has_frame);
+    expect_should_be(0, update_count);
+    f64 drift = time - first_time - 0.1;
+    in_range = drift > -0.000001 && drift < 0.000001;
+    expect_to_be_true(in_range);
+    input_test_next_frame();
+
+    input_replay_update();
+    down = input_key_down('W');
+    expect_to_be_false(down);
+    has_frame = input_replay_frame(&update_count, &update_delta_time, &time);
+    expect_to_be_true(has_frame);
+    expect_should_be(1, update_count);
+    drift = time - first_time - 0.3;
+    in_range = drift > -0.000001 && drift < 0.000001;
+    expect_to_be_true(in_range);
+    input_test_next_frame();
+
+    // The end marker was fed with the last frame.
+    input_replay_update();
+    b8 replaying = input_is_replaying();
+    expect_to_be_false(replaying);
+    has_frame = input_replay_frame(&update_count, &update_delta_time, &time);
+    expect_to_be_false(has_frame);
+
+    input_test_end();
+    remove(INPUT_TEST_RECORDING);
+    return true;
+}
+
+void input_register_tests() {
+    test_manager_register_test(input_action_should_report_pressed_held_released, "Input action should report pressed, held and released");
+    test_manager_register_test(input_action_chord_should_require_all_inputs, "Input action chord should require all inputs");
+    test_manager_register_test(input_events_should_keep_order_until_end_of_frame, "Input events should keep order until end of frame");
+    test_manager_register_test(input_events_should_wrap_and_keep_newest_on_overflow, "Input events should wrap and keep newest on overflow");
+    test_manager_register_test(input_replay_should_reproduce_recording, "Input replay should reproduce the recording");
+}
@@ -0,0 +1,129 @@
+#include "job_system_tests.h"
+#include "../test_manager.h"
+#include "../expect.h"
+#include "../test_systems.h"
+
+#include <defines.h>
+
+#include <core/job_system.h>
+#include <core/vmemory.h>
+#include <platform/vatomic.h>
+
+#define JOB_TEST_WORKER_COUNT 3
+#define JOB_TEST_JOB_COUNT 2000
+
+static void job_test_increment(void* params) {
+    vatomic_fetch_add_u32((u32*)params, 1, VMEMORY_ORDER_RELAXED);
+}
+
+typedef struct job_test_stage {
+    u32 values[64];
+    u32 sum;
+    u32 sum_is_complete;
+} job_test_stage;
+
+static job_test_stage job_test_stage_data;
+
+static void job_test_write_value(void* params) {
+    u32 index = (u32)(u64)params;
+    job_test_stage_data.values[index] = index + 1;
+}
+
+static void job_test_sum_values(void* params) {
+    u32 sum = 0;
+    for (u32 i = 0; i < 64; ++i) {
+        sum += job_test_stage_data.values[i];
+    }
+    job_test_stage_data.sum = sum;
+}
+
+typedef struct job_test_parent {
+    u32 child_count;
+    job_counter children;
+} job_test_parent;
+
+static void job_test_spawn_children(void* params) {
+    job_test_parent* parent = params;
+    job_desc children[16];
+    for (u32 i = 0; i < 16; ++i) {
+        children[i].entry = job_test_increment;
+        children[i].params = &parent->child_count;
+        children[i].priority = JOB_PRIORITY_NORMAL;
+    }
+    job_submit(children, 16, &parent->children);
+    // Waiting inside a job runs other jobs instead of blocking the worker.
+    job_wait(&parent->children);
+}
+
+u8 job_system_should_run_every_job() {
+    test_job_system_begin(JOB_TEST_WORKER_COUNT);
+    expect_should_be(JOB_TEST_WORKER_COUNT + 1, job_system_thread_count());
+
+    static job_desc jobs[JOB_TEST_JOB_COUNT];
+    u32 count = 0;
+    for (u32 i = 0; i < JOB_TEST_JOB_COUNT; ++i) {
+        jobs[i].entry = job_test_increment;
+        jobs[i].params = &count;
+        jobs[i].priority = (job_priority)(i % JOB_PRIORITY_COUNT);
+    }
+    job_counter counter = {};
+    job_submit(jobs, JOB_TEST_JOB_COUNT, &counter);
+    job_wait(&counter);
+    expect_should_be(JOB_TEST_JOB_COUNT, vatomic_load_u32(&count, VMEMORY_ORDER_ACQUIRE));
+    expect_should_be(0, counter.value);
+
+    test_job_system_end();
+    return true;
+}
+
+u8 job_submit_after_should_wait_for_dependency() {
+    test_job_system_begin(JOB_TEST_WORKER_COUNT);
+    vzero_memory(&job_test_stage_data, sizeof(job_test_stage));
+
+    job_desc writes[64];
+    for (u32 i = 0; i < 64; ++i) {
+        writes[i].entry = job_test_write_value;
+        writes[i].params = (void*)(u64)i;
+        writes[i].priority = JOB_PRIORITY_NORMAL;
+    }
+    job_desc sum = {job_test_sum_values, 0, JOB_PRIORITY_HIGH};
+
+    job_counter write_counter = {};
+    job_counter sum_counter = {};
+    job_submit(writes, 64, &write_counter);
+    job_submit_after(&write_counter, &sum, 1, &sum_counter);
+    job_wait(&sum_counter);
+    // 1 + 2 + ... + 64
+    expect_should_be(2080, job_test_stage_data.sum);
+
+    test_job_system_end();
+    return true;
+}
+
+u8 job_wait_inside_job_should_not_deadlock() {
+    test_job_system_begin(JOB_TEST_WORKER_COUNT);
+
+    // More parents than threads, so every thread ends up waiting inside a job.
+    job_test_parent parents[16] = {};
+    job_desc jobs[16];
+    for (u32 i = 0; i < 16; ++i) {
+        jobs[i].entry = job_test_spawn_children;
+        jobs[i].params = &parents[i];
+        jobs[i].priority = JOB_PRIORITY_NORMAL;
+    }
+    job_counter counter = {};
+    job_submit(jobs, 16, &counter);
+    job_wait(&counter);
+    for (u32 i = 0; i < 16; ++i) {
+        expect_should_be(16, parents[i].child_count);
+    }
+
+    test_job_system_end();
+    return true;
+}
+
+void job_system_register_tests() {
+    test_manager_register_test(job_system_should_run_every_job, "Job system should run every job");
+    test_manager_register_test(job_submit_after_should_wait_for_dependency, "Job submit after should wait for dependency");
+    test_manager_register_test(job_wait_inside_job_should_not_deadlock, "Job wait inside a job should not deadlock");
+}
@@ -0,0 +1,105 @@
+#include "parallel_tests.h"
+#include "../test_manager.h"
+#include "../expect.h"
+#include "../test_systems.h"
+
+#include <defines.h>
+
+#include <containers/darray.h>
+#include <core/job_system.h>
+#include <core/parallel.h>
+#include <core/vmemory.h>
+
+#define PARALLEL_TEST_WORKER_COUNT 3
+#define PARALLEL_TEST_COUNT 100000
+
+static void parallel_test_square_indices(u64 begin, u64 end, void* user_data) {
+    u64* values = user_data;
+    for (u64 i = begin; i < end; ++i) {
+        values[i] = i * i;
+    }
+}
+
+static void parallel_test_scale(void* elements, u64 first_index, u64 count, void* user_data) {
+    f32* values = elements;
+    f32 scale = *(f32*)user_data;
+    for (u64 i = 0; i < count; ++i) {
+        values[i] = (f32)(first_index + i) * scale;
+    }
+}
+
+static void parallel_test_sum_range(u64 begin, u64 end, void* partial, void* user_data) {
+    const f32* values = user_data;
+    f32 sum = *(f32*)partial;
+    for (u64 i = begin; i < end; ++i) {
+        sum += values[i];
+    }
+    *(f32*)partial = sum;
+}
+
+static void parallel_test_combine_sum(void* accumulator, const void* partial, void* user_data) {
+    *(f32*)accumulator += *(const f32*)partial;
+}
+
+u8 parallel_for_should_visit_every_index_once() {
+    test_job_system_begin(PARALLEL_TEST_WORKER_COUNT);
+    u64* values = vallocate(sizeof(u64) * PARALLEL_TEST_COUNT, MEMORY_TAG_ARRAY);
+
+    parallel_for(PARALLEL_TEST_COUNT, 0, parallel_test_square_indices, values);
+    for (u64 i = 0; i < PARALLEL_TEST_COUNT; ++i) {
+        if (values[i] != i * i) {
+            expect_should_be(i * i, values[i]);
+        }
+    }
+
+    vfree(values, sizeof(u64) * PARALLEL_TEST_COUNT, MEMORY_TAG_ARRAY);
+    test_job_system_end();
+    return true;
+}
+
+u8 darray_parallel_for_should_visit_every_element() {
+    test_job_system_begin(PARALLEL_TEST_WORKER_COUNT);
+    f32* values = darray_reserve(f32, 1000);
+    darray_length_set(values, 1000);
+
+    f32 scale = 2.0f;
+    darray_parallel_for(values, 0, parallel_test_scale, &scale);
+    for (u32 i = 0; i < 1000; ++i) {
+        expect_float_to_be(i * 2.0f, values[i]);
+    }
+
+    darray_destroy(values);
+    test_job_system_end();
+    return true;
+}
+
+u8 parallel_reduce_should_match_across_thread_counts() {
+    f32* values = vallocate(sizeof(f32) * PARALLEL_TEST_COUNT, MEMORY_TAG_ARRAY);
+    for (u32 i = 0; i < PARALLEL_TEST_COUNT; ++i) {
+        values[i] = 1.0f / (f32)(i + 1);
+    }
+    f32 identity = 0;
+
+    // No job system: chunks run serially, in order.
+    f32 serial_sum;
+    parallel_reduce(PARALLEL_TEST_COUNT, 1000, sizeof(f32), &identity, parallel_test_sum_range, parallel_test_combine_sum, values, &serial_sum);
+
+    test_job_system_begin(PARALLEL_TEST_WORKER_COUNT);
+    f32 parallel_sum;
+    parallel_reduce(PARALLEL_TEST_COUNT, 1000, sizeof(f32), &identity, parallel_test_sum_range, parallel_test_combine_sum, values, &parallel_sum);
+    test_job_system_end();
+
+    // Same chunks, combined in the same order: bit-identical.
+    b8 identical = serial_sum == parallel_sum;
+    expect_to_be_true(identical);
+    expect_float_to_be(12.0901f, serial_sum);
+
+    vfree(values, sizeof(f32) * PARALLEL_TEST_COUNT, MEMORY_TAG_ARRAY);
+    return true;
+}
+
+void parallel_register_tests() {
+    test_manager_register_test(parallel_for_should_visit_every_index_once, "Parallel for should visit every index once");
+    test_manager_register_test(darray_parallel_for_should_visit_every_element, "Darray parallel for should visit every element");
+    test_manager_register_test(parallel_reduce_should_match_across_thread_counts, "Parallel reduce should match across thread counts");
+}
@@ -0,0 +1,197 @@
+#include "profiler_tests.h"
+#include "../test_manager.h"
+#include "../expect.h"
+#include "../test_systems.h"
+
+#include <defines.h>
+
+#include <core/profiler.h>
+#include <core/vmemory.h>
+#include <core/vstring.h>
+#include <platform/filesystem.h>
+#include <platform/vthread.h>
+
+#include <stdio.h>
+
+#if PROFILER_ENABLED
+
+static const profiler_zone_stats* profiler_test_find(const char* name, u32 thread_index) {
+    u32 count;
+    const profiler_zone_stats* zones = profiler_frame_zones(&count);
+    for (u32 i = 0; i < count; ++i) {
+        if (zones[i].thread_index == thread_index && strings_equal(zones[i].name, name)) {
+            return &zones[i];
+        }
+    }
+    return 0;
+}
+
+static void profiler_test_child() {
+    PROFILE_SCOPE("child");
+}
+
+static u32 profiler_test_thread(void* params) {
+    profiler_set_thread_name("profiler_test");
+    PROFILE_SCOPE("thread_zone");
+    profiler_test_child();
+    return 0;
+}
+
+u8 profiler_should_build_zone_tree() {
+    test_profiler_begin();
+
+    {
+        PROFILE_SCOPE("parent");
+        profiler_test_child();
+        profiler_test_child();
+    }
+    profiler_frame_end();
+
+    u32 count;
+    profiler_frame_zones(&count);
+    expect_should_be(2, count);
+    const profiler_zone_stats* parent = profiler_test_find("parent", 0);
+    const profiler_zone_stats* child = profiler_test_find("child", 0);
+    b8 found = parent && child;
+    expect_to_be_true(found);
+    expect_should_be(1, parent->call_count);
+    expect_should_be(INVALID_ID, parent->parent);
+    expect_should_be(0, parent->depth);
+    // Both calls merge into one zone.
+    expect_should_be(2, child->call_count);
+    expect_should_be(0, child->parent);
+    expect_should_be(1, child->depth);
+    b8 self_within_total = parent->self_ms <= parent->total_ms;
+    expect_to_be_true(self_within_total);
+
+    // The next frame starts empty.
+    profiler_frame_end();
+    profiler_frame_zones(&count);
+    expect_should_be(0, count);
+
+    test_profiler_end();
+    return true;
+}
+
+u8 profiler_should_count_zone_in_frame_it_ends() {
+    test_profiler_begin();
+
+    PROFILE_BEGIN("long");
+    profiler_test_child();
+    profiler_frame_end();
+    // The child ended, so it is counted; its still open parent is created without calls.
+    const profiler_zone_stats* zone = profiler_test_find("long", 0);
+    b8 found = zone != 0;
+    expect_to_be_true(found);
+    expect_should_be(0, zone->call_count);
+    zone = profiler_test_find("child", 0);
+    found = zone != 0;
+    expect_to_be_true(found);
+    expect_should_be(1, zone->call_count);
+
+    PROFILE_END();
+    profiler_frame_end();
+    zone = profiler_test_find("long", 0);
+    found = zone != 0;
+    expect_to_be_true(found);
+    expect_should_be(1, zone->call_count);
+    found = profiler_test_find("child", 0) != 0;
+    expect_to_be_false(found);
+
+    test_profiler_end();
+    return true;
+}
+
+u8 profiler_should_keep_threads_apart() {
+    test_profiler_begin();
+
+    vthread thread;
+    expect_to_be_true(vthread_create("profiler_test", profiler_test_thread, 0, &thread));
+    vthread_join(&thread, 0);
+    {
+        PROFILE_SCOPE("main_zone");
+    }
+    profiler_frame_end();
+
+    b8 found = profiler_test_find("main_zone", 0) && profiler_test_find("thread_zone", 1);
+    expect_to_be_true(found);
+    const profiler_zone_stats* zone = profiler_test_find("child", 1);
+    found = zone != 0;
+    expect_to_be_true(found);
+    expect_should_be(1, zone->depth);
+
+    test_profiler_end();
+    return true;
+}
+
+u8 profiler_should_export_chrome_trace() {
+    test_profiler_begin();
+
+    {
+        PROFILE_SCOPE("parent");
+        profiler_test_child();
+    }
+    const char* path = "profiler_test_trace.json";
+    expect_to_be_true(profiler_export_chrome_trace(path));
+
+    file_handle file;
+    expect_to_be_true(filesystem_open(path, FILE_MODE_READ, false, &file));
+    u8* bytes = 0;
+    u64 size = 0;
+    expect_to_be_true(filesystem_read_all_bytes(&file, &bytes, &size));
+    filesystem_close(&file);
+
+    // Count the begin and end events.
+    u32 begins = 0;
+    u32 ends = 0;
+    for (u64 i = 0; i + 8 <= size; ++i) {
+        if (bytes[i] == '"' && bytes[i + 1] == 'p' && bytes[i + 2] == 'h' && bytes[i + 5] == '"') {
+            begins += bytes[i + 6] == 'B';
+            ends += bytes[i + 6] == 'E';
+        }
+    }
+    expect_should_be(2, begins);
+    expect_should_be(2, ends);
+    expect_should_be('{', bytes[0]);
+    vfree(bytes, size, MEMORY_TAG_STRING);
+    remove(path);
+
+    test_profiler_end();
+    return true;
+}
+
+u8 profiler_should_report_gpu_zones_with_next_frame() {
+    test_profiler_begin();
+
+    profiler_record_gpu_zone("main_renderpass", 0, 2.5);
+    profiler_record_gpu_zone("objects", 1, 1.5);
+    u32 count;
+    profiler_frame_gpu_zones(&count);
+    expect_should_be(0, count);
+
+    profiler_frame_end();
+    const profiler_gpu_zone* zones = profiler_frame_gpu_zones(&count);
+    expect_should_be(2, count);
+    expect_to_be_true(strings_equal("main_renderpass", zones[0].name));
+    expect_should_be(1, zones[1].depth);
+    expect_float_to_be(1.5f, (f32)zones[1].milliseconds);
+
+    profiler_frame_end();
+    profiler_frame_gpu_zones(&count);
+    expect_should_be(0, count);
+
+    test_profiler_end();
+    return true;
+}
+
+#endif
+
+void profiler_register_tests() {
+#if PROFILER_ENABLED
+    test_manager_register_test(profiler_should_build_zone_tree, "Profiler should build zone tree");
+    test_manager_register_test(profiler_should_count_zone_in_frame_it_ends, "Profiler should count zone in frame it ends");
+    test_manager_register_test(profiler_should_keep_threads_apart, "Profiler should keep threads apart");
+    test_manager_register_test(profiler_should_export_chrome_trace, "Profiler should export Chrome trace");
+    test_manager_register_test(profiler_should_report_gpu_zones_with_next_frame, "Profiler should report GPU zones with next frame");
+#endif
+}
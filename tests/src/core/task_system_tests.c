@@ -0,0 +1,143 @@
+#include "task_system_tests.h"
+#include "../test_manager.h"
+#include "../expect.h"
+#include "../test_systems.h"
+
+#include <defines.h>
+
+#include <core/job_system.h>
+#include <core/task_system.h>
+#include <core/vmemory.h>
+#include <platform/vatomic.h>
+
+#define TASK_TEST_WORKER_COUNT 3
+#define TASK_TEST_MAX_FIBERS 64
+#define TASK_TEST_TASK_COUNT 2000
+
+static void task_test_begin() {
+    test_job_system_begin(TASK_TEST_WORKER_COUNT);
+    test_task_system_begin(TASK_TEST_MAX_FIBERS);
+}
+
+static void task_test_end() {
+    test_job_system_end();
+    test_task_system_end();
+}
+
+typedef struct task_test_gate {
+    volatile u32 open;
+    volatile u32 arrived;
+    volatile u32 passed;
+} task_test_gate;
+
+static b8 task_test_gate_is_open(void* data) {
+    return vatomic_load_u32(&((task_test_gate*)data)->open, VMEMORY_ORDER_ACQUIRE) != 0;
+}
+
+static void task_test_wait_at_gate(void* params) {
+    task_test_gate* gate = params;
+    vatomic_fetch_add_u32(&gate->arrived, 1, VMEMORY_ORDER_RELAXED);
+    task_wait_until(task_test_gate_is_open, gate);
+    vatomic_fetch_add_u32(&gate->passed, 1, VMEMORY_ORDER_RELAXED);
+}
+
+static void task_test_increment(void* params) {
+    vatomic_fetch_add_u32((u32*)params, 1, VMEMORY_ORDER_RELAXED);
+}
+
+typedef struct task_test_parent {
+    u32 child_count;
+    u32 seen_child_count;
+} task_test_parent;
+
+static void task_test_spawn_jobs(void* params) {
+    task_test_parent* parent = params;
+    job_desc children[16];
+    for (u32 i = 0; i < 16; ++i) {
+        children[i].entry = task_test_increment;
+        children[i].params = &parent->child_count;
+        children[i].priority = JOB_PRIORITY_NORMAL;
+    }
+    job_counter counter = {};
+    job_submit(children, 16, &counter);
+    task_wait_counter(&counter);
+    parent->seen_child_count = vatomic_load_u32(&parent->child_count, VMEMORY_ORDER_ACQUIRE);
+}
+
+static void task_test_yield_repeatedly(void* params) {
+    for (u32 i = 0; i < 10; ++i) {
+        task_test_increment(params);
+        task_yield();
+    }
+}
+
+u8 task_system_should_run_more_tasks_than_fibers() {
+    task_test_begin();
+
+    task_test_gate gate = {};
+    job_counter counter = {};
+    for (u32 i = 0; i < TASK_TEST_TASK_COUNT; ++i) {
+        b8 spawned = task_spawn(task_test_wait_at_gate, &gate, JOB_PRIORITY_NORMAL, &counter);
+        expect_to_be_true(spawned);
+    }
+
+    // Every fiber ends up parked at the gate, without tying up a thread.
+    while (vatomic_load_u32(&gate.arrived, VMEMORY_ORDER_ACQUIRE) < TASK_TEST_MAX_FIBERS) {
+        job_run_one();
+    }
+    u32 count = 0;
+    job_counter job_count = {};
+    job_desc job = {task_test_increment, &count, JOB_PRIORITY_NORMAL};
+    job_submit(&job, 1, &job_count);
+    job_wait(&job_count);
+    expect_should_be(1, count);
+    expect_should_be(0, gate.passed);
+
+    vatomic_store_u32(&gate.open, 1, VMEMORY_ORDER_RELEASE);
+    task_wait_counter(&counter);
+    expect_should_be(TASK_TEST_TASK_COUNT, gate.arrived);
+    expect_should_be(TASK_TEST_TASK_COUNT, gate.passed);
+
+    task_test_end();
+    return true;
+}
+
+u8 task_wait_counter_should_wait_for_jobs() {
+    task_test_begin();
+
+    task_test_parent parents[32] = {};
+    job_counter counter = {};
+    for (u32 i = 0; i < 32; ++i) {
+        task_spawn(task_test_spawn_jobs, &parents[i], JOB_PRIORITY_NORMAL, &counter);
+    }
+    task_wait_counter(&counter);
+    for (u32 i = 0; i < 32; ++i) {
+        expect_should_be(16, parents[i].seen_child_count);
+    }
+
+    task_test_end();
+    return true;
+}
+
+u8 task_yield_should_resume_task() {
+    task_test_begin();
+
+    u32 count = 0;
+    job_counter counter = {};
+    for (u32 i = 0; i < 8; ++i) {
+        task_spawn(task_test_yield_repeatedly, &count, JOB_PRIORITY_NORMAL, &counter);
+    }
+    task_wait_counter(&counter);
+    expect_should_be(80, count);
+    b8 running = task_is_running();
+    expect_to_be_false(running);
+
+    task_test_end();
+    return true;
+}
+
+void task_system_register_tests() {
+    test_manager_register_test(task_system_should_run_more_tasks_than_fibers, "Task system should run more tasks than fibers");
+    test_manager_register_test(task_wait_counter_should_wait_for_jobs, "Task wait counter should wait for jobs");
+    test_manager_register_test(task_yield_should_resume_task, "Task yield should resume task");
+}
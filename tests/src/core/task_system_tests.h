@@ -0,0 +1,3 @@
+#pragma once
+
+void task_system_register_tests();
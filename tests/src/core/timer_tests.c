@@ -0,0 +1,127 @@
+#include "timer_tests.h"
+#include "../test_manager.h"
+#include "../expect.h"
+#include "../test_systems.h"
+
+#include <defines.h>
+
+#include <core/event.h>
+#include <core/timer.h>
+#include <core/vmemory.h>
+
+#define TEST_TIMER_CODE 0x200
+
+static u32 timer_fired_count;
+static u32 timer_last_value;
+
+static b8 timer_test_on_expired(u16 code, void* sender, void* listener, event_context context) {
+    timer_fired_count++;
+    timer_last_value = context.data.u32[0];
+    return false;
+}
+
+static void timer_test_begin() {
+    test_event_system_begin();
+    test_timer_system_begin();
+
+    event_register(TEST_TIMER_CODE, 0, timer_test_on_expired);
+    timer_fired_count = 0;
+    timer_last_value = 0;
+}
+
+static void timer_test_end() {
+    test_timer_system_end();
+    test_event_system_end();
+}
+
+static void timer_test_advance(f64 time) {
+    timer_system_update(time);
+    event_dispatch_pending();
+}
+
+u8 timer_one_shot_should_fire_once_after_delay() {
+    timer_test_begin();
+    event_context context = {};
+    context.data.u32[0] = 9;
+    timer_handle handle = timer_schedule(0.25, 0, TEST_TIMER_CODE, 0, context);
+    expect_should_not_be(INVALID_TIMER_HANDLE, handle);
+    expect_should_be(1, timer_active_count());
+
+    timer_test_advance(0.249);
+    expect_should_be(0, timer_fired_count);
+
+    timer_test_advance(0.251);
+    expect_should_be(1, timer_fired_count);
+    expect_should_be(9, timer_last_value);
+    expect_should_be(0, timer_active_count());
+
+    timer_test_advance(1.0);
+    expect_should_be(1, timer_fired_count);
+
+    // Expired one-shot handles are stale.
+    expect_to_be_false(timer_cancel(handle));
+
+    timer_test_end();
+    return true;
+}
+
+u8 timer_periodic_should_fire_every_period() {
+    timer_test_begin();
+    event_context context = {};
+    timer_handle handle = timer_schedule(2.0, 2.0, TEST_TIMER_CODE, 0, context);
+
+    // Crosses several level-0 laps, exercising the cascade from level 1.
+    for (u32 frame = 1; frame <= 60 * 7; ++frame) {
+        timer_test_advance(frame / 60.0);
+    }
+    expect_should_be(3, timer_fired_count);
+
+    expect_to_be_true(timer_cancel(handle));
+    timer_test_advance(20.0);
+    expect_should_be(3, timer_fired_count);
+
+    timer_test_end();
+    return true;
+}
+
+u8 timer_cancel_should_prevent_expiry() {
+    timer_test_begin();
+    event_context context = {};
+    timer_handle handles[100];
+    for (u32 i = 0; i < 100; ++i) {
+        handles[i] = timer_schedule(0.01 * (i + 1), 0, TEST_TIMER_CODE, 0, context);
+    }
+    for (u32 i = 0; i < 100; i += 2) {
+        expect_to_be_true(timer_cancel(handles[i]));
+    }
+    expect_should_be(50, timer_active_count());
+
+    timer_test_advance(5.0);
+    expect_should_be(50, timer_fired_count);
+
+    timer_test_end();
+    return true;
+}
+
+u8 timer_long_delay_should_cascade_from_high_levels() {
+    timer_test_begin();
+    event_context context = {};
+    // ~18.6 hours, lands in the top level of the wheel.
+    f64 delay = 67000.0;
+    timer_schedule(delay, 0, TEST_TIMER_CODE, 0, context);
+
+    timer_test_advance(delay - 0.5);
+    expect_should_be(0, timer_fired_count);
+    timer_test_advance(delay + 0.002);
+    expect_should_be(1, timer_fired_count);
+
+    timer_test_end();
+    return true;
+}
+
+void timer_register_tests() {
+    test_manager_register_test(timer_one_shot_should_fire_once_after_delay, "Timer one-shot should fire once after delay");
+    test_manager_register_test(timer_periodic_should_fire_every_period, "Timer periodic should fire every period");
+    test_manager_register_test(timer_cancel_should_prevent_expiry, "Timer cancel should prevent expiry");
+    test_manager_register_test(timer_long_delay_should_cascade_from_high_levels, "Timer long delay should cascade from high levels");
+}
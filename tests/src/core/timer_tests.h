@@ -0,0 +1,3 @@
+#pragma once
+
+void timer_register_tests();
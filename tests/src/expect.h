@@ -1,3 +1,4 @@
+#include <core/clock.h>
 #include <core/logger.h>
 #include <math/vmath.h>
 
@@ -44,4 +45,38 @@
     if (actual != false) {                                                             \
         ERROR("--> Expected false, but got: true. File: %s:%d.", __FILE__, __LINE__);  \
         return false;                                                                  \
-    }
\ No newline at end of file
+    }
+
+/**
+ * @brief Runs statement once and expects it to take no more than max_ms milliseconds.
+ */
+#define expect_time_below(max_ms, statement)                                                                   \
+    {                                                                                                          \
+        clock expect_clock;                                                                                    \
+        clock_start(&expect_clock);                                                                            \
+        statement;                                                                                             \
+        clock_update(&expect_clock);                                                                           \
+        f64 expect_ms = expect_clock.elapsed * 1000.0;                                                         \
+        if (expect_ms > (max_ms)) {                                                                            \
+            ERROR("--> Expected at most %.3fms, but took: %.3fms. File: %s:%d.", (f64)(max_ms), expect_ms, __FILE__, __LINE__); \
+            return false;                                                                                      \
+        }                                                                                                      \
+    }
+
+/**
+ * @brief Runs statement iterations times and expects it to average no more than max_ns nanoseconds a run.
+ */
+#define expect_time_per_op_below(max_ns, iterations, statement)                                                \
+    {                                                                                                          \
+        clock expect_clock;                                                                                    \
+        clock_start(&expect_clock);                                                                            \
+        for (u64 expect_i = 0; expect_i < (iterations); ++expect_i) {                                          \
+            statement;                                                                                         \
+        }                                                                                                      \
+        clock_update(&expect_clock);                                                                           \
+        f64 expect_ns = expect_clock.elapsed * 1000000000.0 / (f64)(iterations);                               \
+        if (expect_ns > (max_ns)) {                                                                            \
+            ERROR("--> Expected at most %.1fns per op, but took: %.1fns. File: %s:%d.", (f64)(max_ns), expect_ns, __FILE__, __LINE__); \
+            return false;                                                                                      \
+        }                                                                                                      \
+    }
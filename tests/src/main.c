@@ -1,12 +1,30 @@
 #include "test_manager.h"
 
 #include "memory/linear_allocator_tests.h"
+#include "core/event_tests.h"
+#include "core/timer_tests.h"
+#include "core/input_tests.h"
+#include "core/job_system_tests.h"
+#include "core/parallel_tests.h"
+#include "core/task_system_tests.h"
+#include "core/profiler_tests.h"
+#include "core/frame_stats_tests.h"
+#include "platform/vthread_tests.h"
 #include <core/logger.h>
 
 int main() {
     test_manager_init();
 
     linear_allocator_register_tests();
+    event_register_tests();
+    timer_register_tests();
+    input_register_tests();
+    job_system_register_tests();
+    parallel_register_tests();
+    task_system_register_tests();
+    profiler_register_tests();
+    frame_stats_register_tests();
+    vthread_register_tests();
 
     DEBUG("=> Starting tests...");
 
@@ -92,10 +92,46 @@ u8 linear_allocator_multi_allocation_all_space_then_free() {
     return true;
 }
 
+u8 linear_allocator_fill_and_free_all_timed() {
+    u64 max_allocs = 1024;
+    linear_allocator alloc;
+    linear_allocator_create(sizeof(u64) * max_allocs, 0, &alloc);
+
+    for (u32 round = 0; round < 64; ++round) {
+        for (u64 i = 0; i < max_allocs; ++i) {
+            u64* block = linear_allocator_allocate(&alloc, sizeof(u64));
+            *block = i;
+        }
+        expect_should_be(sizeof(u64) * max_allocs, alloc.allocated);
+        linear_allocator_free_all(&alloc);
+    }
+
+    linear_allocator_destroy(&alloc);
+    return true;
+}
+
+u8 linear_allocator_allocation_time_per_op() {
+    u64 max_allocs = 65536;
+    linear_allocator alloc;
+    linear_allocator_create(sizeof(u64) * max_allocs, 0, &alloc);
+
+    // Generous, so only a pathological slowdown fails; the timed test above tracks the baseline.
+    expect_time_per_op_below(500.0, max_allocs, linear_allocator_allocate(&alloc, sizeof(u64)));
+    expect_should_be(sizeof(u64) * max_allocs, alloc.allocated);
+
+    expect_time_below(10.0, linear_allocator_free_all(&alloc));
+    expect_should_be(0, alloc.allocated);
+
+    linear_allocator_destroy(&alloc);
+    return true;
+}
+
 void linear_allocator_register_tests() {
     test_manager_register_test(linear_allocator_should_create_and_destroy, "Linear allocator should create and destroy");
     test_manager_register_test(linear_allocator_single_allocation_all_space, "Linear allocator single alloc for all space");
     test_manager_register_test(linear_allocator_multi_allocation_all_space, "Linear allocator multi alloc for all space");
     test_manager_register_test(linear_allocator_multi_allocation_over_allocate, "Linear allocator try over allocate");
     test_manager_register_test(linear_allocator_multi_allocation_all_space_then_free, "Linear allocator allocated should be 0 after free_all");
+    test_manager_register_test(linear_allocator_allocation_time_per_op, "Linear allocator allocation should be fast per op");
+    test_manager_register_bench(linear_allocator_fill_and_free_all_timed, "Linear allocator fill and free_all timed", 31, 20.0);
 }
\ No newline at end of file
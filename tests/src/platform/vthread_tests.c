@@ -0,0 +1,124 @@
+#include "vthread_tests.h"
+#include "../test_manager.h"
+#include "../expect.h"
+
+#include <defines.h>
+
+#include <platform/vthread.h>
+#include <platform/vatomic.h>
+
+#define VTHREAD_TEST_THREAD_COUNT 4
+#define VTHREAD_TEST_ITERATIONS 100000
+
+typedef struct vthread_test_shared {
+    vmutex mutex;
+    vspinlock spinlock;
+    vsemaphore semaphore;
+    u64 mutex_counter;
+    u64 spinlock_counter;
+    u64 atomic_counter;
+} vthread_test_shared;
+
+static u32 vthread_test_return_value(void* params) {
+    return *(u32*)params;
+}
+
+static u32 vthread_test_increment(void* params) {
+    vthread_test_shared* shared = params;
+    for (u32 i = 0; i < VTHREAD_TEST_ITERATIONS; ++i) {
+        vmutex_lock(&shared->mutex);
+        shared->mutex_counter++;
+        vmutex_unlock(&shared->mutex);
+
+        vspinlock_lock(&shared->spinlock);
+        shared->spinlock_counter++;
+        vspinlock_unlock(&shared->spinlock);
+
+        vatomic_fetch_add_u64(&shared->atomic_counter, 1, VMEMORY_ORDER_RELAXED);
+    }
+    return 0;
+}
+
+static u32 vthread_test_wait_semaphore(void* params) {
+    vthread_test_shared* shared = params;
+    vsemaphore_wait(&shared->semaphore);
+    vatomic_fetch_add_u64(&shared->atomic_counter, 1, VMEMORY_ORDER_RELAXED);
+    return 0;
+}
+
+u8 vthread_join_should_return_exit_code() {
+    u32 value = 42;
+    vthread thread;
+    expect_to_be_true(vthread_create("test", vthread_test_return_value, &value, &thread));
+    u32 exit_code = 0;
+    expect_to_be_true(vthread_join(&thread, &exit_code));
+    expect_should_be(42, exit_code);
+    expect_should_be(0, thread.internal_data);
+    return true;
+}
+
+u8 vthread_locks_should_serialize_increments() {
+    vthread_test_shared shared = {};
+    expect_to_be_true(vmutex_create(&shared.mutex));
+
+    vthread threads[VTHREAD_TEST_THREAD_COUNT];
+    for (u32 i = 0; i < VTHREAD_TEST_THREAD_COUNT; ++i) {
+        expect_to_be_true(vthread_create("test_increment", vthread_test_increment, &shared, &threads[i]));
+    }
+    for (u32 i = 0; i < VTHREAD_TEST_THREAD_COUNT; ++i) {
+        vthread_join(&threads[i], 0);
+    }
+
+    u64 expected = VTHREAD_TEST_THREAD_COUNT * VTHREAD_TEST_ITERATIONS;
+    expect_should_be(expected, shared.mutex_counter);
+    expect_should_be(expected, shared.spinlock_counter);
+    expect_should_be(expected, vatomic_load_u64(&shared.atomic_counter, VMEMORY_ORDER_SEQ_CST));
+
+    vmutex_destroy(&shared.mutex);
+    return true;
+}
+
+u8 vsemaphore_should_release_waiters() {
+    vthread_test_shared shared = {};
+    expect_to_be_true(vsemaphore_create(0, &shared.semaphore));
+    expect_to_be_false(vsemaphore_try_wait(&shared.semaphore));
+
+    vthread threads[VTHREAD_TEST_THREAD_COUNT];
+    for (u32 i = 0; i < VTHREAD_TEST_THREAD_COUNT; ++i) {
+        expect_to_be_true(vthread_create("test_wait", vthread_test_wait_semaphore, &shared, &threads[i]));
+    }
+    vsemaphore_signal(&shared.semaphore, VTHREAD_TEST_THREAD_COUNT + 1);
+    for (u32 i = 0; i < VTHREAD_TEST_THREAD_COUNT; ++i) {
+        vthread_join(&threads[i], 0);
+    }
+    expect_should_be(VTHREAD_TEST_THREAD_COUNT, vatomic_load_u64(&shared.atomic_counter, VMEMORY_ORDER_SEQ_CST));
+    // One count is left over.
+    expect_to_be_true(vsemaphore_try_wait(&shared.semaphore));
+    expect_to_be_false(vsemaphore_try_wait(&shared.semaphore));
+
+    vsemaphore_destroy(&shared.semaphore);
+    return true;
+}
+
+u8 vatomic_compare_exchange_should_report_current_value() {
+    u32 value = 5;
+    u32 expected = 4;
+    b8 result = vatomic_compare_exchange_u32(&value, &expected, 9, false, VMEMORY_ORDER_SEQ_CST, VMEMORY_ORDER_SEQ_CST);
+    expect_to_be_false(result);
+    expect_should_be(5, expected);
+    result = vatomic_compare_exchange_u32(&value, &expected, 9, false, VMEMORY_ORDER_SEQ_CST, VMEMORY_ORDER_SEQ_CST);
+    expect_to_be_true(result);
+    expect_should_be(9, value);
+    expect_should_be(9, vatomic_exchange_u32(&value, 1, VMEMORY_ORDER_SEQ_CST));
+    expect_should_be(1, vatomic_fetch_or_u32(&value, 6, VMEMORY_ORDER_SEQ_CST));
+    expect_should_be(7, vatomic_fetch_sub_u32(&value, 2, VMEMORY_ORDER_SEQ_CST));
+    expect_should_be(5, value);
+    return true;
+}
+
+void vthread_register_tests() {
+    test_manager_register_test(vthread_join_should_return_exit_code, "Thread join should return exit code");
+    test_manager_register_test(vthread_locks_should_serialize_increments, "Mutex, spinlock and atomics should serialize increments");
+    test_manager_register_test(vsemaphore_should_release_waiters, "Semaphore should release waiters");
+    test_manager_register_test(vatomic_compare_exchange_should_report_current_value, "Atomic compare-exchange should report current value");
+}
@@ -0,0 +1,3 @@
+#pragma once
+
+void vthread_register_tests();
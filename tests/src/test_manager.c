@@ -1,16 +1,32 @@
 #include "test_manager.h"
+#include "test_systems.h"
 
 #include <containers/darray.h>
 #include <core/logger.h>
+#include <core/vmemory.h>
 #include <core/vstring.h>
 #include <core/clock.h>
+#include <platform/filesystem.h>
+
+#include <math.h>
+#include <stdlib.h>
 
 typedef struct test_entry {
     PFN_test func;
     char* desc;
+    // 0 for a test run once, untimed.
+    u32 repeat_count;
+    f64 budget_ms;
 } test_entry;
 
+typedef struct test_baseline {
+    char* desc;
+    f64 median_ms;
+} test_baseline;
+
 static test_entry* tests;
+static test_baseline* baselines;
+static b8 baselines_changed;
 
 void test_manager_init() {
     tests = darray_create(test_entry);
@@ -20,15 +36,185 @@ void test_manager_register_test(u8 (*PFN_test)(), char* desc) {
     test_entry e;
     e.func = PFN_test;
     e.desc = desc;
+    e.repeat_count = 0;
+    e.budget_ms = 0;
     darray_push(tests, e);
 }
 
+void test_manager_register_bench(u8 (*PFN_test)(), char* desc, u32 repeat_count, f64 budget_ms) {
+    test_entry e;
+    e.func = PFN_test;
+    e.desc = desc;
+    e.repeat_count = repeat_count == 0 ? 1 : repeat_count > TEST_BENCH_MAX_REPEATS ? TEST_BENCH_MAX_REPEATS : repeat_count;
+    e.budget_ms = budget_ms;
+    darray_push(tests, e);
+}
+
+/**
+ * Loads the baselines, one per line as "<median_ms> <desc>".
+ */
+static void load_baselines() {
+    baselines = darray_create(test_baseline);
+    baselines_changed = false;
+    file_handle file;
+    if (!filesystem_exists(TEST_BENCH_BASELINE_PATH) || !filesystem_open(TEST_BENCH_BASELINE_PATH, FILE_MODE_READ, false, &file)) {
+        return;
+    }
+    char* line = 0;
+    while (filesystem_read_line(&file, &line)) {
+        u64 length = string_length(line);
+        char* end = 0;
+        f64 median_ms = strtod(line, &end);
+        if (end != line && *end == ' ') {
+            // Without the separator and the trailing newline.
+            u64 desc_length = length - (u64)(end + 1 - line);
+            while (desc_length > 0 && (end[desc_length] == '\n' || end[desc_length] == '\r')) {
+                desc_length--;
+            }
+            test_baseline baseline;
+            baseline.desc = vallocate(desc_length + 1, MEMORY_TAG_STRING);
+            vcopy_memory(baseline.desc, end + 1, desc_length);
+            baseline.median_ms = median_ms;
+            darray_push(baselines, baseline);
+        }
+        vfree(line, length + 1, MEMORY_TAG_STRING);
+        line = 0;
+    }
+    filesystem_close(&file);
+}
+
+static void free_baselines() {
+    u32 count = darray_length(baselines);
+    for (u32 i = 0; i < count; ++i) {
+        vfree(baselines[i].desc, string_length(baselines[i].desc) + 1, MEMORY_TAG_STRING);
+    }
+    darray_destroy(baselines);
+    baselines = 0;
+}
+
+static const test_baseline* find_baseline(const char* desc) {
+    u32 count = darray_length(baselines);
+    for (u32 i = 0; i < count; ++i) {
+        if (strings_equal(baselines[i].desc, desc)) {
+            return &baselines[i];
+        }
+    }
+    return 0;
+}
+
+static void record_baseline(const char* desc, f64 median_ms) {
+    test_baseline baseline;
+    u64 length = string_length(desc);
+    baseline.desc = vallocate(length + 1, MEMORY_TAG_STRING);
+    vcopy_memory(baseline.desc, desc, length);
+    baseline.median_ms = median_ms;
+    darray_push(baselines, baseline);
+    baselines_changed = true;
+    INFO("  Recorded baseline %.3fms.", median_ms);
+}
+
+/**
+ * Rewrites the baseline file with the loaded and newly recorded baselines.
+ */
+static void save_baselines() {
+    file_handle file;
+    if (!filesystem_open(TEST_BENCH_BASELINE_PATH, FILE_MODE_WRITE, false, &file)) {
+        WARN("Unable to write baselines to '%s'.", TEST_BENCH_BASELINE_PATH);
+        return;
+    }
+    char line[512];
+    u32 count = darray_length(baselines);
+    for (u32 i = 0; i < count; ++i) {
+        string_format(line, "%.6f %s", baselines[i].median_ms, baselines[i].desc);
+        filesystem_write_line(&file, line);
+    }
+    filesystem_close(&file);
+}
+
+static void sort_times(f64* times, u32 count) {
+    for (u32 i = 1; i < count; ++i) {
+        f64 time = times[i];
+        u32 j = i;
+        while (j > 0 && times[j - 1] > time) {
+            times[j] = times[j - 1];
+            --j;
+        }
+        times[j] = time;
+    }
+}
+
+/**
+ * Runs a timed test repeatedly and checks its median against the budget and baseline.
+ */
+static u8 run_bench(const test_entry* entry) {
+    // Warms caches and takes first-use allocations out of the timings.
+    u8 result = entry->func();
+    test_systems_end_all();
+    if (result != true) {
+        return result;
+    }
+
+    f64 times[TEST_BENCH_MAX_REPEATS];
+    u32 count = entry->repeat_count;
+    for (u32 r = 0; r < count; ++r) {
+        clock run_time;
+        clock_start(&run_time);
+        result = entry->func();
+        clock_update(&run_time);
+        test_systems_end_all();
+        if (result != true) {
+            return result;
+        }
+        times[r] = run_time.elapsed * 1000.0;
+    }
+
+    f64 sum = 0;
+    b8 clock_advanced = false;
+    for (u32 r = 0; r < count; ++r) {
+        clock_advanced = clock_advanced || times[r] > 0;
+        sum += times[r];
+    }
+    if (!clock_advanced) {
+        // Without a working clock every budget and baseline check would pass.
+        ERROR("--> All %u runs took 0ms; the clock isn't advancing.", count);
+        return false;
+    }
+    f64 mean = sum / count;
+    f64 variance = 0;
+    for (u32 r = 0; r < count; ++r) {
+        variance += (times[r] - mean) * (times[r] - mean);
+    }
+    f64 stddev = sqrt(variance / count);
+    sort_times(times, count);
+    f64 median = count % 2 ? times[count / 2] : (times[count / 2 - 1] + times[count / 2]) * 0.5;
+
+    INFO("  %u runs: min %.3fms, median %.3fms, stddev %.3fms (budget %.3fms)", count, times[0], median, stddev, entry->budget_ms);
+
+    if (median > entry->budget_ms) {
+        ERROR("--> Median %.3fms is over the budget of %.3fms.", median, entry->budget_ms);
+        return false;
+    }
+
+    const test_baseline* baseline = find_baseline(entry->desc);
+    if (!baseline) {
+        record_baseline(entry->desc, median);
+        return true;
+    }
+    f64 limit = baseline->median_ms * (1.0 + TEST_BENCH_REGRESSION_THRESHOLD) + TEST_BENCH_REGRESSION_SLACK_MS;
+    if (median > limit) {
+        ERROR("--> Median %.3fms regressed past the baseline of %.3fms (limit %.3fms).", median, baseline->median_ms, limit);
+        return false;
+    }
+    return true;
+}
+
 void test_manager_run_tests() {
     u32 passed = 0;
     u32 failed = 0;
     u32 skipped = 0;
 
     u32 count = darray_length(tests);
+    load_baselines();
 
     clock total_time;
     clock_start(&total_time);
@@ -36,8 +222,10 @@ void test_manager_run_tests() {
     for (u32 i = 0; i < count; ++i) {
         clock test_time;
         clock_start(&test_time);
-        u8 result = tests[i].func();
+        u8 result = tests[i].repeat_count ? run_bench(&tests[i]) : tests[i].func();
         clock_update(&test_time);
+        // Stops anything a failed test left running before it got to its own end calls.
+        test_systems_end_all();
 
         if (result == true) {
             ++passed;
@@ -55,6 +243,10 @@ void test_manager_run_tests() {
     }
 
     clock_stop(&total_time);
+    if (baselines_changed) {
+        save_baselines();
+    }
+    free_baselines();
 
     INFO("Results: %d passed, %d failed, %d skipped.", passed, failed, skipped);
-}
\ No newline at end of file
+}
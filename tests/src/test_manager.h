@@ -4,10 +4,28 @@
 
 #define BYPASS 2
 
+// Timed runs are compared against, and first recorded in, this file.
+#define TEST_BENCH_BASELINE_PATH "test_bench_baselines.txt"
+// Slowdown of the median over the baseline, as a fraction, beyond which a timed test fails.
+#define TEST_BENCH_REGRESSION_THRESHOLD 0.25
+// Allowed on top of the threshold, so sub-millisecond noise doesn't fail a run.
+#define TEST_BENCH_REGRESSION_SLACK_MS 0.1
+#define TEST_BENCH_MAX_REPEATS 1024
+
 typedef u8 (*PFN_test)();
 
 void test_manager_init();
 
 void test_manager_register_test(PFN_test, char* desc);
 
-void test_manager_run_tests();
\ No newline at end of file
+/**
+ * Registers a timed test. After one untimed warmup run, it runs repeat_count times; every run
+ * must pass. The test fails if the median run takes longer than the budget, or regresses past
+ * its baseline in TEST_BENCH_BASELINE_PATH. A test without a baseline records its median as one.
+ * @param desc The description, also the test's key in the baseline file.
+ * @param repeat_count The number of timed runs, up to TEST_BENCH_MAX_REPEATS.
+ * @param budget_ms The most the median run may take, in milliseconds.
+ */
+void test_manager_register_bench(PFN_test, char* desc, u32 repeat_count, f64 budget_ms);
+
+void test_manager_run_tests();
@@ -0,0 +1,115 @@
+#include "test_systems.h"
+
+#include <core/event.h>
+#include <core/input.h>
+#include <core/job_system.h>
+#include <core/profiler.h>
+#include <core/task_system.h>
+#include <core/timer.h>
+#include <core/vmemory.h>
+
+typedef struct test_system {
+    // 0 while not running.
+    void* state;
+    u64 state_size;
+} test_system;
+
+static test_system event_system;
+static test_system timer_system;
+static test_system input_system;
+static test_system job_system;
+static test_system task_system;
+static test_system profiler;
+
+static void* allocate_state(test_system* system, memory_tag tag) {
+    system->state = vallocate(system->state_size, tag);
+    return system->state;
+}
+
+static void free_state(test_system* system, memory_tag tag) {
+    vfree(system->state, system->state_size, tag);
+    system->state = 0;
+}
+
+void test_event_system_begin() {
+    event_system_initialize(&event_system.state_size, 0);
+    event_system_initialize(&event_system.state_size, allocate_state(&event_system, MEMORY_TAG_APPLICATION));
+}
+
+void test_event_system_end() {
+    if (event_system.state) {
+        event_system_shutdown(event_system.state);
+        free_state(&event_system, MEMORY_TAG_APPLICATION);
+    }
+}
+
+void test_timer_system_begin() {
+    timer_system_initialize(&timer_system.state_size, 0);
+    timer_system_initialize(&timer_system.state_size, allocate_state(&timer_system, MEMORY_TAG_APPLICATION));
+}
+
+void test_timer_system_end() {
+    if (timer_system.state) {
+        timer_system_shutdown(timer_system.state);
+        free_state(&timer_system, MEMORY_TAG_APPLICATION);
+    }
+}
+
+void test_input_system_begin() {
+    input_system_initialize(&input_system.state_size, 0);
+    input_system_initialize(&input_system.state_size, allocate_state(&input_system, MEMORY_TAG_APPLICATION));
+}
+
+void test_input_system_end() {
+    if (input_system.state) {
+        input_system_shutdown(input_system.state);
+        free_state(&input_system, MEMORY_TAG_APPLICATION);
+    }
+}
+
+void test_job_system_begin(u32 worker_count) {
+    job_system_initialize(&job_system.state_size, 0, worker_count);
+    job_system_initialize(&job_system.state_size, allocate_state(&job_system, MEMORY_TAG_JOB), worker_count);
+}
+
+void test_job_system_end() {
+    if (job_system.state) {
+        job_system_shutdown(job_system.state);
+        free_state(&job_system, MEMORY_TAG_JOB);
+    }
+}
+
+void test_task_system_begin(u32 max_fibers) {
+    task_system_initialize(&task_system.state_size, 0, max_fibers, 0);
+    task_system_initialize(&task_system.state_size, allocate_state(&task_system, MEMORY_TAG_JOB), max_fibers, 0);
+}
+
+void test_task_system_end() {
+    if (task_system.state) {
+        task_system_shutdown(task_system.state);
+        free_state(&task_system, MEMORY_TAG_JOB);
+    }
+}
+
+void test_profiler_begin() {
+    profiler_initialize(&profiler.state_size, 0);
+    profiler_initialize(&profiler.state_size, allocate_state(&profiler, MEMORY_TAG_APPLICATION));
+}
+
+void test_profiler_end() {
+    if (profiler.state) {
+        profiler_shutdown(profiler.state);
+        free_state(&profiler, MEMORY_TAG_APPLICATION);
+    }
+}
+
+void test_systems_end_all() {
+    // The application's shutdown order. The job workers stop before the task
+    // system destroys the fibers they may be running.
+    test_input_system_end();
+    test_timer_system_end();
+    test_job_system_end();
+    test_task_system_end();
+    test_profiler_end();
+    test_event_system_end();
+}
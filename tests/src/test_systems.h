@@ -0,0 +1,36 @@
+#pragma once
+
+#include <defines.h>
+
+/*
+ * Start and stop engine systems for a test, with the usual two-call initialize.
+ * A test returning early from a failed expect skips its own end calls, so the
+ * test manager calls test_systems_end_all after every test run; nothing, such as
+ * job workers, keeps running into the next test.
+ */
+
+void test_event_system_begin();
+void test_event_system_end();
+
+/** Requires the event system. */
+void test_timer_system_begin();
+void test_timer_system_end();
+
+/** Requires the event system. */
+void test_input_system_begin();
+void test_input_system_end();
+
+void test_job_system_begin(u32 worker_count);
+void test_job_system_end();
+
+/** Requires the job system. Fibers get the default stack size. */
+void test_task_system_begin(u32 max_fibers);
+void test_task_system_end();
+
+void test_profiler_begin();
+void test_profiler_end();
+
+/**
+ * Ends every system still running, dependents first. Safe to call when none are.
+ */
+void test_systems_end_all();